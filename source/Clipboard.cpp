@@ -59,26 +59,15 @@ static void setData(GtkClipboard *, GtkSelectionData *selectionData, Target targ
 		return;
 	switch (targetType) {
 	case Target::string: {
-		std::stringstream text;
-		std::string textLine;
-		ConverterSerializePosition position(args->colors.size());
-		if (position.count() > 0) {
-			for (auto *color: args->colors) {
-				if (position.index() + 1 == position.count())
-					position.last(true);
-				textLine = args->converter->serialize(*color, position);
-				if (position.first()) {
-					text << textLine;
-					position.first(false);
-				} else {
-					text << "\n" << textLine;
-				}
-				position.incrementIndex();
-			}
+		std::string text;
+		auto lines = args->converter->serialize(std::vector<const ColorObject *>(args->colors.begin(), args->colors.end()));
+		for (size_t i = 0; i < lines.size(); i++) {
+			if (i != 0)
+				text += '\n';
+			text += lines[i];
 		}
-		textLine = text.str();
-		if (textLine.length() > 0)
-			gtk_selection_data_set_text(selectionData, textLine.c_str(), textLine.length());
+		if (text.length() > 0)
+			gtk_selection_data_set_text(selectionData, text.c_str(), text.length());
 	} break;
 	case Target::color: {
 		auto &colorObject = args->colors.front();
@@ -36,6 +36,12 @@ const Color::Matrix3d &Color::sRGBMatrix = sRGBTransformation;
 const Color::Matrix3d &Color::sRGBInvertedMatrix = sRGBTransformationInverted;
 const Color::Matrix3d &Color::d65d50AdaptationMatrix = d65d50AdaptationMatrixValue;
 const Color::Matrix3d &Color::d50d65AdaptationMatrix = d50d65AdaptationMatrixValue;
+// Number of intervals in fast gamma transfer tables. Linear interpolation error with 4096 intervals is below float precision in [0, 1] range.
+const size_t GammaTableSize = 4096;
+static GammaMode gammaModeValue = GammaMode::exact;
+static float byteLinearTable[256];
+static float linearTable[GammaTableSize + 1];
+static float nonLinearTable[GammaTableSize + 1];
 static Color::Vector3f references[][2] = {
 	{ { 109.850f, 100.000f, 35.585f }, { 111.144f, 100.000f, 35.200f } },
 	{ { 98.074f, 100.000f, 118.232f }, { 97.285f, 100.000f, 116.145f } },
@@ -53,6 +59,49 @@ void Color::initialize() {
 	sRGBTransformationInverted = sRGBTransformation.inverse().value();
 	d65d50AdaptationMatrixValue = getChromaticAdaptationMatrix(getReference(ReferenceIlluminant::D65, ReferenceObserver::_2), getReference(ReferenceIlluminant::D50, ReferenceObserver::_2));
 	d50d65AdaptationMatrixValue = getChromaticAdaptationMatrix(getReference(ReferenceIlluminant::D50, ReferenceObserver::_2), getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
+	for (int i = 0; i < 256; i++) {
+		// same expression as 8-bit value conversion to float followed by exact transfer function, so results are identical
+		float value = i / 255.0f;
+		byteLinearTable[i] = value > 0.04045f ? std::pow((value + 0.055f) / 1.055f, 2.4f) : value / 12.92f;
+	}
+	for (size_t i = 0; i <= GammaTableSize; i++) {
+		double value = static_cast<double>(i) / GammaTableSize;
+		linearTable[i] = static_cast<float>(std::pow((value + 0.055) / 1.055, 2.4));
+		// non-linear table is indexed by square root of linear value, which flattens the curve near zero
+		nonLinearTable[i] = static_cast<float>(1.055 * std::pow(value * value, 1.0 / 2.4) - 0.055);
+	}
+}
+void Color::setGammaMode(GammaMode mode) {
+	gammaModeValue = mode;
+}
+GammaMode Color::gammaMode() {
+	return gammaModeValue;
+}
+float Color::linearRgbChannel(uint8_t value) {
+	return byteLinearTable[value];
+}
+static float interpolateGammaTable(const float *table, float position) {
+	size_t index = static_cast<size_t>(position);
+	if (index >= GammaTableSize)
+		index = GammaTableSize - 1;
+	float fraction = position - static_cast<float>(index);
+	return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+static float linearChannel(float value) {
+	if (value > 0.04045f) {
+		if (gammaModeValue == GammaMode::fast && value <= 1.0f)
+			return interpolateGammaTable(linearTable, value * GammaTableSize);
+		return std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+	return value / 12.92f;
+}
+static float nonLinearChannel(float value) {
+	if (value > 0.0031308f) {
+		if (gammaModeValue == GammaMode::fast && value <= 1.0f)
+			return interpolateGammaTable(nonLinearTable, std::sqrt(value) * GammaTableSize);
+		return (1.055f * std::pow(value, 1.0f / 2.4f)) - 0.055f;
+	}
+	return value * 12.92f;
 }
 namespace util {
 template<typename T>
@@ -318,67 +367,21 @@ Color Color::hsvToHsl() const {
 	return Color(hsv.hue, s, l / 2.0f, alpha);
 }
 Color &Color::linearRgbInplace() {
-	if (rgb.red > 0.04045f)
-		rgb.red = std::pow((rgb.red + 0.055f) / 1.055f, 2.4f);
-	else
-		rgb.red = rgb.red / 12.92f;
-	if (rgb.green > 0.04045f)
-		rgb.green = std::pow((rgb.green + 0.055f) / 1.055f, 2.4f);
-	else
-		rgb.green = rgb.green / 12.92f;
-	if (rgb.blue > 0.04045f)
-		rgb.blue = std::pow((rgb.blue + 0.055f) / 1.055f, 2.4f);
-	else
-		rgb.blue = rgb.blue / 12.92f;
+	rgb.red = linearChannel(rgb.red);
+	rgb.green = linearChannel(rgb.green);
+	rgb.blue = linearChannel(rgb.blue);
 	return *this;
 }
 Color Color::linearRgb() const {
-	Color result;
-	if (rgb.red > 0.04045f)
-		result.red = std::pow((rgb.red + 0.055f) / 1.055f, 2.4f);
-	else
-		result.red = rgb.red / 12.92f;
-	if (rgb.green > 0.04045f)
-		result.green = std::pow((rgb.green + 0.055f) / 1.055f, 2.4f);
-	else
-		result.green = rgb.green / 12.92f;
-	if (rgb.blue > 0.04045f)
-		result.blue = std::pow((rgb.blue + 0.055f) / 1.055f, 2.4f);
-	else
-		result.blue = rgb.blue / 12.92f;
-	result.alpha = alpha;
-	return result;
+	return Color(linearChannel(rgb.red), linearChannel(rgb.green), linearChannel(rgb.blue), alpha);
 }
 Color Color::nonLinearRgb() const {
-	Color result;
-	if (rgb.red > 0.0031308f)
-		result.red = (1.055f * std::pow(rgb.red, 1.0f / 2.4f)) - 0.055f;
-	else
-		result.red = rgb.red * 12.92f;
-	if (rgb.green > 0.0031308f)
-		result.green = (1.055f * std::pow(rgb.green, 1.0f / 2.4f)) - 0.055f;
-	else
-		result.green = rgb.green * 12.92f;
-	if (rgb.blue > 0.0031308f)
-		result.blue = (1.055f * std::pow(rgb.blue, 1.0f / 2.4f)) - 0.055f;
-	else
-		result.blue = rgb.blue * 12.92f;
-	result.alpha = alpha;
-	return result;
+	return Color(nonLinearChannel(rgb.red), nonLinearChannel(rgb.green), nonLinearChannel(rgb.blue), alpha);
 }
 Color &Color::nonLinearRgbInplace() {
-	if (rgb.red > 0.0031308f)
-		rgb.red = (1.055f * std::pow(rgb.red, 1.0f / 2.4f)) - 0.055f;
-	else
-		rgb.red = rgb.red * 12.92f;
-	if (rgb.green > 0.0031308f)
-		rgb.green = (1.055f * std::pow(rgb.green, 1.0f / 2.4f)) - 0.055f;
-	else
-		rgb.green = rgb.green * 12.92f;
-	if (rgb.blue > 0.0031308f)
-		rgb.blue = (1.055f * std::pow(rgb.blue, 1.0f / 2.4f)) - 0.055f;
-	else
-		rgb.blue = rgb.blue * 12.92f;
+	rgb.red = nonLinearChannel(rgb.red);
+	rgb.green = nonLinearChannel(rgb.green);
+	rgb.blue = nonLinearChannel(rgb.blue);
 	return *this;
 }
 Color Color::rgbToLch(const Vector3f &referenceWhite, const Matrix3d &transformation, const Matrix3d &adaptationMatrix) const {
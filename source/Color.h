@@ -51,6 +51,14 @@ enum class ReferenceObserver : uint8_t {
 	_10 = 1,
 };
 
+/** \enum GammaMode
+ * \brief sRGB transfer function evaluation modes.
+ */
+enum class GammaMode : uint8_t {
+	exact = 0, /**< Evaluate transfer function using std::pow. */
+	fast = 1, /**< Interpolate transfer function from precomputed tables. */
+};
+
 /** \struct Color
  * \brief Color structure is an union of all available color spaces.
  */
@@ -81,6 +89,25 @@ struct Color {
 	 * Initialize things needed for color conversion functions. Must be called before using any other functions.
 	 */
 	static void initialize();
+	/**
+	 * Select how sRGB transfer function is evaluated by linearRgb and nonLinearRgb functions.
+	 * Fast mode differs from exact mode by at most 3e-7 (a few float ULPs) in both directions, values outside of [0, 1] range are always evaluated exactly.
+	 * Mode is global and should be selected before any conversions are started.
+	 * @param[in] mode Transfer function evaluation mode.
+	 */
+	static void setGammaMode(GammaMode mode);
+	/**
+	 * Get current sRGB transfer function evaluation mode.
+	 * @return Transfer function evaluation mode.
+	 */
+	static GammaMode gammaMode();
+	/**
+	 * Transform 8-bit sRGB channel value to linear channel value using precomputed table.
+	 * Result is identical to exact linearRgb transformation of value / 255.
+	 * @param[in] value 8-bit channel value.
+	 * @return Linear channel value.
+	 */
+	static float linearRgbChannel(uint8_t value);
 	Color();
 	Color(const Color &color);
 	Color(float value);
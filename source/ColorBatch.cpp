@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ColorBatch.h"
+#include "ColorBatchKernels.h"
+#include "Color.h"
+#include <atomic>
+namespace batch {
+namespace {
+Implementation detectImplementation() {
+#ifdef GPICK_COLOR_BATCH_SIMD
+	__builtin_cpu_init();
+	if (detail::avx2Kernels() && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return Implementation::avx2;
+	if (detail::sse2Kernels())
+		return Implementation::sse2;
+#endif
+	return Implementation::scalar;
+}
+std::atomic<Implementation> &currentImplementation() {
+	static std::atomic<Implementation> implementation(bestImplementation());
+	return implementation;
+}
+const detail::Kernels *kernels() {
+	switch (currentImplementation().load(std::memory_order_relaxed)) {
+	case Implementation::avx2:
+		return detail::avx2Kernels();
+	case Implementation::sse2:
+		return detail::sse2Kernels();
+	case Implementation::scalar:
+		break;
+	}
+	return nullptr;
+}
+detail::Constants getConstants() {
+	detail::Constants constants;
+	const auto &referenceWhite = Color::getReference(ReferenceIlluminant::D50, ReferenceObserver::_2);
+	for (int column = 0; column < 3; ++column) {
+		Color::Vector3d rgb(column == 0 ? 1 : 0, column == 1 ? 1 : 0, column == 2 ? 1 : 0);
+		auto xyz = Color::d65d50AdaptationMatrix * (Color::sRGBMatrix * rgb);
+		for (int row = 0; row < 3; ++row)
+			constants.labMatrix[row * 3 + column] = static_cast<float>(xyz.data[row] / referenceWhite.data[row]);
+	}
+	return constants;
+}
+template<typename Convert>
+void convert(const Colors &input, const Colors &output, detail::Kernel detail::Kernels::*kernel, Convert convertColor) {
+	size_t converted = 0;
+	if (auto *currentKernels = kernels())
+		converted = (currentKernels->*kernel)(input, output, getConstants());
+	for (size_t i = converted; i < input.size; ++i) {
+		Color color = convertColor(Color(input.data[0][i], input.data[1][i], input.data[2][i]));
+		output.data[0][i] = color.data[0];
+		output.data[1][i] = color.data[1];
+		output.data[2][i] = color.data[2];
+	}
+}
+}
+Colors::Colors(float *first, float *second, float *third, size_t size):
+	data { first, second, third },
+	size(size) {
+}
+Implementation bestImplementation() {
+	static const Implementation implementation = detectImplementation();
+	return implementation;
+}
+Implementation implementation() {
+	return currentImplementation().load(std::memory_order_relaxed);
+}
+Implementation setImplementation(Implementation implementation) {
+	if (implementation > bestImplementation())
+		implementation = bestImplementation();
+	if (implementation == Implementation::sse2 && !detail::sse2Kernels())
+		implementation = Implementation::scalar;
+	currentImplementation().store(implementation, std::memory_order_relaxed);
+	return implementation;
+}
+void linearRgb(const Colors &input, const Colors &output) {
+	convert(input, output, &detail::Kernels::linearRgb, [](const Color &color) {
+		return color.linearRgb();
+	});
+}
+void rgbToLabD50(const Colors &input, const Colors &output) {
+	convert(input, output, &detail::Kernels::rgbToLabD50, [](const Color &color) {
+		return color.rgbToLabD50();
+	});
+}
+void rgbToLchD50(const Colors &input, const Colors &output) {
+	convert(input, output, &detail::Kernels::rgbToLchD50, [](const Color &color) {
+		return color.rgbToLchD50();
+	});
+}
+void rgbToOklab(const Colors &input, const Colors &output) {
+	convert(input, output, &detail::Kernels::rgbToOklab, [](const Color &color) {
+		return color.rgbToOklab();
+	});
+}
+void rgbToHsl(const Colors &input, const Colors &output) {
+	convert(input, output, &detail::Kernels::rgbToHsl, [](const Color &color) {
+		return color.rgbToHsl();
+	});
+}
+void rgbToHsv(const Colors &input, const Colors &output) {
+	convert(input, output, &detail::Kernels::rgbToHsv, [](const Color &color) {
+		return color.rgbToHsv();
+	});
+}
+}
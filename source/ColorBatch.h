@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/** \file source/ColorBatch.h
+ * \brief Color space conversion functions for arrays of colors stored as structure of arrays.
+ *
+ * Conversions use SSE2 or AVX2 kernels when they are supported by the processor, and fall back to per color conversion functions from Color otherwise.
+ * SIMD kernels use polynomial approximations of pow, cbrt and atan2, so results differ from Color conversion functions by no more than 1e-4 for RGB, HSV, HSL
+ * and Oklab channel values, 1e-3 for Lab and LCH lightness and chroma, and 1e-2 degrees for LCH hue. Color::initialize must be called before any conversion.
+ */
+namespace batch {
+/** \struct Colors
+ * \brief Three color channel arrays of the same size.
+ */
+struct Colors {
+	Colors(float *first, float *second, float *third, size_t size);
+	float *data[3];
+	size_t size;
+};
+/** \enum Implementation
+ * \brief Conversion implementation.
+ */
+enum class Implementation : uint8_t {
+	scalar = 0,
+	sse2 = 1,
+	avx2 = 2,
+};
+/**
+ * Get best implementation supported by the processor.
+ * @return Implementation.
+ */
+Implementation bestImplementation();
+/**
+ * Get currently used implementation.
+ * @return Implementation.
+ */
+Implementation implementation();
+/**
+ * Select implementation used by conversion functions.
+ * @param[in] implementation Implementation. Unsupported implementations are replaced by the best supported implementation.
+ * @return Selected implementation.
+ */
+Implementation setImplementation(Implementation implementation);
+/**
+ * Transform RGB colors to linear RGB colors.
+ * @param[in] input Colors in RGB color space.
+ * @param[out] output Colors in linear RGB color space. Can be the same as input. Must be at least as large as input.
+ */
+void linearRgb(const Colors &input, const Colors &output);
+/**
+ * Convert RGB colors to Lab color space with illuminant D50, observer 2, sRGB transformation matrix and D65-D50 adaptation matrix.
+ * @param[in] input Colors in RGB color space.
+ * @param[out] output Colors in Lab color space. Can be the same as input. Must be at least as large as input.
+ * @see Color::rgbToLabD50.
+ */
+void rgbToLabD50(const Colors &input, const Colors &output);
+/**
+ * Convert RGB colors to LCH color space with illuminant D50, observer 2, sRGB transformation matrix and D65-D50 adaptation matrix.
+ * @param[in] input Colors in RGB color space.
+ * @param[out] output Colors in LCH color space. Can be the same as input. Must be at least as large as input.
+ * @see Color::rgbToLchD50.
+ */
+void rgbToLchD50(const Colors &input, const Colors &output);
+/**
+ * Convert RGB colors to Oklab color space.
+ * @param[in] input Colors in RGB color space.
+ * @param[out] output Colors in Oklab color space. Can be the same as input. Must be at least as large as input.
+ * @see Color::rgbToOklab.
+ */
+void rgbToOklab(const Colors &input, const Colors &output);
+/**
+ * Convert RGB colors to HSL color space.
+ * @param[in] input Colors in RGB color space.
+ * @param[out] output Colors in HSL color space. Can be the same as input. Must be at least as large as input.
+ * @see Color::rgbToHsl.
+ */
+void rgbToHsl(const Colors &input, const Colors &output);
+/**
+ * Convert RGB colors to HSV color space.
+ * @param[in] input Colors in RGB color space.
+ * @param[out] output Colors in HSV color space. Can be the same as input. Must be at least as large as input.
+ * @see Color::rgbToHsv.
+ */
+void rgbToHsv(const Colors &input, const Colors &output);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ColorBatchKernels.h"
+#if defined(GPICK_COLOR_BATCH_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+namespace batch {
+namespace detail {
+namespace {
+struct Avx2Traits {
+	typedef float Float __attribute__((vector_size(32)));
+	typedef int32_t Int __attribute__((vector_size(32)));
+	static constexpr size_t width = 8;
+	static Float sqrt(Float value) {
+		return _mm256_sqrt_ps(value);
+	}
+};
+}
+const Kernels *avx2Kernels() {
+	return SimdKernels<Avx2Traits>::kernels();
+}
+}
+}
+#else
+namespace batch {
+namespace detail {
+const Kernels *avx2Kernels() {
+	return nullptr;
+}
+}
+}
+#endif
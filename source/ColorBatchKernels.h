@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "ColorBatch.h"
+#include <cstring>
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define GPICK_COLOR_BATCH_SIMD
+#endif
+namespace batch {
+namespace detail {
+struct Constants {
+	/** Linear RGB to XYZ D50 transformation matrix with rows divided by the reference white. */
+	float labMatrix[9];
+};
+/** Kernel converts the largest prefix of input with size divisible by kernel width, and returns the number of converted colors. */
+using Kernel = size_t (*)(const Colors &input, const Colors &output, const Constants &constants);
+struct Kernels {
+	Kernel linearRgb, rgbToLabD50, rgbToLchD50, rgbToOklab, rgbToHsl, rgbToHsv;
+};
+/** @return SSE2 kernels or nullptr if they were not compiled in. */
+const Kernels *sse2Kernels();
+/** @return AVX2 kernels or nullptr if they were not compiled in. */
+const Kernels *avx2Kernels();
+#ifdef GPICK_COLOR_BATCH_SIMD
+namespace {
+/** Conversion kernels written with GCC vector extensions. Traits provide Float and Int vector types, vector width and sqrt function. */
+template<typename Traits>
+struct SimdKernels {
+	using Float = typename Traits::Float;
+	using Int = typename Traits::Int;
+	static constexpr size_t width = Traits::width;
+	static Float broadcast(float value) {
+		Float result = {};
+		return result + value;
+	}
+	static Float load(const float *data) {
+		Float result;
+		std::memcpy(&result, data, sizeof(Float));
+		return result;
+	}
+	static void store(float *data, Float value) {
+		std::memcpy(data, &value, sizeof(Float));
+	}
+	static Float select(Int mask, Float a, Float b) {
+		return reinterpret_cast<Float>((mask & reinterpret_cast<Int>(a)) | (~mask & reinterpret_cast<Int>(b)));
+	}
+	static Float min(Float a, Float b) {
+		return select(a < b, a, b);
+	}
+	static Float max(Float a, Float b) {
+		return select(a > b, a, b);
+	}
+	static Float abs(Float value) {
+		return reinterpret_cast<Float>(reinterpret_cast<Int>(value) & 0x7fffffff);
+	}
+	static Float floor(Float value) {
+		Float truncated = __builtin_convertvector(__builtin_convertvector(value, Int), Float);
+		return truncated - select(truncated > value, broadcast(1.0f), broadcast(0.0f));
+	}
+	/** Base 2 logarithm of positive normal values. */
+	static Float log2(Float value) {
+		Int bits = reinterpret_cast<Int>(value);
+		Int exponent = ((bits >> 23) & 0xff) - 127;
+		Float mantissa = reinterpret_cast<Float>((bits & 0x7fffff) | 0x3f800000);
+		Int large = mantissa > 1.41421356f;
+		mantissa = select(large, mantissa * 0.5f, mantissa);
+		exponent -= large;
+		Float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+		Float t2 = t * t;
+		Float logarithm = 2.0f * t * (1.0f + t2 * (1.0f / 3.0f + t2 * (1.0f / 5.0f + t2 * (1.0f / 7.0f + t2 * (1.0f / 9.0f)))));
+		return __builtin_convertvector(exponent, Float) + logarithm * 1.44269504f;
+	}
+	/** Base 2 exponent for values in range [-126, 127]. */
+	static Float exp2(Float value) {
+		Float integer = floor(value + 0.5f);
+		Float r = (value - integer) * 0.693147181f;
+		Float fraction = 1.0f + r * (1.0f + r * (1.0f / 2.0f + r * (1.0f / 6.0f + r * (1.0f / 24.0f + r * (1.0f / 120.0f + r * (1.0f / 720.0f + r * (1.0f / 5040.0f)))))));
+		Int scale = (__builtin_convertvector(integer, Int) + 127) << 23;
+		return fraction * reinterpret_cast<Float>(scale);
+	}
+	/** Power function for positive values. */
+	static Float pow(Float value, float exponent) {
+		return exp2(log2(value) * exponent);
+	}
+	static Float cbrt(Float value) {
+		Float a = abs(value);
+		Float result = exp2(log2(max(a, broadcast(1e-30f))) * (1.0f / 3.0f));
+		result = result - (result * result * result - a) / (3.0f * result * result);
+		result = select(a < 1e-30f, broadcast(0.0f), result);
+		return select(value < 0.0f, -result, result);
+	}
+	/** Angle of vector (x, y) in degrees in range [0, 360). */
+	static Float atan2Degrees(Float y, Float x) {
+		Float ax = abs(x), ay = abs(y);
+		Float high = max(ax, ay);
+		Float a = min(ax, ay) / max(high, broadcast(1e-30f));
+		Int reduce = a > 0.414213562f;
+		Float offset = select(reduce, broadcast(0.785398163f), broadcast(0.0f));
+		a = select(reduce, (a - 1.0f) / (a + 1.0f), a);
+		Float z = a * a;
+		Float angle = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * a + a + offset;
+		angle = select(ay > ax, 1.57079633f - angle, angle);
+		angle = select(x < 0.0f, 3.14159265f - angle, angle);
+		angle = select(y < 0.0f, -angle, angle);
+		angle = angle * 57.2957795f;
+		angle = select(angle < 0.0f, angle + 360.0f, angle);
+		return select(angle >= 360.0f, angle - 360.0f, angle);
+	}
+	static Float linearize(Float value) {
+		return select(value > 0.04045f, pow((value + 0.055f) * (1.0f / 1.055f), 2.4f), value * (1.0f / 12.92f));
+	}
+	static Float labFunction(Float value) {
+		const float epsilon = 216.0f / 24389.0f, k = 24389.0f / 27.0f;
+		return select(value > epsilon, cbrt(value), (k * value + 16.0f) * (1.0f / 116.0f));
+	}
+	static void lab(Float &first, Float &second, Float &third, const Constants &constants) {
+		const float *m = constants.labMatrix;
+		Float red = linearize(first), green = linearize(second), blue = linearize(third);
+		Float x = labFunction(m[0] * red + m[1] * green + m[2] * blue);
+		Float y = labFunction(m[3] * red + m[4] * green + m[5] * blue);
+		Float z = labFunction(m[6] * red + m[7] * green + m[8] * blue);
+		first = 116.0f * y - 16.0f;
+		second = 500.0f * (x - y);
+		third = 200.0f * (y - z);
+	}
+	static void hue(Float red, Float green, Float blue, Float maximum, Float delta, Float &hue) {
+		Float safeDelta = select(delta == 0.0f, broadcast(1.0f), delta);
+		Float redHue = (green - blue) / safeDelta;
+		Float greenHue = 2.0f + (blue - red) / safeDelta;
+		Float blueHue = 4.0f + (red - green) / safeDelta;
+		hue = select(red == maximum, redHue, select(green == maximum, greenHue, blueHue)) * (1.0f / 6.0f);
+		hue = hue - floor(hue);
+	}
+	template<typename Convert>
+	static size_t process(const Colors &input, const Colors &output, Convert convert) {
+		size_t count = input.size - input.size % width;
+		for (size_t i = 0; i < count; i += width) {
+			Float first = load(input.data[0] + i), second = load(input.data[1] + i), third = load(input.data[2] + i);
+			convert(first, second, third);
+			store(output.data[0] + i, first);
+			store(output.data[1] + i, second);
+			store(output.data[2] + i, third);
+		}
+		return count;
+	}
+	static size_t linearRgb(const Colors &input, const Colors &output, const Constants &) {
+		return process(input, output, [](Float &red, Float &green, Float &blue) {
+			red = linearize(red);
+			green = linearize(green);
+			blue = linearize(blue);
+		});
+	}
+	static size_t rgbToLabD50(const Colors &input, const Colors &output, const Constants &constants) {
+		return process(input, output, [&constants](Float &first, Float &second, Float &third) {
+			lab(first, second, third, constants);
+		});
+	}
+	static size_t rgbToLchD50(const Colors &input, const Colors &output, const Constants &constants) {
+		return process(input, output, [&constants](Float &first, Float &second, Float &third) {
+			lab(first, second, third, constants);
+			Float a = second, b = third;
+			second = Traits::sqrt(a * a + b * b);
+			third = atan2Degrees(b, a);
+		});
+	}
+	static size_t rgbToOklab(const Colors &input, const Colors &output, const Constants &) {
+		return process(input, output, [](Float &first, Float &second, Float &third) {
+			Float red = linearize(first), green = linearize(second), blue = linearize(third);
+			Float l = cbrt(0.4122214708f * red + 0.5363325363f * green + 0.0514459929f * blue);
+			Float m = cbrt(0.2119034982f * red + 0.6806995451f * green + 0.1073969566f * blue);
+			Float s = cbrt(0.0883024619f * red + 0.2817188376f * green + 0.6299787005f * blue);
+			first = 0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s;
+			second = 1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s;
+			third = 0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s;
+		});
+	}
+	static size_t rgbToHsl(const Colors &input, const Colors &output, const Constants &) {
+		return process(input, output, [](Float &first, Float &second, Float &third) {
+			Float red = first, green = second, blue = third;
+			Float maximum = max(red, max(green, blue)), minimum = min(red, min(green, blue));
+			Float delta = maximum - minimum;
+			Float lightness = (maximum + minimum) * 0.5f;
+			Float saturation = select(lightness < 0.5f, delta / (maximum + minimum), delta / (2.0f - maximum - minimum));
+			Float hueValue;
+			hue(red, green, blue, maximum, delta, hueValue);
+			Int gray = delta == 0.0f;
+			first = select(gray, broadcast(0.0f), hueValue);
+			second = select(gray, broadcast(0.0f), saturation);
+			third = lightness;
+		});
+	}
+	static size_t rgbToHsv(const Colors &input, const Colors &output, const Constants &) {
+		return process(input, output, [](Float &first, Float &second, Float &third) {
+			Float red = first, green = second, blue = third;
+			Float maximum = max(red, max(green, blue)), minimum = min(red, min(green, blue));
+			Float delta = maximum - minimum;
+			Float saturation = select(maximum != 0.0f, delta / select(maximum != 0.0f, maximum, broadcast(1.0f)), broadcast(0.0f));
+			Float hueValue;
+			hue(red, green, blue, maximum, delta, hueValue);
+			first = select(saturation == 0.0f, broadcast(0.0f), hueValue);
+			second = saturation;
+			third = maximum;
+		});
+	}
+	static const Kernels *kernels() {
+		static const Kernels result = { linearRgb, rgbToLabD50, rgbToLchD50, rgbToOklab, rgbToHsl, rgbToHsv };
+		return &result;
+	}
+};
+}
+#endif
+}
+}
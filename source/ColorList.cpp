@@ -26,8 +26,14 @@ struct NullPalette: public IPalette {
 	}
 	virtual void add(ColorList &colorList, ColorObject *colorObject) override {
 	}
+	virtual void insert(ColorList &colorList, ColorObject *colorObject, size_t position) override {
+	}
+	virtual void insertRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects, size_t position) override {
+	}
 	virtual void remove(ColorList &colorList, ColorObject *colorObject) override {
 	}
+	virtual void removeRange(ColorList &colorList, size_t first, size_t count) override {
+	}
 	virtual void removeSelected(ColorList &colorList) override {
 	}
 	virtual void clear(ColorList &colorList) override {
@@ -74,7 +80,7 @@ void ColorList::add(ColorObject *colorObject) {
 void ColorList::add(ColorObject *colorObject, size_t position, bool updatePalette) {
 	m_colors.insert(m_colors.begin() + position, colorObject->reference());
 	if (updatePalette)
-		m_palette.add(*this, colorObject);
+		m_palette.insert(*this, colorObject, position);
 	m_changed = true;
 }
 void ColorList::add(const ColorObject &colorObject) {
@@ -85,11 +91,39 @@ void ColorList::add(const ColorObject &colorObject) {
 }
 void ColorList::add(ColorList &colorList) {
 	auto guard = changeGuard();
-	for (auto *colorObject: colorList) {
+	addRange(common::Span<ColorObject *const>(colorList.m_colors.data(), colorList.m_colors.size()));
+}
+void ColorList::addRange(common::Span<ColorObject *const> colorObjects) {
+	if (colorObjects.size() == 0)
+		return;
+	reserve(colorObjects.size());
+	for (auto *colorObject: colorObjects)
 		m_colors.push_back(colorObject->reference());
-		m_palette.add(*this, colorObject);
-		m_changed = true;
-	}
+	m_palette.insertRange(*this, colorObjects, IPalette::append);
+	m_changed = true;
+}
+void ColorList::addRange(common::Span<const ColorObject> colorObjects) {
+	if (colorObjects.size() == 0)
+		return;
+	reserve(colorObjects.size());
+	size_t first = m_colors.size();
+	for (const auto &colorObject: colorObjects)
+		m_colors.push_back(colorObject.copy().unwrap());
+	m_palette.insertRange(*this, common::Span<ColorObject *const>(m_colors.data() + first, colorObjects.size()), IPalette::append);
+	m_changed = true;
+}
+void ColorList::insertRange(common::Span<ColorObject *const> colorObjects, size_t position, bool updatePalette) {
+	if (colorObjects.size() == 0)
+		return;
+	if (position > m_colors.size())
+		position = m_colors.size();
+	reserve(colorObjects.size());
+	m_colors.insert(m_colors.begin() + position, colorObjects.data(), colorObjects.data() + colorObjects.size());
+	for (auto *colorObject: colorObjects)
+		colorObject->reference();
+	if (updatePalette)
+		m_palette.insertRange(*this, colorObjects, position);
+	m_changed = true;
 }
 bool ColorList::startChanges() {
 	if (m_blocked)
@@ -116,6 +150,16 @@ size_t ColorList::size() const {
 bool ColorList::empty() const {
 	return m_colors.empty();
 }
+void ColorList::removeRange(size_t first, size_t count, bool updatePalette) {
+	if (count == 0)
+		return;
+	for (auto i = m_colors.begin() + first, end = i + count; i != end; ++i)
+		releaseItem(*i);
+	m_colors.erase(m_colors.begin() + first, m_colors.begin() + first + count);
+	if (updatePalette)
+		m_palette.removeRange(*this, first, count);
+	m_changed = true;
+}
 void ColorList::removeAll() {
 	for (auto *colorObject: m_colors) {
 		colorObject->release();
@@ -163,6 +207,12 @@ void ColorList::onEndChanges(ColorList *colorList) {
 void ColorList::releaseItem(ColorObject *colorObject) {
 	colorObject->release();
 }
+void ColorList::reserve(size_t count) {
+	// Capacity still grows geometrically when many small ranges are added one after another
+	size_t required = m_colors.size() + count;
+	if (m_colors.capacity() < required)
+		m_colors.reserve(std::max(required, m_colors.capacity() * 2));
+}
 void ColorList::paletteRemoveSelected() {
 	m_palette.removeSelected(*this);
 }
@@ -20,6 +20,7 @@
 #include "Color.h"
 #include "common/Ref.h"
 #include "common/Guard.h"
+#include "common/Span.h"
 #include <vector>
 #include <cstddef>
 struct ColorObject;
@@ -39,6 +40,25 @@ struct ColorList: public common::Ref<ColorList>::Counter {
 	void add(ColorObject *colorObject);
 	void add(ColorObject *colorObject, size_t position, bool updatePalette = false);
 	void add(ColorList &colorList);
+	/**
+	 * Add colors to the end of the list.
+	 * Palette is updated once for all added colors.
+	 * @param[in] colorObjects Added color objects, which are referenced by the list.
+	 */
+	void addRange(common::Span<ColorObject *const> colorObjects);
+	/**
+	 * Add copies of colors to the end of the list.
+	 * Palette is updated once for all added colors.
+	 * @param[in] colorObjects Copied color objects.
+	 */
+	void addRange(common::Span<const ColorObject> colorObjects);
+	/**
+	 * Insert colors.
+	 * @param[in] colorObjects Inserted color objects, which are referenced by the list.
+	 * @param[in] position Position of the first inserted color, positions past the end add colors after the last color.
+	 * @param[in] updatePalette Insert colors into palette too.
+	 */
+	void insertRange(common::Span<ColorObject *const> colorObjects, size_t position, bool updatePalette = false);
 	template<typename Callback>
 	void remove(Callback &&callback, bool selected, bool updatePalette) {
 		auto i = m_colors.begin();
@@ -56,6 +76,13 @@ struct ColorList: public common::Ref<ColorList>::Counter {
 			paletteRemoveSelected();
 		m_changed = true;
 	}
+	/**
+	 * Remove a range of colors.
+	 * @param[in] first Index of the first removed color.
+	 * @param[in] count Number of removed colors.
+	 * @param[in] updatePalette Remove colors from palette too.
+	 */
+	void removeRange(size_t first, size_t count, bool updatePalette);
 	void removeAll();
 	bool startChanges();
 	bool endChanges();
@@ -81,6 +108,7 @@ private:
 	bool m_blocked, m_changed;
 	static void onEndChanges(ColorList *colorList);
 	void releaseItem(ColorObject *colorObject);
+	void reserve(size_t count);
 	void paletteRemoveSelected();
 	void paletteRemove(ColorObject *colorObject);
 };
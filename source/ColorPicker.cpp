@@ -45,6 +45,9 @@
 #include "EventBus.h"
 #include "common/Guard.h"
 #include "common/Unused.h"
+#include "common/StageTimings.h"
+#include "common/RefreshScheduler.h"
+#include "PointerMotion.h"
 #include <gdk/gdkkeysyms.h>
 #include <array>
 #include <sstream>
@@ -71,14 +74,42 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 	GtkWidget *pickButton;
 	GtkWidget *colorWidget;
 	GtkWidget *colorInput;
-	guint timeoutSourceId;
+	GtkWidget *timingsLabel;
+	guint timeoutSourceId, timeoutInterval;
 	FloatingPicker floatingPicker;
 	dynv::Ref options, mainOptions;
 	GlobalState &gs;
 	bool ignoreCallback;
+	/** Options used on every update, copied from settings when they change. */
+	struct OptionsSnapshot {
+		bool zoomedEnabled, showTimings;
+	} snapshot;
+	/** State of the last update, used to skip updates when nothing has changed. */
+	struct LastUpdate {
+		bool valid;
+		GdkScreen *screen;
+		math::Vector2i pointer;
+		Color color;
+	} lastUpdate;
+	enum Stage {
+		captureStage,
+		sampleStage,
+		serializeStage,
+		displayStage,
+		zoomStage,
+	};
+	common::StageTimings stageTimings;
+	/** Update rate while pointer is not moving, when pointer motion events wake the picker up. */
+	static constexpr double idleRateWithMotionEvents = 2;
+	/** Update rate while pointer is not moving, when pointer motion is detected only by polling. */
+	static constexpr double idleRateWithoutMotionEvents = 10;
+	common::RefreshScheduler scheduler;
+	std::unique_ptr<PointerMotionMonitor> motionMonitor;
 	ColorPickerArgs(GlobalState &gs, const dynv::Ref &options):
 		options(options),
-		gs(gs) {
+		gs(gs),
+		stageTimings { "capture", "sample", "serialize", "display", "zoom" },
+		scheduler(30, idleRateWithoutMotionEvents, std::chrono::seconds(1)) {
 		swatchEditable.emplace(*this);
 		colorInputReadonly.emplace(*this);
 		contrastEditable.emplace(*this);
@@ -87,6 +118,10 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 		floatingPicker = nullptr;
 		ignoreCallback = false;
 		timeoutSourceId = 0;
+		timeoutInterval = 0;
+		snapshot.zoomedEnabled = options->getBool("zoomed_enabled", true);
+		snapshot.showTimings = false;
+		lastUpdate.valid = false;
 		gs.eventBus().subscribe(EventType::optionsUpdate, *this);
 		gs.eventBus().subscribe(EventType::convertersUpdate, *this);
 		gs.eventBus().subscribe(EventType::displayFiltersUpdate, *this);
@@ -123,41 +158,70 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 		return "color_picker";
 	}
 	virtual void activate() override {
+		startUpdates();
+		gtk_statusbar_push(GTK_STATUSBAR(statusBar), gtk_statusbar_get_context_id(GTK_STATUSBAR(statusBar), "focus_swatch"), _("Click on swatch area to begin adding colors to palette"));
+	}
+	/** Start timer driven updates if magnifier is enabled. Update rate is chosen by scheduler and increased immediately on pointer motion. */
+	void startUpdates() {
+		stopUpdates();
+		if (!snapshot.zoomedEnabled)
+			return;
+		motionMonitor = PointerMotionMonitor::create(gdk_screen_get_default(), [this]() {
+			onPointerMotion();
+		});
+		setSchedulerRates();
+		scheduler.wake(common::RefreshScheduler::Clock::now());
+		scheduleUpdate(scheduler.interval());
+	}
+	void stopUpdates() {
 		if (timeoutSourceId > 0) {
 			g_source_remove(timeoutSourceId);
 			timeoutSourceId = 0;
 		}
-		if (options->getBool("zoomed_enabled", true)){
-			auto refresh_rate = mainOptions->getInt32("refresh_rate", 30);
-			timeoutSourceId = g_timeout_add_full(G_PRIORITY_DEFAULT_IDLE, static_cast<int>(1000 / refresh_rate), (GSourceFunc)updateMainColorTimer, this, (GDestroyNotify)nullptr);
-		}
-		gtk_statusbar_push(GTK_STATUSBAR(statusBar), gtk_statusbar_get_context_id(GTK_STATUSBAR(statusBar), "focus_swatch"), _("Click on swatch area to begin adding colors to palette"));
+		motionMonitor.reset();
+	}
+	void setSchedulerRates() {
+		scheduler.setRates(mainOptions->getInt32("refresh_rate", 30), motionMonitor ? idleRateWithMotionEvents : idleRateWithoutMotionEvents);
+	}
+	void scheduleUpdate(common::RefreshScheduler::Duration interval) {
+		if (timeoutSourceId > 0)
+			g_source_remove(timeoutSourceId);
+		timeoutInterval = static_cast<guint>(std::chrono::duration_cast<std::chrono::milliseconds>(interval).count());
+		timeoutSourceId = g_timeout_add_full(G_PRIORITY_DEFAULT_IDLE, timeoutInterval, (GSourceFunc)updateMainColorTimer, this, (GDestroyNotify)nullptr);
+	}
+	void onPointerMotion() {
+		if (timeoutSourceId > 0 && scheduler.wake(common::RefreshScheduler::Clock::now()))
+			scheduleUpdate(common::RefreshScheduler::Duration::zero());
 	}
 	static gboolean updateMainColorTimer(ColorPickerArgs *args) {
-		args->updateMainColor();
-		return true;
+		bool changed = args->updateMainColor(true);
+		auto interval = args->scheduler.update(common::RefreshScheduler::Clock::now(), changed);
+		if (std::chrono::duration_cast<std::chrono::milliseconds>(interval).count() == args->timeoutInterval)
+			return true;
+		args->timeoutSourceId = 0;
+		args->scheduleUpdate(interval);
+		return false;
 	}
 	static void onZoomedActivate(GtkWidget *widget, ColorPickerArgs *args) {
-		if (args->options->getBool("zoomed_enabled", true)){
+		args->lastUpdate.valid = false;
+		if (args->snapshot.zoomedEnabled){
 			gtk_zoomed_set_fade(GTK_ZOOMED(args->zoomed_display), true);
 			args->options->set("zoomed_enabled", false);
-			if (args->timeoutSourceId > 0){
-				g_source_remove(args->timeoutSourceId);
-				args->timeoutSourceId = 0;
-			}
+			args->snapshot.zoomedEnabled = false;
+			args->stopUpdates();
 		}else{
 			gtk_zoomed_set_fade(GTK_ZOOMED(args->zoomed_display), false);
 			args->options->set("zoomed_enabled", true);
-			if (args->timeoutSourceId > 0){
-				g_source_remove(args->timeoutSourceId);
-				args->timeoutSourceId = 0;
-			}
-			auto refresh_rate = args->mainOptions->getInt32("refresh_rate", 30);
-			args->timeoutSourceId = g_timeout_add_full(G_PRIORITY_DEFAULT_IDLE, static_cast<int>(1000 / refresh_rate), (GSourceFunc)updateMainColorTimer, args, (GDestroyNotify)nullptr);
+			args->snapshot.zoomedEnabled = true;
+			args->startUpdates();
 		}
 		return;
 	}
-	void updateMainColor() {
+	/** Sample color under the pointer and update main color, color code and zoomed views.
+	 * @param[in] allowSkip Skip sampling and widget updates when pointer has not moved and screen pixels have not changed since the last update.
+	 * @return True if pointer has moved or sampled color has changed since the last update.
+	 */
+	bool updateMainColor(bool allowSkip = false) {
 		GdkScreen *screen;
 		GdkModifierType state;
 		int x, y;
@@ -172,35 +236,90 @@ struct ColorPickerArgs: public IColorPicker, public IEventHandler {
 		math::Rectangle<int> sampler_rect, zoomed_rect, final_rect;
 		sampler_get_screen_rect(gs.getSampler(), pointer, screen_rect, &sampler_rect);
 		screen_reader_add_rect(screen_reader, screen, sampler_rect);
-		bool zoomed_enabled = options->getBool("zoomed_enabled", true);
+		bool zoomed_enabled = snapshot.zoomedEnabled;
 		if (zoomed_enabled){
 			gtk_zoomed_get_screen_rect(GTK_ZOOMED(zoomed_display), pointer, screen_rect, &zoomed_rect);
 			screen_reader_add_rect(screen_reader, screen, zoomed_rect);
 		}
-		screen_reader_update_surface(screen_reader, &final_rect);
+		bool pixelsChanged;
+		{
+			common::StageTimings::Scope scope(stageTimings, captureStage);
+			pixelsChanged = screen_reader_update_surface(screen_reader, &final_rect);
+		}
+		bool pointerMoved = !lastUpdate.valid || lastUpdate.screen != screen || lastUpdate.pointer != pointer;
+		if (allowSkip && !pointerMoved && !pixelsChanged) {
+			stageTimings.skip();
+			updateTimingsLabel();
+			return false;
+		}
+		stageTimings.update();
 		math::Vector2i offset;
 		offset = sampler_rect.position() - final_rect.position();
 		Color c;
-		sampler_get_color_sample(gs.getSampler(), pointer, screen_rect, offset, &c);
-		std::string text = gs.converters().serialize(c, Converters::Type::display);
-		gtk_color_set_color(GTK_COLOR(colorCode), &c, text.c_str());
-		gtk_swatch_set_main_color(GTK_SWATCH(swatch_display), &c);
+		{
+			common::StageTimings::Scope scope(stageTimings, sampleStage);
+			sampler_get_color_sample(gs.getSampler(), pointer, screen_rect, offset, &c);
+		}
+		bool colorChanged = !lastUpdate.valid || c != lastUpdate.color;
+		if (!allowSkip || colorChanged) {
+			std::string text;
+			{
+				common::StageTimings::Scope scope(stageTimings, serializeStage);
+				text = gs.converters().serialize(c, Converters::Type::display);
+			}
+			common::StageTimings::Scope scope(stageTimings, displayStage);
+			gtk_color_set_color(GTK_COLOR(colorCode), &c, text.c_str());
+			gtk_swatch_set_main_color(GTK_SWATCH(swatch_display), &c);
+		}
 		if (zoomed_enabled){
+			common::StageTimings::Scope scope(stageTimings, zoomStage);
 			offset = final_rect.position() - zoomed_rect.position();
 			gtk_zoomed_update(GTK_ZOOMED(zoomed_display), pointer, screen_rect, offset, screen_reader_get_surface(screen_reader));
 		}
+		lastUpdate.valid = true;
+		lastUpdate.screen = screen;
+		lastUpdate.pointer = pointer;
+		lastUpdate.color = c;
+		updateTimingsLabel();
+		return pointerMoved || colorChanged;
+	}
+	virtual const common::StageTimings &updateTimings() const override {
+		return stageTimings;
+	}
+	virtual double wakeupsPerSecond() const override {
+		return scheduler.wakeupsPerSecond();
+	}
+	void updateTimingsLabel() {
+		if (!snapshot.showTimings)
+			return;
+		std::stringstream ss;
+		ss.imbue(std::locale::classic());
+		ss << stageTimings.format() << "\nwakeups: " << std::fixed << std::setprecision(1) << scheduler.wakeupsPerSecond() << "/s";
+		auto text = ss.str();
+		gtk_label_set_text(GTK_LABEL(timingsLabel), text.c_str());
+	}
+	/** Forget the last update, so that next timer update samples screen even if pointer and pixels did not change. */
+	void invalidateLastUpdate() {
+		lastUpdate.valid = false;
 	}
 	virtual void deactivate() override {
 		gtk_statusbar_pop(GTK_STATUSBAR(statusBar), gtk_statusbar_get_context_id(GTK_STATUSBAR(statusBar), "focus_swatch"));
-		if (timeoutSourceId > 0) {
-			g_source_remove(timeoutSourceId);
-			timeoutSourceId = 0;
-		}
+		stopUpdates();
 	}
 	virtual GtkWidget *getWidget() override {
 		return main;
 	}
 	void setOptions() {
+		snapshot.zoomedEnabled = options->getBool("zoomed_enabled", true);
+		snapshot.showTimings = options->getBool("show_timings", false);
+		if (snapshot.showTimings) {
+			gtk_widget_show(timingsLabel);
+		} else {
+			gtk_widget_hide(timingsLabel);
+			stageTimings.reset();
+		}
+		invalidateLastUpdate();
+		setSchedulerRates();
 		bool outOfGamutMask = options->getBool("out_of_gamut_mask", true);
 		int i = 0;
 		for (const auto &colorSpace: colorSpaces()) {
@@ -774,11 +893,13 @@ static gboolean onSwatchKeyPress(GtkWidget *widget, GdkEventKey *event, ColorPic
 static void on_oversample_value_changed(GtkRange *slider, gpointer data){
 	ColorPickerArgs* args=(ColorPickerArgs*)data;
 	sampler_set_oversample(args->gs.getSampler(), (int)gtk_range_get_value(GTK_RANGE(slider)));
+	args->invalidateLastUpdate();
 }
 
 static void on_zoom_value_changed(GtkRange *slider, gpointer data){
 	ColorPickerArgs* args=(ColorPickerArgs*)data;
 	gtk_zoomed_set_zoom(GTK_ZOOMED(args->zoomed_display), static_cast<float>(gtk_range_get_value(GTK_RANGE(slider))));
+	args->invalidateLastUpdate();
 }
 
 static void on_oversample_falloff_changed(GtkWidget *widget, gpointer data) {
@@ -791,6 +912,7 @@ static void on_oversample_falloff_changed(GtkWidget *widget, gpointer data) {
 
 		ColorPickerArgs* args = (ColorPickerArgs*)data;
 		sampler_set_falloff(args->gs.getSampler(), (SamplerFalloff) falloff_id);
+		args->invalidateLastUpdate();
 
 	}
 }
@@ -896,6 +1018,10 @@ static std::unique_ptr<IColorSource> build(GlobalState &gs, const dynv::Ref &opt
 			gtk_box_pack_start (GTK_BOX(vbox), args->zoomed_display, false, false, 0);
 			g_signal_connect(G_OBJECT(args->zoomed_display), "activated", G_CALLBACK(ColorPickerArgs::onZoomedActivate), args.get());
 
+			args->timingsLabel = gtk_label_new("");
+			gtk_label_set_selectable(GTK_LABEL(args->timingsLabel), true);
+			gtk_box_pack_start(GTK_BOX(vbox), args->timingsLabel, false, false, 0);
+
 
 		scrolled = gtk_scrolled_window_new(0, 0);
 		gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
@@ -21,6 +21,9 @@
 #include "FloatingPicker.h"
 #include <gtk/gtk.h>
 struct ColorSourceManager;
+namespace common {
+struct StageTimings;
+}
 void registerColorPicker(ColorSourceManager &csm);
 struct IColorPicker: public IColorSource {
 	virtual ~IColorPicker() = default;
@@ -32,5 +35,9 @@ struct IColorPicker: public IColorSource {
 	virtual void copy() = 0;
 	virtual void addToPalette() = 0;
 	virtual void set(int index) = 0;
+	/** @return Durations of capture, sample, serialize, display and zoom stages of timer driven picker updates, and number of skipped updates. */
+	virtual const common::StageTimings &updateTimings() const = 0;
+	/** @return Number of timer driven picker updates per second, measured over the last second. */
+	virtual double wakeupsPerSecond() const = 0;
 	static bool isColorPicker(const IColorSource &colorSource);
 };
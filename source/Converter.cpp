@@ -24,6 +24,7 @@
 #include "lua/Script.h"
 #include "lua/Lua.h"
 #include <string>
+#include <algorithm>
 #include <iostream>
 Converter::Options Converter::emptyOptions = {};
 Converter::Converter(const char *name, const char *label, lua::Ref &&serialize, lua::Ref &&deserialize):
@@ -31,6 +32,7 @@ Converter::Converter(const char *name, const char *label, lua::Ref &&serialize,
 	m_label(label),
 	m_serialize(std::move(serialize)),
 	m_deserialize(std::move(deserialize)),
+	m_inputFlags(ConverterInputFlags::none),
 	m_copy(false),
 	m_paste(false) {
 }
@@ -39,14 +41,21 @@ Converter::Converter(const char *name, const char *label, Callback<Serialize> se
 	m_label(label),
 	m_serializeCallback(serialize),
 	m_deserializeCallback(deserialize),
+	m_inputFlags(ConverterInputFlags::none),
 	m_copy(false),
 	m_paste(false) {
 }
 std::string Converter::serialize(const ColorObject &colorObject, const ConverterSerializePosition &position) {
 	if (m_serializeCallback)
 		return m_serializeCallback(colorObject, position);
-	if (!m_serialize.valid())
-		return "";
+	if (!m_serialize.valid()) {
+		if (!m_serializeBatch.valid())
+			return "";
+		std::vector<std::string> results;
+		const ColorObject *colorObjectPointer = &colorObject;
+		callSerializeBatch(&colorObjectPointer, 1, position.index(), position.count(), results);
+		return std::move(results.front());
+	}
 	lua_State *L = m_serialize.script();
 	int stackTop = lua_gettop(L);
 	m_serialize.get();
@@ -110,6 +119,67 @@ std::string Converter::serialize(const Color &color) {
 	ConverterSerializePosition position;
 	return serialize(colorObject, position);
 }
+void Converter::callSerializeBatch(const ColorObject *const *colorObjects, size_t length, size_t index, size_t count, std::vector<std::string> &results) {
+	lua_State *L = m_serializeBatch.script();
+	int stackTop = lua_gettop(L);
+	size_t resultCount = results.size() + length;
+	std::vector<ColorObject> copies; // Lua side can modify objects, so copies are passed
+	copies.reserve(length);
+	for (size_t i = 0; i < length; i++)
+		copies.push_back(*colorObjects[i]);
+	m_serializeBatch.get();
+	lua_createtable(L, static_cast<int>(length), 0);
+	for (size_t i = 0; i < length; i++) {
+		lua::pushColorObject(L, &copies[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_createtable(L, 0, 2);
+	lua_pushinteger(L, index);
+	lua_setfield(L, -2, "index");
+	lua_pushinteger(L, count);
+	lua_setfield(L, -2, "count");
+	int status = lua_pcall(L, 2, 1, 0);
+	if (status == 0) {
+		if (lua_type(L, -1) == LUA_TTABLE) {
+			for (size_t i = 0; i < length; i++) {
+				lua_rawgeti(L, -1, i + 1);
+				if (lua_type(L, -1) == LUA_TSTRING) {
+					size_t valueLength;
+					const char *value = lua_tolstring(L, -1, &valueLength);
+					results.emplace_back(value, valueLength);
+				} else {
+					std::cerr << "serialize: returned not a string value \"" << m_name << "\" at index " << index + i << '\n';
+					results.emplace_back();
+				}
+				lua_pop(L, 1);
+			}
+		} else {
+			std::cerr << "serialize: returned not a table value \"" << m_name << "\"\n";
+		}
+	} else {
+		std::cerr << "serialize: " << lua_tostring(L, -1) << '\n';
+	}
+	results.resize(resultCount);
+	lua_settop(L, stackTop);
+}
+std::vector<std::string> Converter::serialize(const std::vector<const ColorObject *> &colorObjects) {
+	std::vector<std::string> results;
+	size_t count = colorObjects.size();
+	results.reserve(count);
+	if (m_serializeCallback || !m_serializeBatch.valid()) {
+		for (size_t i = 0; i < count; i++)
+			results.push_back(serialize(*colorObjects[i], ConverterSerializePosition(count, i)));
+		return results;
+	}
+	// chunks limit how many userdata objects and result strings Lua has to keep alive at once
+	const size_t chunkSize = 1024;
+	for (size_t start = 0; start < count; start += chunkSize)
+		callSerializeBatch(colorObjects.data() + start, std::min(count - start, chunkSize), start, count, results);
+	return results;
+}
+void Converter::serializeBatch(lua::Ref &&serializeBatch) {
+	m_serializeBatch = std::move(serializeBatch);
+}
 const std::string &Converter::name() const {
 	return m_name;
 }
@@ -117,11 +187,41 @@ const std::string &Converter::label() const {
 	return m_label;
 }
 bool Converter::hasSerialize() const {
-	return m_serialize.valid() || m_serializeCallback;
+	return m_serialize.valid() || m_serializeBatch.valid() || m_serializeCallback;
 }
 bool Converter::hasDeserialize() const {
 	return m_deserialize.valid() || m_deserializeCallback;
 }
+bool Converter::serializeThreadSafe() const {
+	// Lua converters share one interpreter state
+	return static_cast<bool>(m_serializeCallback);
+}
+bool Converter::deserializeQualityLimited() const {
+	return static_cast<bool>(m_deserializeCallback);
+}
+void Converter::inputFlags(ConverterInputFlags flags) {
+	m_inputFlags = flags;
+}
+void Converter::inputPrefixes(std::vector<std::string> &&prefixes) {
+	m_inputPrefixes = std::move(prefixes);
+}
+ConverterInputFlags Converter::inputFlags() const {
+	return m_inputFlags;
+}
+const std::vector<std::string> &Converter::inputPrefixes() const {
+	return m_inputPrefixes;
+}
+bool Converter::accepts(const ConverterInput &input) const {
+	if (!input.has(m_inputFlags))
+		return false;
+	if (m_inputPrefixes.empty())
+		return true;
+	for (const auto &prefix: m_inputPrefixes) {
+		if (input.value().find(prefix) != std::string_view::npos)
+			return true;
+	}
+	return false;
+}
 void Converter::copy(bool value) {
 	m_copy = value;
 }
@@ -146,6 +246,12 @@ ConverterSerializePosition::ConverterSerializePosition(size_t count):
 	m_index(0),
 	m_count(count) {
 }
+ConverterSerializePosition::ConverterSerializePosition(size_t count, size_t index):
+	m_first(index == 0),
+	m_last(index + 1 >= count),
+	m_index(index),
+	m_count(count) {
+}
 bool ConverterSerializePosition::first() const {
 	return m_first;
 }
@@ -167,3 +273,102 @@ void ConverterSerializePosition::first(bool value) {
 void ConverterSerializePosition::last(bool value) {
 	m_last = value;
 }
+static bool isHex(char value) {
+	return (value >= '0' && value <= '9') || (value >= 'a' && value <= 'f') || (value >= 'A' && value <= 'F');
+}
+static bool isDigit(char value) {
+	return value >= '0' && value <= '9';
+}
+static bool endsWith(std::string_view value, size_t end, std::string_view suffix) {
+	return end >= suffix.length() && value.substr(end - suffix.length(), suffix.length()) == suffix;
+}
+static ConverterInputFlags hashFlags(size_t length) {
+	auto flags = ConverterInputFlags::none;
+	if (length >= 3)
+		flags |= ConverterInputFlags::hash3;
+	if (length >= 4)
+		flags |= ConverterInputFlags::hash4;
+	if (length >= 6)
+		flags |= ConverterInputFlags::hash6;
+	if (length >= 8)
+		flags |= ConverterInputFlags::hash8;
+	return flags;
+}
+ConverterInput::ConverterInput(std::string_view value):
+	m_value(value),
+	m_flags(ConverterInputFlags::none) {
+	// Numbers are counted as runs of digits and dots containing at least one digit. Signs and exponents split a number into more
+	// runs, so the count never falls below the number of values a converter could match.
+	size_t numbers = 0, hexLength = 0, hashHexLength = 0;
+	bool hashRun = false, inNumber = false, numberHasDigit = false;
+	for (size_t i = 0, length = value.length(); i < length; i++) {
+		char ch = value[i];
+		if (isHex(ch)) {
+			hexLength++;
+			if (hexLength >= 6)
+				m_flags |= ConverterInputFlags::hex6;
+			if (hashRun)
+				hashHexLength++;
+		} else {
+			if (hashRun)
+				m_flags |= hashFlags(hashHexLength);
+			hexLength = 0;
+			hashRun = ch == '#';
+			hashHexLength = 0;
+		}
+		if (isDigit(ch) || ch == '.') {
+			if (!inNumber) {
+				inNumber = true;
+				numberHasDigit = false;
+			}
+			if (isDigit(ch))
+				numberHasDigit = true;
+		} else {
+			if (inNumber && numberHasDigit)
+				numbers++;
+			inNumber = false;
+		}
+		switch (ch) {
+		case ',':
+			m_flags |= ConverterInputFlags::comma;
+			break;
+		case ';':
+			m_flags |= ConverterInputFlags::semicolon;
+			break;
+		case '\t':
+			m_flags |= ConverterInputFlags::tab;
+			break;
+		case '(':
+			if (endsWith(value, i, "rgb"))
+				m_flags |= ConverterInputFlags::rgbFunction;
+			else if (endsWith(value, i, "rgba"))
+				m_flags |= ConverterInputFlags::rgbaFunction;
+			else if (endsWith(value, i, "hsl"))
+				m_flags |= ConverterInputFlags::hslFunction;
+			else if (endsWith(value, i, "hsla"))
+				m_flags |= ConverterInputFlags::hslaFunction;
+			else if (endsWith(value, i, "oklch"))
+				m_flags |= ConverterInputFlags::oklchFunction;
+			else if (endsWith(value, i, "oklab"))
+				m_flags |= ConverterInputFlags::oklabFunction;
+			break;
+		}
+	}
+	if (hashRun)
+		m_flags |= hashFlags(hashHexLength);
+	if (inNumber && numberHasDigit)
+		numbers++;
+	if (numbers >= 3)
+		m_flags |= ConverterInputFlags::numbers3;
+	if (numbers >= 4)
+		m_flags |= ConverterInputFlags::numbers4;
+}
+std::string_view ConverterInput::value() const {
+	return m_value;
+}
+ConverterInputFlags ConverterInput::flags() const {
+	return m_flags;
+}
+bool ConverterInput::has(ConverterInputFlags flags) const {
+	return (m_flags & flags) == flags;
+}
@@ -19,14 +19,52 @@
 #ifndef GPICK_CONVERTER_H_
 #define GPICK_CONVERTER_H_
 #include "lua/Ref.h"
-#include "common/Scoped.h"
+#include "common/Bitmask.h"
 #include <string>
-#include <clocale>
+#include <string_view>
+#include <vector>
+#include <cstdint>
 struct ColorObject;
 struct Color;
+enum struct ConverterInputFlags: uint32_t {
+	none = 0,
+	hash3 = 1 << 0,
+	hash4 = 1 << 1,
+	hash6 = 1 << 2,
+	hash8 = 1 << 3,
+	hex6 = 1 << 4,
+	rgbFunction = 1 << 5,
+	rgbaFunction = 1 << 6,
+	hslFunction = 1 << 7,
+	hslaFunction = 1 << 8,
+	oklchFunction = 1 << 9,
+	oklabFunction = 1 << 10,
+	numbers3 = 1 << 11,
+	numbers4 = 1 << 12,
+	comma = 1 << 13,
+	semicolon = 1 << 14,
+	tab = 1 << 15,
+};
+ENABLE_BITMASK_OPERATORS(ConverterInputFlags);
+/**
+ * Result of a single lexing pass over converter input.
+ * Flags are set conservatively: a flag is only missing when no converter requiring it could match the input anywhere.
+ * hashN: '#' followed by at least N hex digits, hex6: at least 6 consecutive hex digits,
+ * numbersN: at least N separate numbers, xxxFunction: "xxx(" appears in the input.
+ */
+struct ConverterInput {
+	ConverterInput(std::string_view value);
+	std::string_view value() const;
+	ConverterInputFlags flags() const;
+	bool has(ConverterInputFlags flags) const;
+private:
+	std::string_view m_value;
+	ConverterInputFlags m_flags;
+};
 struct ConverterSerializePosition {
 	ConverterSerializePosition();
 	ConverterSerializePosition(size_t count);
+	ConverterSerializePosition(size_t count, size_t index);
 	bool first() const;
 	bool last() const;
 	size_t index() const;
@@ -58,8 +96,6 @@ struct Converter {
 		}
 		template<typename... Args>
 		auto operator()(Args &... args) const {
-			auto locale = std::setlocale(LC_NUMERIC, "C");
-			common::Scoped resetLocale(std::setlocale, LC_NUMERIC, locale);
 			return m_callback(args..., m_options);
 		}
 		explicit operator bool() const {
@@ -77,6 +113,31 @@ struct Converter {
 	const std::string &label() const;
 	bool hasSerialize() const;
 	bool hasDeserialize() const;
+	bool serializeThreadSafe() const;
+	/**
+	 * Check if deserialization quality never exceeds 1, which is the quality of a match covering the whole value.
+	 * Only internal converters give this guarantee, Lua converters can return any quality.
+	 * @return True if quality is limited.
+	 */
+	bool deserializeQualityLimited() const;
+	/**
+	 * Set features input must have before deserialization is attempted.
+	 * @param[in] flags Required input flags.
+	 */
+	void inputFlags(ConverterInputFlags flags);
+	/**
+	 * Set substrings input must contain at least one of before deserialization is attempted.
+	 * @param[in] prefixes Accepted prefixes, empty list accepts any input.
+	 */
+	void inputPrefixes(std::vector<std::string> &&prefixes);
+	ConverterInputFlags inputFlags() const;
+	const std::vector<std::string> &inputPrefixes() const;
+	/**
+	 * Check if deserialization of classified input can succeed.
+	 * @param[in] input Classified input.
+	 * @return False when converter certainly does not accept input.
+	 */
+	bool accepts(const ConverterInput &input) const;
 	bool copy() const;
 	bool paste() const;
 	void copy(bool value);
@@ -84,13 +145,28 @@ struct Converter {
 	std::string serialize(const ColorObject &colorObject, const ConverterSerializePosition &position);
 	std::string serialize(const ColorObject &colorObject);
 	std::string serialize(const Color &color);
+	/**
+	 * Serialize a list of color objects.
+	 * Lua converters with a batch function receive colors in chunks instead of one call per color.
+	 * @param[in] colorObjects Color objects to serialize.
+	 * @return Serialized text for each color object.
+	 */
+	std::vector<std::string> serialize(const std::vector<const ColorObject *> &colorObjects);
+	/**
+	 * Set Lua function which serializes an array of color objects and returns an array of strings.
+	 * @param[in] serializeBatch Lua function reference.
+	 */
+	void serializeBatch(lua::Ref &&serializeBatch);
 	bool deserialize(const char *value, ColorObject &colorObject, float &quality);
 private:
 	std::string m_name;
 	std::string m_label;
-	lua::Ref m_serialize, m_deserialize;
+	lua::Ref m_serialize, m_deserialize, m_serializeBatch;
 	Callback<Serialize> m_serializeCallback;
 	Callback<Deserialize> m_deserializeCallback;
+	ConverterInputFlags m_inputFlags;
+	std::vector<std::string> m_inputPrefixes;
 	bool m_copy, m_paste;
+	void callSerializeBatch(const ColorObject *const *colorObjects, size_t length, size_t index, size_t count, std::vector<std::string> &results);
 };
 #endif /* GPICK_CONVERTER_H_ */
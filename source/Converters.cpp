@@ -21,6 +21,7 @@
 #include "ColorObject.h"
 #include "common/First.h"
 #include <unordered_set>
+#include <algorithm>
 Converters::Converters() {
 }
 Converters::~Converters() {
@@ -40,11 +41,15 @@ void Converters::add(Converter *converter) {
 		m_pasteConverters.push_back(converter);
 	m_converters[converter->name()] = converter;
 }
-void Converters::add(const char *name, const char *label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize) {
-	add(new Converter(name, label, serialize, deserialize));
+void Converters::add(const char *name, const char *label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize, ConverterInputFlags inputFlags) {
+	auto converter = new Converter(name, label, serialize, deserialize);
+	converter->inputFlags(inputFlags);
+	add(converter);
 }
-void Converters::add(const char *name, const std::string &label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize) {
-	add(new Converter(name, label.c_str(), serialize, deserialize));
+void Converters::add(const char *name, const std::string &label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize, ConverterInputFlags inputFlags) {
+	auto converter = new Converter(name, label.c_str(), serialize, deserialize);
+	converter->inputFlags(inputFlags);
+	add(converter);
 }
 void Converters::rebuildCopyPasteArrays() {
 	m_copyConverters.clear();
@@ -165,9 +170,10 @@ bool Converters::deserialize(const std::string &value, ColorObject &outputColorO
 	common::First<float, std::greater<float>, ColorObject> bestConversion;
 	ColorObject colorObject;
 	float quality;
+	ConverterInput input(value);
 	if (m_displayConverter) {
 		Converter *converter = m_displayConverter;
-		if (converter->hasDeserialize()) {
+		if (converter->hasDeserialize() && converter->accepts(input)) {
 			if (converter->deserialize(value.c_str(), colorObject, quality)) {
 				if (quality > 0) {
 					bestConversion(quality, colorObject);
@@ -176,7 +182,7 @@ bool Converters::deserialize(const std::string &value, ColorObject &outputColorO
 		}
 	}
 	for (auto &converter: m_pasteConverters) {
-		if (converter == m_displayConverter || !converter->hasDeserialize())
+		if (converter == m_displayConverter || !converter->hasDeserialize() || !converter->accepts(input))
 			continue;
 		if (converter->deserialize(value.c_str(), colorObject, quality)) {
 			if (quality > 0) {
@@ -225,3 +231,63 @@ void Converters::reorder(const std::vector<std::string> &names) {
 	m_allConverters.clear();
 	m_allConverters = converters;
 }
+BulkDeserializer::BulkDeserializer(const std::vector<Converter *> &converters):
+	m_previous(0) {
+	for (auto *converter: converters) {
+		if (converter->hasDeserialize())
+			m_converters.push_back(converter);
+	}
+}
+bool BulkDeserializer::deserialize(std::string_view value, ColorObject &outputColorObject) {
+	ConverterInput input(value);
+	m_candidates.clear();
+	for (size_t i = 0; i < m_converters.size(); i++) {
+		if (m_converters[i]->accepts(input))
+			m_candidates.push_back(i);
+	}
+	if (m_candidates.empty())
+		return false;
+	common::First<float, std::greater<float>, ColorObject, size_t> bestConversion;
+	ColorObject colorObject;
+	float quality;
+	auto tryConverter = [&](size_t index) {
+		if (m_converters[index]->deserialize(value.data(), colorObject, quality)) {
+			if (quality > 0) {
+				bestConversion(quality, colorObject, index);
+			}
+		}
+	};
+	auto previous = std::find(m_candidates.begin(), m_candidates.end(), m_previous);
+	ColorObject previousColorObject;
+	float previousQuality = 0;
+	bool previousMatched = false;
+	if (previous != m_candidates.end()) {
+		previousMatched = m_converters[m_previous]->deserialize(value.data(), previousColorObject, previousQuality) && previousQuality > 0;
+		// Converters following the previous one cannot win when it matches the whole value, as ties are won by earlier converters.
+		bool limited = std::all_of(previous + 1, m_candidates.end(), [this](size_t index) {
+			return m_converters[index]->deserializeQualityLimited();
+		});
+		if (previousMatched && previousQuality >= 1 && limited) {
+			for (auto i = m_candidates.begin(); i != previous; ++i)
+				tryConverter(*i);
+			if (bestConversion && bestConversion.value() >= previousQuality) {
+				outputColorObject = bestConversion.data<ColorObject>();
+				m_previous = bestConversion.data<size_t>();
+			} else {
+				outputColorObject = previousColorObject;
+			}
+			return true;
+		}
+	}
+	for (auto i = m_candidates.begin(); i != m_candidates.end(); ++i) {
+		if (i != previous)
+			tryConverter(*i);
+		else if (previousMatched)
+			bestConversion(previousQuality, previousColorObject, m_previous);
+	}
+	if (!bestConversion)
+		return false;
+	outputColorObject = bestConversion.data<ColorObject>();
+	m_previous = bestConversion.data<size_t>();
+	return true;
+}
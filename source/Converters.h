@@ -22,6 +22,7 @@
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <string_view>
 struct ColorObject;
 struct Color;
 struct Converters {
@@ -33,8 +34,8 @@ struct Converters {
 	Converters();
 	~Converters();
 	void add(Converter *converter);
-	void add(const char *name, const char *label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize);
-	void add(const char *name, const std::string &label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize);
+	void add(const char *name, const char *label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize, ConverterInputFlags inputFlags = ConverterInputFlags::none);
+	void add(const char *name, const std::string &label, Converter::Callback<Converter::Serialize> serialize, Converter::Callback<Converter::Deserialize> deserialize, ConverterInputFlags inputFlags = ConverterInputFlags::none);
 	const std::vector<Converter *> &all() const;
 	const std::vector<Converter *> &allCopy() const;
 	const std::vector<Converter *> &allPaste() const;
@@ -54,6 +55,13 @@ struct Converters {
 	Converter *byNameOrFirstCopy(const char *name) const;
 	std::string serialize(const ColorObject &colorObject, Type type);
 	std::string serialize(const Color &color, Type type);
+	/**
+	 * Deserialize value using the display converter and paste converters.
+	 * Input is classified once and only converters which can accept it are tried. Result with the highest quality is used.
+	 * @param[in] value Text to deserialize.
+	 * @param[out] outputColorObject Deserialized color object.
+	 * @return True on success.
+	 */
 	bool deserialize(const std::string &value, ColorObject &outputColorObject);
 	void rebuildCopyPasteArrays();
 	void reorder(const char **names, size_t count);
@@ -65,4 +73,28 @@ private:
 	Converter *m_displayConverter;
 	Converter *m_colorListConverter;
 };
+/**
+ * Deserializes many values of similar format, for example lines of an imported text file.
+ * Result is the same as trying all converters in order and using the first result with the highest quality. Values no converter can accept are rejected
+ * without calling any converter, and the converter which produced the previous result is tried first. When it matches the whole value, only converters
+ * preceding it are tried too.
+ */
+struct BulkDeserializer {
+	/**
+	 * Create deserializer.
+	 * @param[in] converters Converters in order of preference, converters without deserialization are ignored.
+	 */
+	BulkDeserializer(const std::vector<Converter *> &converters);
+	/**
+	 * Deserialize value.
+	 * @param[in] value Text to deserialize, character after the end of value must be a null character.
+	 * @param[out] outputColorObject Deserialized color object.
+	 * @return True on success.
+	 */
+	bool deserialize(std::string_view value, ColorObject &outputColorObject);
+private:
+	std::vector<Converter *> m_converters;
+	std::vector<size_t> m_candidates;
+	size_t m_previous;
+};
 #endif /* GPICK_CONVERTERS_H_ */
@@ -21,12 +21,15 @@
 #include "ColorList.h"
 #include "ErrorCode.h"
 #include "dynv/Map.h"
-#include "common/Scoped.h"
 #include "common/Result.h"
 #include "version/Version.h"
+#include <glib.h>
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <fstream>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <boost/endian/conversion.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -72,127 +75,308 @@ private:
 	char m_type[16];
 	uint64_t m_size;
 };
-static bool read(std::istream &stream, ChunkHeader &header) {
-	stream.read(reinterpret_cast<char *>(&header), sizeof(header));
-	header.prepareRead();
-	return stream.good();
+namespace {
+/**
+ * Bounds checked little endian reader over mapped file data.
+ */
+struct Reader {
+	Reader(const char *data, size_t size, size_t position = 0):
+		m_data(data),
+		m_size(size),
+		m_position(position) {
+	}
+	size_t position() const {
+		return m_position;
+	}
+	size_t remaining() const {
+		return m_size - m_position;
+	}
+	bool skip(uint64_t length) {
+		if (length > remaining())
+			return false;
+		m_position += static_cast<size_t>(length);
+		return true;
+	}
+	bool read(uint8_t &value) {
+		if (remaining() < 1)
+			return false;
+		value = static_cast<uint8_t>(m_data[m_position++]);
+		return true;
+	}
+	bool read(uint32_t &value) {
+		if (remaining() < sizeof(value))
+			return false;
+		std::memcpy(&value, m_data + m_position, sizeof(value));
+		value = boost::endian::little_to_native<uint32_t>(value);
+		m_position += sizeof(value);
+		return true;
+	}
+	bool read(ChunkHeader &header) {
+		if (remaining() < sizeof(header))
+			return false;
+		std::memcpy(&header, m_data + m_position, sizeof(header));
+		header.prepareRead();
+		m_position += sizeof(header);
+		return true;
+	}
+	bool read(std::string_view &value) {
+		uint32_t length;
+		if (!read(length) || length > remaining())
+			return false;
+		value = std::string_view(m_data + m_position, length);
+		m_position += length;
+		return true;
+	}
+	bool skipString() {
+		uint32_t length;
+		return read(length) && skip(length);
+	}
+private:
+	const char *m_data;
+	size_t m_size, m_position;
+};
+enum class EntryError {
+	none,
+	badFile,
+	readFailed,
+};
+/**
+ * Walk one serialized dynv::Map entry and find "name" and "color" values.
+ * Same rules as dynv::Map::deserialize are used: values with unknown handlers are skipped and later values with the same name replace earlier ones.
+ */
+EntryError indexEntry(Reader &reader, const std::array<dynv::types::ValueType, 256> &types, const std::array<bool, 256> &known, uint64_t &nameOffset, uint64_t &colorOffset) {
+	using ValueType = dynv::types::ValueType;
+	uint32_t count;
+	if (!reader.read(count))
+		return EntryError::readFailed;
+	nameOffset = colorOffset = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		uint8_t handler;
+		std::string_view name;
+		if (!reader.read(handler) || !reader.read(name))
+			return EntryError::readFailed;
+		if (!known[handler]) {
+			uint32_t length;
+			if (!reader.read(length) || !reader.skip(length))
+				return EntryError::readFailed;
+			continue;
+		}
+		auto type = types[handler];
+		uint64_t valueOffset = reader.position();
+		bool ok;
+		switch (type) {
+		case ValueType::basicBool:
+			ok = reader.skip(1);
+			break;
+		case ValueType::basicFloat:
+		case ValueType::basicInt32:
+			ok = reader.skip(4);
+			break;
+		case ValueType::string:
+		case ValueType::color:
+			ok = reader.skipString();
+			break;
+		default:
+			return EntryError::badFile;
+		}
+		if (!ok)
+			return EntryError::readFailed;
+		if (name == "name")
+			nameOffset = type == ValueType::string ? valueOffset : 0;
+		else if (name == "color")
+			colorOffset = type == ValueType::color ? valueOffset : 0;
+	}
+	return EntryError::none;
 }
-static bool read(std::istream &stream, uint32_t &value) {
-	stream.read(reinterpret_cast<char *>(&value), sizeof(value));
-	value = boost::endian::little_to_native<uint32_t>(value);
-	return stream.good();
+/**
+ * Memory mapped palette file index.
+ * Opening validates the file and records name and color value offsets of each entry, entries are then decoded straight from the mapping.
+ */
+struct PaletteFileIndex {
+	PaletteFileIndex();
+	PaletteFileIndex(const PaletteFileIndex &) = delete;
+	PaletteFileIndex &operator=(const PaletteFileIndex &) = delete;
+	~PaletteFileIndex();
+	common::ResultVoid<ErrorCode> open(const char *filename);
+	void close();
+	/**
+	 * Get number of colors. Colors are indexed in palette order, after applying stored positions.
+	 * @return Color count.
+	 */
+	size_t size() const;
+	Color color(size_t index) const;
+	std::string_view name(size_t index) const;
+private:
+	struct Entry {
+		uint64_t name, color;
+	};
+	GMappedFile *m_mappedFile;
+	const char *m_data;
+	size_t m_size;
+	std::vector<Entry> m_entries;
+	bool m_noAlphaChannel;
+};
 }
-static bool read(std::istream &stream, std::string &value) {
-	uint32_t length;
-	if (!read(stream, length))
-		return false;
-	value.resize(length);
-	if (length == 0)
-		return true;
-	stream.read(reinterpret_cast<char *>(&value.front()), length);
-	return stream.good();
+PaletteFileIndex::PaletteFileIndex():
+	m_mappedFile(nullptr),
+	m_data(nullptr),
+	m_size(0),
+	m_noAlphaChannel(false) {
 }
-common::ResultVoid<ErrorCode> paletteFileLoad(const char* filename, ColorList &colorList) {
+PaletteFileIndex::~PaletteFileIndex() {
+	close();
+}
+void PaletteFileIndex::close() {
+	m_entries.clear();
+	m_data = nullptr;
+	m_size = 0;
+	if (m_mappedFile) {
+		g_mapped_file_unref(m_mappedFile);
+		m_mappedFile = nullptr;
+	}
+}
+common::ResultVoid<ErrorCode> PaletteFileIndex::open(const char *filename) {
 	using Result = common::ResultVoid<ErrorCode>;
-	std::ifstream file(filename, std::ios::binary);
-	if (!file.is_open())
+	close();
+	m_mappedFile = g_mapped_file_new(filename, false, nullptr);
+	if (!m_mappedFile)
 		return Result(ErrorCode::fileCouldNotBeOpened);
+	m_data = g_mapped_file_get_contents(m_mappedFile);
+	m_size = g_mapped_file_get_length(m_mappedFile);
+	auto fail = [this](ErrorCode errorCode) {
+		close();
+		return Result(errorCode);
+	};
+	Reader reader(m_data, m_size);
 	ChunkHeader header;
-	if (!read(file, header) || !header.valid() || !header.startsWith(CHUNK_TYPE_VERSION))
-		return Result(ErrorCode::readFailed);
+	if (!reader.read(header) || !header.valid() || !header.startsWith(CHUNK_TYPE_VERSION))
+		return fail(ErrorCode::readFailed);
 	if (header.size() < 4)
-		return Result(ErrorCode::badHeader);
+		return fail(ErrorCode::badHeader);
 	uint32_t version;
-	if (!read(file, version))
-		return Result(ErrorCode::readFailed);
+	if (!reader.read(version))
+		return fail(ErrorCode::readFailed);
 	if (!(version >= MinSupportedVersion && version <= MaxSupportedVersion))
-		return Result(ErrorCode::badVersion);
-	bool noAlphaChannel = version < 0x20000u;
-	file.seekg(header.size() - 4, std::ios::cur);
-	if (!file.good())
-		return Result(ErrorCode::readFailed);
-	if (!read(file, header) || !header.valid()) {
-		return file.eof() ? Result() : Result(ErrorCode::readFailed);
-	}
-	std::vector<ColorObject *> colorObjects;
-	common::Scoped releaseColorObjects([&colorObjects]() {
-		for (auto colorObject: colorObjects)
-			if (colorObject)
-				colorObject->release();
-	});
+		return fail(ErrorCode::badVersion);
+	m_noAlphaChannel = version < 0x20000u;
+	if (!reader.skip(header.size() - 4))
+		return Result();
+	std::vector<Entry> entries;
 	std::vector<uint32_t> positions;
-	std::unordered_map<uint8_t, dynv::types::ValueType> typeMap;
-	std::vector<std::string> handlers;
+	std::array<dynv::types::ValueType, 256> types;
+	std::array<bool, 256> known {};
+	size_t handlerCount = 0;
 	bool hasPositions = false;
-	for (;;) {
-		if (header.is(CHUNK_TYPE_HANDLER_MAP)) {
-			uint32_t handlerCount;
-			if (!read(file, handlerCount))
-				return Result(ErrorCode::readFailed);
-			if (handlerCount > 255)
-				return Result(ErrorCode::badFile);
-			for (size_t i = 0; i < handlerCount; i++) {
-				std::string typeName;
-				if (!read(file, typeName))
-					return Result(ErrorCode::readFailed);
-				typeMap[static_cast<uint8_t>(handlers.size())] = dynv::types::stringToType(typeName);
-				handlers.push_back(typeName);
+	while (reader.read(header)) { // truncated trailing chunk header is treated as end of file
+		if (!header.valid())
+			return fail(ErrorCode::readFailed);
+		if (header.is(CHUNK_TYPE_HANDLER_MAP)) { // handler map is read sequentially, chunk size is not used
+			uint32_t count;
+			if (!reader.read(count))
+				return fail(ErrorCode::readFailed);
+			if (count > 255)
+				return fail(ErrorCode::badFile);
+			for (uint32_t i = 0; i < count; i++) {
+				std::string_view typeName;
+				if (!reader.read(typeName))
+					return fail(ErrorCode::readFailed);
+				types[handlerCount] = dynv::types::stringToType(std::string(typeName));
+				known[handlerCount] = true;
+				handlerCount++;
+				if (handlerCount > 255)
+					return fail(ErrorCode::badFile);
 			}
-		} else if (header.is(CHUNK_TYPE_COLOR_LIST)) {
-			std::streamoff end = file.tellg() + static_cast<std::streamoff>(header.size());
-			while (file.tellg() < end) {
-				dynv::Map options;
-				if (!options.deserialize(file, typeMap))
-					return file.good() ? Result(ErrorCode::badFile) : Result(ErrorCode::readFailed);
-				auto color = options.getColor("color", Color());
-				auto name = options.getString("name", "");
-				if (noAlphaChannel)
-					color.alpha = 1.0f;
-				colorObjects.push_back(new ColorObject(name, color));
+		} else if (header.is(CHUNK_TYPE_COLOR_LIST)) { // last entry may extend past chunk end
+			uint64_t end = reader.position() + header.size();
+			while (reader.position() < end) {
+				Entry entry;
+				switch (indexEntry(reader, types, known, entry.name, entry.color)) {
+				case EntryError::none:
+					break;
+				case EntryError::badFile:
+					return fail(ErrorCode::badFile);
+				case EntryError::readFailed:
+					return fail(ErrorCode::readFailed);
+				}
+				entries.push_back(entry);
 			}
 		} else if (header.is(CHUNK_TYPE_COLOR_POSITIONS)) {
+			if (header.size() > reader.remaining())
+				return fail(ErrorCode::readFailed);
 			hasPositions = true;
-			positions.resize(header.size() / sizeof(uint32_t));
-			if (!positions.empty())
-				file.read(reinterpret_cast<char *>(&positions.front()), positions.size() * sizeof(uint32_t));
-			if (!file.good())
-				return Result(ErrorCode::readFailed);
-			for (auto &position: positions) {
-				position = boost::endian::little_to_native<uint32_t>(position);
-			}
-		} else {
-			file.seekg(header.size(), std::ios::cur);
-			if (file.eof())
-				break;
-			if (!file.good())
-				return Result(ErrorCode::readFailed);
-		}
-		if (!read(file, header) || !header.valid()) {
-			if (file.eof())
-				break;
-			else
-				return Result(ErrorCode::readFailed);
+			positions.resize(static_cast<size_t>(header.size() / sizeof(uint32_t)));
+			for (auto &position: positions)
+				reader.read(position);
+		} else if (!reader.skip(header.size())) {
+			break;
 		}
 	}
 	if (hasPositions) {
-		std::vector<std::pair<ColorObject *, size_t>> colorObjectsWithPositions;
-		colorObjectsWithPositions.reserve(colorObjects.size());
-		for (size_t i = 0, end = std::min(colorObjects.size(), positions.size()); i < end; i++) {
-			colorObjectsWithPositions.emplace_back(colorObjects[i], positions[i]);
-		}
-		std::stable_sort(colorObjectsWithPositions.begin(), colorObjectsWithPositions.end(), [](const std::pair<ColorObject *, size_t> &a, const std::pair<ColorObject *, size_t> &b) {
-			return a.second < b.second;
+		std::vector<std::pair<uint32_t, size_t>> order;
+		order.reserve(std::min(entries.size(), positions.size()));
+		for (size_t i = 0, end = std::min(entries.size(), positions.size()); i < end; i++)
+			order.emplace_back(positions[i], i);
+		std::stable_sort(order.begin(), order.end(), [](const std::pair<uint32_t, size_t> &a, const std::pair<uint32_t, size_t> &b) {
+			return a.first < b.first;
 		});
-		for (auto colorObjectWithPosition: colorObjectsWithPositions) {
-			colorList.add(colorObjectWithPosition.first);
-		}
+		m_entries.reserve(order.size());
+		for (const auto &item: order)
+			m_entries.push_back(entries[item.second]);
 	} else {
-		for (auto colorObject: colorObjects) {
-			colorList.add(colorObject);
-		}
+		m_entries = std::move(entries);
 	}
-	file.close();
-	return (file.good() || file.eof()) ? Result() : Result(ErrorCode::readFailed);
+	return Result();
+}
+size_t PaletteFileIndex::size() const {
+	return m_entries.size();
+}
+Color PaletteFileIndex::color(size_t index) const {
+	auto offset = m_entries[index].color;
+	if (offset == 0) {
+		Color result;
+		if (m_noAlphaChannel)
+			result.alpha = 1.0f;
+		return result;
+	}
+	uint32_t length;
+	std::memcpy(&length, m_data + offset, sizeof(length));
+	length = std::min<uint32_t>(boost::endian::little_to_native<uint32_t>(length), sizeof(float) * 4);
+	uint8_t buffer[sizeof(float) * 4] = {};
+	std::memcpy(buffer, m_data + offset + sizeof(length), length);
+	Color result;
+	for (int i = 0; i < 4; i++) {
+		uint32_t value;
+		std::memcpy(&value, buffer + i * sizeof(float), sizeof(value));
+		value = boost::endian::little_to_native<uint32_t>(value);
+		float component;
+		std::memcpy(&component, &value, sizeof(component));
+		result[i] = component;
+	}
+	if (m_noAlphaChannel)
+		result.alpha = 1.0f;
+	return result;
+}
+std::string_view PaletteFileIndex::name(size_t index) const {
+	auto offset = m_entries[index].name;
+	if (offset == 0)
+		return std::string_view();
+	uint32_t length;
+	std::memcpy(&length, m_data + offset, sizeof(length));
+	return std::string_view(m_data + offset + sizeof(length), boost::endian::little_to_native<uint32_t>(length));
+}
+common::ResultVoid<ErrorCode> paletteFileLoad(const char* filename, ColorList &colorList) {
+	PaletteFileIndex index;
+	auto result = index.open(filename);
+	if (!result)
+		return result;
+	std::vector<ColorObject *> colorObjects;
+	colorObjects.reserve(index.size());
+	for (size_t i = 0, count = index.size(); i < count; i++)
+		colorObjects.push_back(new ColorObject(std::string(index.name(i)), index.color(i)));
+	colorList.addRange(common::Span<ColorObject *const>(colorObjects.data(), colorObjects.size()));
+	for (auto *colorObject: colorObjects)
+		colorObject->release();
+	return result;
 }
 static bool write(std::ostream &stream, uint32_t value) {
 	auto data = boost::endian::native_to_little<uint32_t>(value);
@@ -26,6 +26,7 @@
 #include "Names.h"
 #include "Sampler.h"
 #include "ColorList.h"
+#include "Color.h"
 #include "EventBus.h"
 #include "layout/Layout.h"
 #include "layout/Layouts.h"
@@ -170,6 +171,7 @@ struct GlobalState::Impl {
 		paths.push_back(buildFilename());
 		paths.push_back(buildConfigPath());
 		m_script.setPaths(paths);
+		m_script.setCachePath(buildCachePath("lua"));
 		bool result = m_script.load("init");
 		if (!result) {
 			std::cerr << "Lua load error: " << m_script.getLastError() << "\n";
@@ -241,6 +243,7 @@ struct GlobalState::Impl {
 		m_sampler = sampler_new(m_screenReader);
 		initializeRandomGenerator();
 		loadSettings();
+		Color::setGammaMode(m_settings.getBool("gpick.color.fast_gamma", false) ? GammaMode::fast : GammaMode::exact);
 		m_names.load();
 		initializeConverters();
 		initializeLua();
@@ -17,12 +17,24 @@
  */
 
 #pragma once
+#include "common/Span.h"
+#include <cstddef>
 struct ColorList;
 struct ColorObject;
 struct IPalette {
+	static constexpr size_t append = static_cast<size_t>(-1);
 	virtual ~IPalette() = default;
 	virtual void add(ColorList &colorList, ColorObject *colorObject) = 0;
+	virtual void insert(ColorList &colorList, ColorObject *colorObject, size_t position) = 0;
+	/**
+	 * Insert a range of colors at once.
+	 * @param[in] colorList Color list containing inserted colors.
+	 * @param[in] colorObjects Inserted color objects.
+	 * @param[in] position Position of the first inserted color, IPalette::append adds colors after the last color.
+	 */
+	virtual void insertRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects, size_t position) = 0;
 	virtual void remove(ColorList &colorList, ColorObject *colorObject) = 0;
+	virtual void removeRange(ColorList &colorList, size_t first, size_t count) = 0;
 	virtual void removeSelected(ColorList &colorList) = 0;
 	virtual void clear(ColorList &colorList) = 0;
 	virtual void update(ColorList &colorList) = 0;
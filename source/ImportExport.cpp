@@ -29,13 +29,16 @@
 #include "dynv/Map.h"
 #include "version/Version.h"
 #include "parser/TextFile.h"
-#include "common/First.h"
+#include "parser/ParallelParser.h"
+#include "common/ChunkedWriter.h"
 #include <glib.h>
 #include <fstream>
 #include <string>
+#include <cstring>
 #include <sstream>
 #include <vector>
 #include <filesystem>
+#include <functional>
 #include <boost/math/special_functions/round.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/endian/conversion.hpp>
@@ -119,6 +122,22 @@ void ImportExport::setBackground(const char *background) {
 void ImportExport::setIncludeColorNames(bool include_color_names) {
 	m_includeColorNames = include_color_names;
 }
+//! Colors are formatted on multiple threads only when there are enough of them to outweigh thread startup.
+static constexpr size_t minParallelColors = 16384;
+/** Format all colors in chunks and write them to a stream in list order.
+ * @param[in,out] stream Output stream.
+ * @param[in] colorList Colors to write.
+ * @param[in] parallel Format function can be called from multiple threads.
+ * @param[in] format Color format function.
+ * @return True if all colors were written.
+ */
+static bool writeColors(std::ostream &stream, const ColorList &colorList, bool parallel, const std::function<void(ColorObject *colorObject, size_t index, std::ostream &stream)> &format) {
+	common::ChunkedWriter writer(1024, parallel && colorList.size() >= minParallelColors ? 0 : 1);
+	auto colors = colorList.begin();
+	return writer.write(stream, colorList.size(), [&colors, &format](size_t index, std::ostream &stream) {
+		format(colors[index], index, stream);
+	});
+}
 static void gplColor(ColorObject *colorObject, std::ostream &stream) {
 	using boost::math::iround;
 	Color color = colorObject->getColor();
@@ -138,13 +157,12 @@ bool ImportExport::exportGPL() {
 	f << "Name: " << path.filename().string() << '\n';
 	f << "Columns: 1" << '\n';
 	f << "#" << '\n';
-	for (auto color: m_colorList) {
-		gplColor(color, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
+	if (!writeColors(f, m_colorList, true, [](ColorObject *color, size_t, std::ostream &stream) {
+		gplColor(color, stream);
+	})) {
+		f.close();
+		m_lastError = Error::fileWriteError;
+		return false;
 	}
 	f.close();
 	return true;
@@ -208,25 +226,22 @@ bool ImportExport::exportTXT() {
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	ConverterSerializePosition position(m_colorList.size());
-	for (auto color: m_colorList) {
-		std::string line = m_converter->serialize(*color, position);
+	size_t count = m_colorList.size();
+	bool parallel = m_converter->serializeThreadSafe();
+	std::vector<std::string> lines;
+	if (!parallel) // Lua converters serialize in batches on the calling thread
+		lines = m_converter->serialize(std::vector<const ColorObject *>(m_colorList.begin(), m_colorList.end()));
+	if (!writeColors(f, m_colorList, parallel, [this, count, &lines](ColorObject *color, size_t index, std::ostream &stream) {
+		std::string line = lines.empty() ? m_converter->serialize(*color, ConverterSerializePosition(count, index)) : std::move(lines[index]);
 		if (m_includeColorNames) {
-			f << line << " " << color->getName() << '\n';
+			stream << line << " " << color->getName() << '\n';
 		} else {
-			f << line << '\n';
-		}
-		position.incrementIndex();
-		if (position.index() + 1 == position.count()) {
-			position.last(true);
-		}
-		if (position.first())
-			position.first(false);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
+			stream << line << '\n';
 		}
+	})) {
+		f.close();
+		m_lastError = Error::fileWriteError;
+		return false;
 	}
 	f.close();
 	return true;
@@ -237,43 +252,52 @@ bool ImportExport::importTXT() {
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	common::First<float, std::greater<float>, ColorObject> bestConversion;
+	BulkDeserializer deserializer(m_converters->allPaste());
 	ColorObject colorObject;
-	float quality;
-	std::string line, stripChars = " \t";
-	bool imported = false;
+	std::vector<ColorObject> colorObjects;
+	// File is read in blocks and lines are deserialized in place. Buffer has one spare byte, so a null character can always be written after a line.
+	std::vector<char> buffer(1024 * 1024 + 1);
+	size_t have = 0;
+	auto importLine = [&](char *start, char *end) {
+		while (start < end && (*start == ' ' || *start == '\t'))
+			++start;
+		while (end > start && (end[-1] == ' ' || end[-1] == '\t'))
+			--end;
+		if (start == end)
+			return;
+		*end = 0;
+		if (deserializer.deserialize(std::string_view(start, end - start), colorObject))
+			colorObjects.push_back(colorObject);
+	};
 	for (;;) {
-		std::getline(f, line);
-		stripLeadingTrailingChars(line, stripChars);
-		if (!line.empty()) {
-			for (auto &converter: m_converters->allPaste()) {
-				if (!converter->hasDeserialize())
-					continue;
-				if (converter->deserialize(line.c_str(), colorObject, quality)) {
-					if (quality > 0) {
-						bestConversion(quality, colorObject);
-					}
-				}
-			}
-			if (bestConversion) {
-				m_colorList.add(bestConversion.data<ColorObject>());
-				imported = true;
-				bestConversion.reset();
-			}
-		}
-		if (!f.good()) {
-			if (f.eof())
-				break;
+		f.read(buffer.data() + have, buffer.size() - 1 - have);
+		if (f.bad()) {
 			f.close();
 			m_lastError = Error::fileReadError;
 			return false;
 		}
+		size_t length = have + f.gcount();
+		char *lineStart = buffer.data(), *end = buffer.data() + length;
+		while (auto newline = static_cast<char *>(std::memchr(lineStart, '\n', end - lineStart))) {
+			importLine(lineStart, newline);
+			lineStart = newline + 1;
+		}
+		if (!f.good()) {
+			importLine(lineStart, end);
+			break;
+		}
+		have = end - lineStart;
+		std::memmove(buffer.data(), lineStart, have);
+		if (have == buffer.size() - 1)
+			buffer.resize(buffer.size() * 2);
 	}
 	f.close();
-	if (!imported) {
+	if (colorObjects.empty()) {
 		m_lastError = Error::noColorsImported;
+		return false;
 	}
-	return imported;
+	m_colorList.addRange(common::Span<const ColorObject>(colorObjects.data(), colorObjects.size()));
+	return true;
 }
 static void cssColor(ColorObject *colorObject, std::ostream &stream) {
 	Color color, hsl;
@@ -293,13 +317,12 @@ bool ImportExport::exportCSS() {
 	}
 	f << "/**" << '\n'
 		<< " * Generated by Gpick " << version::versionFull << '\n';
-	for (auto color: m_colorList) {
-		cssColor(color, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
+	if (!writeColors(f, m_colorList, true, [](ColorObject *color, size_t, std::ostream &stream) {
+		cssColor(color, stream);
+	})) {
+		f.close();
+		m_lastError = Error::fileWriteError;
+		return false;
 	}
 	f << " */" << '\n';
 	if (!f.good()) {
@@ -425,13 +448,13 @@ bool ImportExport::exportHTML() {
 	} else {
 		f << std::nouppercase;
 	}
-	for (auto color: m_colorList) {
-		htmlColor(color, m_converter, m_includeColorNames, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
+	bool parallel = !m_converter || m_converter->serializeThreadSafe();
+	if (!writeColors(f, m_colorList, parallel, [this](ColorObject *color, size_t, std::ostream &stream) {
+		htmlColor(color, m_converter, m_includeColorNames, stream);
+	})) {
+		f.close();
+		m_lastError = Error::fileWriteError;
+		return false;
 	}
 	f << "</div>" << '\n';
 	f << "<script>" << '\n'
@@ -485,13 +508,12 @@ bool ImportExport::exportMTL() {
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	for (auto color: m_colorList) {
-		mtlColor(color, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
+	if (!writeColors(f, m_colorList, true, [](ColorObject *color, size_t, std::ostream &stream) {
+		mtlColor(color, stream);
+	})) {
+		f.close();
+		m_lastError = Error::fileWriteError;
+		return false;
 	}
 	f.close();
 	return true;
@@ -543,13 +565,12 @@ bool ImportExport::exportASE() {
 	uint32_t blocks = m_colorList.size();
 	blocks = boost::endian::native_to_big<uint32_t>(blocks);
 	f.write((char *)&blocks, 4);
-	for (auto color: m_colorList) {
-		aseColor(color, f);
-		if (!f.good()) {
-			f.close();
-			m_lastError = Error::fileWriteError;
-			return false;
-		}
+	if (!writeColors(f, m_colorList, true, [](ColorObject *color, size_t, std::ostream &stream) {
+		aseColor(color, stream);
+	})) {
+		f.close();
+		m_lastError = Error::fileWriteError;
+		return false;
 	}
 	f.close();
 	return true;
@@ -822,19 +843,22 @@ bool ImportExport::importType(FileType type) {
 ImportExport::Error ImportExport::getLastError() const {
 	return m_lastError;
 }
-struct ImportTextFile: public text_file_parser::TextFile {
-	std::ifstream m_file;
+struct ImportTextFile: public text_file_parser::TextView {
+	GMappedFile *m_mappedFile;
 	std::vector<Color> m_colors;
 	bool m_failed;
 	ImportTextFile(const std::string &filename) {
 		m_failed = false;
-		m_file.open(filename, std::ios::in);
+		m_mappedFile = g_mapped_file_new(filename.c_str(), false, nullptr);
+		if (m_mappedFile)
+			setText(std::string_view(g_mapped_file_get_contents(m_mappedFile), g_mapped_file_get_length(m_mappedFile)));
 	}
 	bool isOpen() {
-		return m_file.is_open();
+		return m_mappedFile != nullptr;
 	}
 	virtual ~ImportTextFile() {
-		m_file.close();
+		if (m_mappedFile)
+			g_mapped_file_unref(m_mappedFile);
 	}
 	virtual void outOfMemory() {
 		m_failed = true;
@@ -842,16 +866,6 @@ struct ImportTextFile: public text_file_parser::TextFile {
 	virtual void syntaxError(size_t start_line, size_t start_column, size_t end_line, size_t end_colunn) {
 		m_failed = true;
 	}
-	virtual size_t read(char *buffer, size_t length) {
-		m_file.read(buffer, length);
-		size_t bytes = m_file.gcount();
-		if (bytes > 0) return bytes;
-		if (m_file.eof()) return 0;
-		if (!m_file.good()) {
-			m_failed = true;
-		}
-		return 0;
-	}
 	virtual void addColor(const Color &color) {
 		m_colors.push_back(color);
 	}
@@ -862,7 +876,8 @@ bool ImportExport::importTextFile(const text_file_parser::Configuration &configu
 		m_lastError = Error::couldNotOpenFile;
 		return false;
 	}
-	if (!importTextFile.parse(configuration)) {
+	text_file_parser::ParallelParser parser;
+	if (!parser.parse(importTextFile, configuration)) {
 		m_lastError = Error::parsingFailed;
 		return false;
 	}
@@ -874,9 +889,11 @@ bool ImportExport::importTextFile(const text_file_parser::Configuration &configu
 		m_lastError = Error::noColorsImported;
 		return false;
 	}
-	for (auto color: importTextFile.m_colors) {
-		m_colorList.add(ColorObject("", color));
-	}
+	std::vector<ColorObject> colorObjects;
+	colorObjects.reserve(importTextFile.m_colors.size());
+	for (auto color: importTextFile.m_colors)
+		colorObjects.emplace_back("", color);
+	m_colorList.addRange(common::Span<const ColorObject>(colorObjects.data(), colorObjects.size()));
 	return true;
 }
 const std::string &ImportExport::getFilename() const {
@@ -22,6 +22,7 @@
 #include "I18N.h"
 #include "common/MatchPattern.h"
 #include "common/Convert.h"
+#include "common/TextWriter.h"
 #include "math/Algorithms.h"
 #include "version/Version.h"
 #include <cstddef>
@@ -83,12 +84,10 @@ inline auto cssAlphaSeparator(size_t &active) {
 static std::string webHexSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[8];
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "#%02X%02X%02X", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
-	} else {
-		std::snprintf(result, sizeof(result), "#%02x%02x%02x", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
-	}
-	return result;
+	TextWriter writer(result);
+	writer << '#';
+	writer.hex(toInteger(c.red), 2, options.upperCaseHex).hex(toInteger(c.green), 2, options.upperCaseHex).hex(toInteger(c.blue), 2, options.upperCaseHex);
+	return std::string(writer.view());
 }
 static bool webHexDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view matched;
@@ -107,12 +106,10 @@ static bool webHexDeserialize(const char *value, ColorObject &colorObject, float
 static std::string webHexWithAlphaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[10];
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "#%02X%02X%02X%02X", toInteger(c.red), toInteger(c.green), toInteger(c.blue), toInteger(c.alpha));
-	} else {
-		std::snprintf(result, sizeof(result), "#%02x%02x%02x%02x", toInteger(c.red), toInteger(c.green), toInteger(c.blue), toInteger(c.alpha));
-	}
-	return result;
+	TextWriter writer(result);
+	writer << '#';
+	writer.hex(toInteger(c.red), 2, options.upperCaseHex).hex(toInteger(c.green), 2, options.upperCaseHex).hex(toInteger(c.blue), 2, options.upperCaseHex).hex(toInteger(c.alpha), 2, options.upperCaseHex);
+	return std::string(writer.view());
 }
 static bool webHexWithAlphaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view matched;
@@ -131,12 +128,9 @@ static bool webHexWithAlphaDeserialize(const char *value, ColorObject &colorObje
 static std::string webHexNoHashSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[7];
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "%02X%02X%02X", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
-	} else {
-		std::snprintf(result, sizeof(result), "%02x%02x%02x", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
-	}
-	return result;
+	TextWriter writer(result);
+	writer.hex(toInteger(c.red), 2, options.upperCaseHex).hex(toInteger(c.green), 2, options.upperCaseHex).hex(toInteger(c.blue), 2, options.upperCaseHex);
+	return std::string(writer.view());
 }
 static bool webHexNoHashDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view matched;
@@ -155,12 +149,10 @@ static bool webHexNoHashDeserialize(const char *value, ColorObject &colorObject,
 static std::string webHexShortSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[5];
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "#%X%X%X", toShortInteger(c.red), toShortInteger(c.green), toShortInteger(c.blue));
-	} else {
-		std::snprintf(result, sizeof(result), "#%x%x%x", toShortInteger(c.red), toShortInteger(c.green), toShortInteger(c.blue));
-	}
-	return result;
+	TextWriter writer(result);
+	writer << '#';
+	writer.hex(toShortInteger(c.red), 1, options.upperCaseHex).hex(toShortInteger(c.green), 1, options.upperCaseHex).hex(toShortInteger(c.blue), 1, options.upperCaseHex);
+	return std::string(writer.view());
 }
 static bool webHexShortDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view matched;
@@ -179,12 +171,10 @@ static bool webHexShortDeserialize(const char *value, ColorObject &colorObject,
 static std::string webHexShortWithAlphaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[6];
 	auto &c = colorObject.getColor();
-	if (options.upperCaseHex) {
-		std::snprintf(result, sizeof(result), "#%X%X%X%X", toShortInteger(c.red), toShortInteger(c.green), toShortInteger(c.blue), toShortInteger(c.alpha));
-	} else {
-		std::snprintf(result, sizeof(result), "#%x%x%x%x", toShortInteger(c.red), toShortInteger(c.green), toShortInteger(c.blue), toShortInteger(c.alpha));
-	}
-	return result;
+	TextWriter writer(result);
+	writer << '#';
+	writer.hex(toShortInteger(c.red), 1, options.upperCaseHex).hex(toShortInteger(c.green), 1, options.upperCaseHex).hex(toShortInteger(c.blue), 1, options.upperCaseHex).hex(toShortInteger(c.alpha), 1, options.upperCaseHex);
+	return std::string(writer.view());
 }
 static bool webHexShortWithAlphaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view matched;
@@ -203,12 +193,14 @@ static bool webHexShortWithAlphaDeserialize(const char *value, ColorObject &colo
 static std::string cssRgbSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[22];
 	auto &c = colorObject.getColor();
+	TextWriter writer(result);
+	const char *separator = options.cssCommaSeparators ? ", " : " ";
 	if (options.cssPercentages) {
-		std::snprintf(result, sizeof(result), options.cssCommaSeparators ? "rgb(%d%%, %d%%, %d%%)" : "rgb(%d%% %d%% %d%%)", toPercentage(c.red), toPercentage(c.green), toPercentage(c.blue));
+		writer << "rgb(" << toPercentage(c.red) << '%' << separator << toPercentage(c.green) << '%' << separator << toPercentage(c.blue) << "%)";
 	} else {
-		std::snprintf(result, sizeof(result), options.cssCommaSeparators ? "rgb(%d, %d, %d)" : "rgb(%d %d %d)", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
+		writer << "rgb(" << toInteger(c.red) << separator << toInteger(c.green) << separator << toInteger(c.blue) << ')';
 	}
-	return result;
+	return std::string(writer.view());
 }
 static bool cssRgbDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue, alpha;
@@ -228,18 +220,20 @@ static bool cssRgbDeserialize(const char *value, ColorObject &colorObject, float
 static std::string cssRgbaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[30];
 	auto &c = colorObject.getColor();
-	int offset;
+	TextWriter writer(result);
+	const char *separator = options.cssCommaSeparators ? ", " : " ";
+	const char *alphaSeparator = options.cssCommaSeparators ? ", " : " / ";
 	if (options.cssPercentages) {
-		offset = std::snprintf(result, sizeof(result), options.cssCommaSeparators ? "rgba(%d%%, %d%%, %d%%, " : "rgba(%d%% %d%% %d%% / ", toPercentage(c.red), toPercentage(c.green), toPercentage(c.blue));
+		writer << "rgba(" << toPercentage(c.red) << '%' << separator << toPercentage(c.green) << '%' << separator << toPercentage(c.blue) << '%' << alphaSeparator;
 	} else {
-		offset = std::snprintf(result, sizeof(result), options.cssCommaSeparators ? "rgba(%d, %d, %d, " : "rgba(%d %d %d / ", toInteger(c.red), toInteger(c.green), toInteger(c.blue));
+		writer << "rgba(" << toInteger(c.red) << separator << toInteger(c.green) << separator << toInteger(c.blue) << alphaSeparator;
 	}
 	if (options.cssAlphaPercentage) {
-		std::snprintf(result + offset, sizeof(result) - offset, "%d%%)", toPercentage(c.alpha));
+		writer << toPercentage(c.alpha) << "%)";
 	} else {
-		std::snprintf(result + offset, sizeof(result) - offset, "%0.3f)", c.alpha);
+		writer.fixed(c.alpha, 3) << ')';
 	}
-	return result;
+	return std::string(writer.view());
 }
 static bool cssRgbaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue, alpha;
@@ -259,8 +253,10 @@ static bool cssRgbaDeserialize(const char *value, ColorObject &colorObject, floa
 static std::string cssHslSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[21];
 	auto c = colorObject.getColor().rgbToHsl();
-	std::snprintf(result, sizeof(result), options.cssCommaSeparators ? "hsl(%d, %d%%, %d%%)" : "hsl(%d %d%% %d%%)", toDegrees(c.hsl.hue), toPercentage(c.hsl.saturation), toPercentage(c.hsl.lightness));
-	return result;
+	TextWriter writer(result);
+	const char *separator = options.cssCommaSeparators ? ", " : " ";
+	writer << "hsl(" << toDegrees(c.hsl.hue) << separator << toPercentage(c.hsl.saturation) << '%' << separator << toPercentage(c.hsl.lightness) << "%)";
+	return std::string(writer.view());
 }
 static bool cssHslDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view hue, saturation, lightness, alpha;
@@ -280,13 +276,15 @@ static bool cssHslDeserialize(const char *value, ColorObject &colorObject, float
 static std::string cssHslaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[29];
 	auto c = colorObject.getColor().rgbToHsl();
-	int offset = std::snprintf(result, sizeof(result), options.cssCommaSeparators ? "hsla(%d, %d%%, %d%%, " : "hsla(%d %d%% %d%% / ", toDegrees(c.hsl.hue), toPercentage(c.hsl.saturation), toPercentage(c.hsl.lightness));
+	TextWriter writer(result);
+	const char *separator = options.cssCommaSeparators ? ", " : " ";
+	writer << "hsla(" << toDegrees(c.hsl.hue) << separator << toPercentage(c.hsl.saturation) << '%' << separator << toPercentage(c.hsl.lightness) << '%' << (options.cssCommaSeparators ? ", " : " / ");
 	if (options.cssAlphaPercentage) {
-		std::snprintf(result + offset, sizeof(result) - offset, "%d%%)", toPercentage(c.alpha));
+		writer << toPercentage(c.alpha) << "%)";
 	} else {
-		std::snprintf(result + offset, sizeof(result) - offset, "%0.3f)", c.alpha);
+		writer.fixed(c.alpha, 3) << ')';
 	}
-	return result;
+	return std::string(writer.view());
 }
 static bool cssHslaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view hue, saturation, lightness, alpha;
@@ -306,12 +304,15 @@ static bool cssHslaDeserialize(const char *value, ColorObject &colorObject, floa
 static std::string cssOklchSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[23];
 	auto c = colorObject.getColor().rgbToOklch();
+	TextWriter writer(result);
 	if (options.cssPercentages) {
-		std::snprintf(result, sizeof(result), "oklch(%d%% %d%% %d)", toPercentage(c.oklch.L), toPercentage(c.oklch.C / 0.4f), toDegrees(c.oklch.h / 360.0f));
+		writer << "oklch(" << toPercentage(c.oklch.L) << "% " << toPercentage(c.oklch.C / 0.4f) << "% " << toDegrees(c.oklch.h / 360.0f) << ')';
 	} else {
-		std::snprintf(result, sizeof(result), "oklch(%0.3f %0.3f %d)", c.oklch.L, c.oklch.C, toDegrees(c.oklch.h / 360.0f));
+		writer << "oklch(";
+		writer.fixed(c.oklch.L, 3) << ' ';
+		writer.fixed(c.oklch.C, 3) << ' ' << toDegrees(c.oklch.h / 360.0f) << ')';
 	}
-	return result;
+	return std::string(writer.view());
 }
 static bool cssOklchDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view lightness, chroma, hue;
@@ -331,18 +332,20 @@ static bool cssOklchDeserialize(const char *value, ColorObject &colorObject, flo
 static std::string cssOklchaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[31];
 	auto c = colorObject.getColor().rgbToOklch();
-	int offset;
+	TextWriter writer(result);
 	if (options.cssPercentages) {
-		offset = std::snprintf(result, sizeof(result), "oklch(%d%% %d%% %d / ", toPercentage(c.oklch.L), toPercentage(c.oklch.C / 0.4f), toDegrees(c.oklch.h / 360.0f));
+		writer << "oklch(" << toPercentage(c.oklch.L) << "% " << toPercentage(c.oklch.C / 0.4f) << "% " << toDegrees(c.oklch.h / 360.0f) << " / ";
 	} else {
-		offset = std::snprintf(result, sizeof(result), "oklch(%0.3f %0.3f %d / ", c.oklch.L, c.oklch.C, toDegrees(c.oklch.h / 360.0f));
+		writer << "oklch(";
+		writer.fixed(c.oklch.L, 3) << ' ';
+		writer.fixed(c.oklch.C, 3) << ' ' << toDegrees(c.oklch.h / 360.0f) << " / ";
 	}
 	if (options.cssAlphaPercentage) {
-		std::snprintf(result + offset, sizeof(result) - offset, "%d%%)", toPercentage(c.alpha));
+		writer << toPercentage(c.alpha) << "%)";
 	} else {
-		std::snprintf(result + offset, sizeof(result) - offset, "%0.3f)", c.alpha);
+		writer.fixed(c.alpha, 3) << ')';
 	}
-	return result;
+	return std::string(writer.view());
 }
 static bool cssOklchaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view lightness, chroma, hue, alpha;
@@ -362,12 +365,16 @@ static bool cssOklchaDeserialize(const char *value, ColorObject &colorObject, fl
 static std::string cssOklabSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[27];
 	auto c = colorObject.getColor().rgbToOklab();
+	TextWriter writer(result);
 	if (options.cssPercentages) {
-		std::snprintf(result, sizeof(result), "oklab(%d%% %d%% %d%%)", toPercentage(c.oklab.L), toPercentage((c.oklab.a + 0.4f) * 1.25f), toPercentage((c.oklab.b + 0.4f) * 1.25f));
+		writer << "oklab(" << toPercentage(c.oklab.L) << "% " << toPercentage((c.oklab.a + 0.4f) * 1.25f) << "% " << toPercentage((c.oklab.b + 0.4f) * 1.25f) << "%)";
 	} else {
-		std::snprintf(result, sizeof(result), "oklab(%0.3f %0.3f %0.3f)", c.oklab.L, c.oklab.a, c.oklab.b);
+		writer << "oklab(";
+		writer.fixed(c.oklab.L, 3) << ' ';
+		writer.fixed(c.oklab.a, 3) << ' ';
+		writer.fixed(c.oklab.b, 3) << ')';
 	}
-	return result;
+	return std::string(writer.view());
 }
 static float oklabValue(float value, bool percentage) {
 	if (percentage)
@@ -393,18 +400,21 @@ static bool cssOklabDeserialize(const char *value, ColorObject &colorObject, flo
 static std::string cssOklabaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[35];
 	auto c = colorObject.getColor().rgbToOklab();
-	int offset;
+	TextWriter writer(result);
 	if (options.cssPercentages) {
-		offset = std::snprintf(result, sizeof(result), "oklab(%d%% %d%% %d%% / ", toPercentage(c.oklab.L), toPercentage((c.oklab.a + 0.4f) * 1.25f), toPercentage((c.oklab.b + 0.4f) * 1.25f));
+		writer << "oklab(" << toPercentage(c.oklab.L) << "% " << toPercentage((c.oklab.a + 0.4f) * 1.25f) << "% " << toPercentage((c.oklab.b + 0.4f) * 1.25f) << "% / ";
 	} else {
-		offset = std::snprintf(result, sizeof(result), "oklab(%0.3f %0.3f %0.3f / ", c.oklab.L, c.oklab.a, c.oklab.b);
+		writer << "oklab(";
+		writer.fixed(c.oklab.L, 3) << ' ';
+		writer.fixed(c.oklab.a, 3) << ' ';
+		writer.fixed(c.oklab.b, 3) << " / ";
 	}
 	if (options.cssAlphaPercentage) {
-		std::snprintf(result + offset, sizeof(result) - offset, "%d%%)", toPercentage(c.alpha));
+		writer << toPercentage(c.alpha) << "%)";
 	} else {
-		std::snprintf(result + offset, sizeof(result) - offset, "%0.3f)", c.alpha);
+		writer.fixed(c.alpha, 3) << ')';
 	}
-	return result;
+	return std::string(writer.view());
 }
 static bool cssOklabaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view lightness, a, b, alpha;
@@ -424,8 +434,11 @@ static bool cssOklabaDeserialize(const char *value, ColorObject &colorObject, fl
 static std::string csvRgbSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[18];
 	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f,%0.3f,%0.3f", c.red, c.green, c.blue);
-	return result;
+	TextWriter writer(result);
+	writer.fixed(c.red, 3) << ',';
+	writer.fixed(c.green, 3) << ',';
+	writer.fixed(c.blue, 3);
+	return std::string(writer.view());
 }
 static bool csvRgbDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue;
@@ -444,8 +457,11 @@ static bool csvRgbDeserialize(const char *value, ColorObject &colorObject, float
 static std::string csvRgbTabSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[18];
 	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f\t%0.3f\t%0.3f", c.red, c.green, c.blue);
-	return result;
+	TextWriter writer(result);
+	writer.fixed(c.red, 3) << '\t';
+	writer.fixed(c.green, 3) << '\t';
+	writer.fixed(c.blue, 3);
+	return std::string(writer.view());
 }
 static bool csvRgbTabDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue;
@@ -464,8 +480,11 @@ static bool csvRgbTabDeserialize(const char *value, ColorObject &colorObject, fl
 static std::string csvRgbSemicolonSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[18];
 	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f;%0.3f;%0.3f", c.red, c.green, c.blue);
-	return result;
+	TextWriter writer(result);
+	writer.fixed(c.red, 3) << ';';
+	writer.fixed(c.green, 3) << ';';
+	writer.fixed(c.blue, 3);
+	return std::string(writer.view());
 }
 static bool csvRgbSemicolonDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue;
@@ -484,8 +503,12 @@ static bool csvRgbSemicolonDeserialize(const char *value, ColorObject &colorObje
 static std::string csvRgbaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[24];
 	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f,%0.3f,%0.3f,%0.3f", c.red, c.green, c.blue, c.alpha);
-	return result;
+	TextWriter writer(result);
+	writer.fixed(c.red, 3) << ',';
+	writer.fixed(c.green, 3) << ',';
+	writer.fixed(c.blue, 3) << ',';
+	writer.fixed(c.alpha, 3);
+	return std::string(writer.view());
 }
 static bool csvRgbaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue, alpha;
@@ -504,8 +527,12 @@ static bool csvRgbaDeserialize(const char *value, ColorObject &colorObject, floa
 static std::string csvRgbaTabSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[24];
 	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f\t%0.3f\t%0.3f\t%0.3f", c.red, c.green, c.blue, c.alpha);
-	return result;
+	TextWriter writer(result);
+	writer.fixed(c.red, 3) << '\t';
+	writer.fixed(c.green, 3) << '\t';
+	writer.fixed(c.blue, 3) << '\t';
+	writer.fixed(c.alpha, 3);
+	return std::string(writer.view());
 }
 static bool csvRgbaTabDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue, alpha;
@@ -524,8 +551,12 @@ static bool csvRgbaTabDeserialize(const char *value, ColorObject &colorObject, f
 static std::string csvRgbaSemicolonSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[24];
 	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f;%0.3f;%0.3f;%0.3f", c.red, c.green, c.blue, c.alpha);
-	return result;
+	TextWriter writer(result);
+	writer.fixed(c.red, 3) << ';';
+	writer.fixed(c.green, 3) << ';';
+	writer.fixed(c.blue, 3) << ';';
+	writer.fixed(c.alpha, 3);
+	return std::string(writer.view());
 }
 static bool csvRgbaSemicolonDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue, alpha;
@@ -544,8 +575,11 @@ static bool csvRgbaSemicolonDeserialize(const char *value, ColorObject &colorObj
 static std::string valueRgbSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[20];
 	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f, %0.3f, %0.3f", c.red, c.green, c.blue);
-	return result;
+	TextWriter writer(result);
+	writer.fixed(c.red, 3) << ", ";
+	writer.fixed(c.green, 3) << ", ";
+	writer.fixed(c.blue, 3);
+	return std::string(writer.view());
 }
 static bool valueRgbDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue;
@@ -564,8 +598,12 @@ static bool valueRgbDeserialize(const char *value, ColorObject &colorObject, flo
 static std::string valueRgbaSerialize(const ColorObject &colorObject, const ConverterSerializePosition &position, const Options &options) {
 	char result[27];
 	auto &c = colorObject.getColor();
-	std::snprintf(result, sizeof(result), "%0.3f, %0.3f, %0.3f, %0.3f", c.red, c.green, c.blue, c.alpha);
-	return result;
+	TextWriter writer(result);
+	writer.fixed(c.red, 3) << ", ";
+	writer.fixed(c.green, 3) << ", ";
+	writer.fixed(c.blue, 3) << ", ";
+	writer.fixed(c.alpha, 3);
+	return std::string(writer.view());
 }
 static bool valueRgbaDeserialize(const char *value, ColorObject &colorObject, float &quality, const Options &options) {
 	std::string_view red, green, blue, alpha;
@@ -646,19 +684,19 @@ static std::string cssBlockWithAlphaSerialize(const ColorObject &colorObject, co
 }
 }
 void addInternalConverters(Converters &converters, Converter::Options &options) {
-	converters.add("color_web_hex", _("Web: hex code"), Serialize(webHexSerialize, options), Deserialize(webHexDeserialize, options));
-	converters.add("color_web_hex_with_alpha", _("Web: hex code with alpha"), Serialize(webHexWithAlphaSerialize, options), Deserialize(webHexWithAlphaDeserialize, options));
-	converters.add("color_web_hex_no_hash", _("Web: hex code (no hash symbol)"), Serialize(webHexNoHashSerialize, options), Deserialize(webHexNoHashDeserialize, options));
-	converters.add("color_web_hex_short", _("Web: short hex code"), Serialize(webHexShortSerialize, options), Deserialize(webHexShortDeserialize, options));
-	converters.add("color_web_hex_short_with_alpha", _("Web: short hex code with alpha"), Serialize(webHexShortWithAlphaSerialize, options), Deserialize(webHexShortWithAlphaDeserialize, options));
-	converters.add("color_css_rgb", _("CSS: red green blue"), Serialize(cssRgbSerialize, options), Deserialize(cssRgbDeserialize, options));
-	converters.add("color_css_rgba", _("CSS: red green blue alpha"), Serialize(cssRgbaSerialize, options), Deserialize(cssRgbaDeserialize, options));
-	converters.add("color_css_hsl", _("CSS: hue saturation lightness"), Serialize(cssHslSerialize, options), Deserialize(cssHslDeserialize, options));
-	converters.add("color_css_hsla", _("CSS: hue saturation lightness alpha"), Serialize(cssHslaSerialize, options), Deserialize(cssHslaDeserialize, options));
-	converters.add("color_css_oklch", "CSS: OKLCH", Serialize(cssOklchSerialize, options), Deserialize(cssOklchDeserialize, options));
-	converters.add("color_css_oklcha", _("CSS: OKLCH with alpha"), Serialize(cssOklchaSerialize, options), Deserialize(cssOklchaDeserialize, options));
-	converters.add("color_css_oklab", "CSS: OKLAB", Serialize(cssOklabSerialize, options), Deserialize(cssOklabDeserialize, options));
-	converters.add("color_css_oklaba", _("CSS: OKLAB with alpha"), Serialize(cssOklabaSerialize, options), Deserialize(cssOklabaDeserialize, options));
+	converters.add("color_web_hex", _("Web: hex code"), Serialize(webHexSerialize, options), Deserialize(webHexDeserialize, options), ConverterInputFlags::hash6);
+	converters.add("color_web_hex_with_alpha", _("Web: hex code with alpha"), Serialize(webHexWithAlphaSerialize, options), Deserialize(webHexWithAlphaDeserialize, options), ConverterInputFlags::hash8);
+	converters.add("color_web_hex_no_hash", _("Web: hex code (no hash symbol)"), Serialize(webHexNoHashSerialize, options), Deserialize(webHexNoHashDeserialize, options), ConverterInputFlags::hex6);
+	converters.add("color_web_hex_short", _("Web: short hex code"), Serialize(webHexShortSerialize, options), Deserialize(webHexShortDeserialize, options), ConverterInputFlags::hash3);
+	converters.add("color_web_hex_short_with_alpha", _("Web: short hex code with alpha"), Serialize(webHexShortWithAlphaSerialize, options), Deserialize(webHexShortWithAlphaDeserialize, options), ConverterInputFlags::hash4);
+	converters.add("color_css_rgb", _("CSS: red green blue"), Serialize(cssRgbSerialize, options), Deserialize(cssRgbDeserialize, options), ConverterInputFlags::rgbFunction);
+	converters.add("color_css_rgba", _("CSS: red green blue alpha"), Serialize(cssRgbaSerialize, options), Deserialize(cssRgbaDeserialize, options), ConverterInputFlags::rgbaFunction);
+	converters.add("color_css_hsl", _("CSS: hue saturation lightness"), Serialize(cssHslSerialize, options), Deserialize(cssHslDeserialize, options), ConverterInputFlags::hslFunction);
+	converters.add("color_css_hsla", _("CSS: hue saturation lightness alpha"), Serialize(cssHslaSerialize, options), Deserialize(cssHslaDeserialize, options), ConverterInputFlags::hslaFunction);
+	converters.add("color_css_oklch", "CSS: OKLCH", Serialize(cssOklchSerialize, options), Deserialize(cssOklchDeserialize, options), ConverterInputFlags::oklchFunction);
+	converters.add("color_css_oklcha", _("CSS: OKLCH with alpha"), Serialize(cssOklchaSerialize, options), Deserialize(cssOklchaDeserialize, options), ConverterInputFlags::oklchFunction);
+	converters.add("color_css_oklab", "CSS: OKLAB", Serialize(cssOklabSerialize, options), Deserialize(cssOklabDeserialize, options), ConverterInputFlags::oklabFunction);
+	converters.add("color_css_oklaba", _("CSS: OKLAB with alpha"), Serialize(cssOklabaSerialize, options), Deserialize(cssOklabaDeserialize, options), ConverterInputFlags::oklabFunction);
 	converters.add("css_color_hex", "CSS(color)", Serialize(cssColorHexSerialize, options), Deserialize());
 	converters.add("css_background_color_hex", "CSS(background-color)", Serialize(cssBackgroundColorHexSerialize, options), Deserialize());
 	converters.add("css_border_color_hex", "CSS(border-color)", Serialize(cssBorderColorHexSerialize, options), Deserialize());
@@ -668,12 +706,12 @@ void addInternalConverters(Converters &converters, Converter::Options &options)
 	converters.add("css_border_left_hex", "CSS(border-left-color)", Serialize(cssBorderLeftColorHexSerialize, options), Deserialize());
 	converters.add("color_css_block", _("CSS block"), Serialize(cssBlockSerialize, options), Deserialize());
 	converters.add("color_css_block_with_alpha", _("CSS block with alpha"), Serialize(cssBlockWithAlphaSerialize, options), Deserialize());
-	converters.add("csv_rgb", "CSV RGB", Serialize(csvRgbSerialize, options), Deserialize(csvRgbDeserialize, options));
-	converters.add("csv_rgb_tab", "CSV RGB "s + _("(tab separator)"), Serialize(csvRgbTabSerialize, options), Deserialize(csvRgbTabDeserialize, options));
-	converters.add("csv_rgb_semicolon", "CSV RGB "s + _("(semicolon separator)"), Serialize(csvRgbSemicolonSerialize, options), Deserialize(csvRgbSemicolonDeserialize, options));
-	converters.add("csv_rgba", "CSV RGBA", Serialize(csvRgbaSerialize, options), Deserialize(csvRgbaDeserialize, options));
-	converters.add("csv_rgba_tab", "CSV RGBA "s + _("(tab separator)"), Serialize(csvRgbaTabSerialize, options), Deserialize(csvRgbaTabDeserialize, options));
-	converters.add("csv_rgba_semicolon", "CSV RGBA "s + _("(semicolon separator)"), Serialize(csvRgbaSemicolonSerialize, options), Deserialize(csvRgbaSemicolonDeserialize, options));
-	converters.add("value_rgb", _("RGB values"), Serialize(valueRgbSerialize, options), Deserialize(valueRgbDeserialize, options));
-	converters.add("value_rgba", _("RGBA values"), Serialize(valueRgbaSerialize, options), Deserialize(valueRgbaDeserialize, options));
+	converters.add("csv_rgb", "CSV RGB", Serialize(csvRgbSerialize, options), Deserialize(csvRgbDeserialize, options), ConverterInputFlags::numbers3 | ConverterInputFlags::comma);
+	converters.add("csv_rgb_tab", "CSV RGB "s + _("(tab separator)"), Serialize(csvRgbTabSerialize, options), Deserialize(csvRgbTabDeserialize, options), ConverterInputFlags::numbers3 | ConverterInputFlags::tab);
+	converters.add("csv_rgb_semicolon", "CSV RGB "s + _("(semicolon separator)"), Serialize(csvRgbSemicolonSerialize, options), Deserialize(csvRgbSemicolonDeserialize, options), ConverterInputFlags::numbers3 | ConverterInputFlags::semicolon);
+	converters.add("csv_rgba", "CSV RGBA", Serialize(csvRgbaSerialize, options), Deserialize(csvRgbaDeserialize, options), ConverterInputFlags::numbers4 | ConverterInputFlags::comma);
+	converters.add("csv_rgba_tab", "CSV RGBA "s + _("(tab separator)"), Serialize(csvRgbaTabSerialize, options), Deserialize(csvRgbaTabDeserialize, options), ConverterInputFlags::numbers4 | ConverterInputFlags::tab);
+	converters.add("csv_rgba_semicolon", "CSV RGBA "s + _("(semicolon separator)"), Serialize(csvRgbaSemicolonSerialize, options), Deserialize(csvRgbaSemicolonDeserialize, options), ConverterInputFlags::numbers4 | ConverterInputFlags::semicolon);
+	converters.add("value_rgb", _("RGB values"), Serialize(valueRgbSerialize, options), Deserialize(valueRgbDeserialize, options), ConverterInputFlags::numbers3);
+	converters.add("value_rgba", _("RGBA values"), Serialize(valueRgbaSerialize, options), Deserialize(valueRgbaDeserialize, options), ConverterInputFlags::numbers4);
 }
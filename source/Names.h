@@ -21,11 +21,12 @@
 #include "EventBus.h"
 #include "dynv/MapFwd.h"
 #include "common/Span.h"
+#include <memory>
 #include <string>
 #include <vector>
 struct ColorList;
+struct NamesDictionary;
 struct Names: public IEventHandler {
-	static constexpr int spaceDivisions = 8;
 	struct InternalDescription {
 		const char *id;
 		const char *name;
@@ -42,18 +43,10 @@ struct Names: public IEventHandler {
 	void load();
 	void clear();
 private:
-	struct Entry {
-		std::string name;
-		Color color, originalColor;
-	};
 	EventBus &m_eventBus;
 	const dynv::Map &m_settings;
-	std::vector<Entry> m_entries[spaceDivisions][spaceDivisions][spaceDivisions];
+	std::vector<std::unique_ptr<NamesDictionary>> m_dictionaries;
 	bool m_imprecisionSuffix;
 	virtual void onEvent(EventType eventType) override;
-	void getXyz(const Color &color, int *x1, int *y1, int *z1, int *x2, int *y2, int *z2) const;
-	std::vector<Entry> &getEntryVector(const Color &color);
 	bool loadInternal(const InternalDescription &description);
-	template<typename OnColor, typename OnExpansion>
-	void iterate(const Color &color, OnColor onColor, OnExpansion onExpansion) const;
 };
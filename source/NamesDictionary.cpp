@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "NamesDictionary.h"
+#include "Paths.h"
+#include "common/MatchPattern.h"
+#include "common/Hash.h"
+#include <glib.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <iomanip>
+namespace fs = std::filesystem;
+namespace {
+const char magic[8] = { 'G', 'P', 'I', 'C', 'K', 'N', 'A', 'M' };
+const uint32_t version = 2;
+struct Header {
+	char magic[8];
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t nodeCount;
+	uint32_t namesSize;
+	uint64_t sourceSize;
+	uint64_t sourceHash;
+};
+static_assert(sizeof(Header) == 40);
+static_assert(sizeof(math::LabKdTree::Point) == 20);
+static_assert(sizeof(math::LabKdTree::Node) == 44);
+static int fromHex(char value) {
+	if (value >= '0' && value <= '9')
+		return value - '0';
+	else if (value >= 'a' && value <= 'f')
+		return value - 'a' + 10;
+	else if (value >= 'A' && value <= 'F')
+		return value - 'A' + 10;
+	else
+		return 0;
+}
+}
+std::optional<NamesDictionary::SourceStamp> NamesDictionary::SourceStamp::of(const std::string &filename) {
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return std::nullopt;
+	std::string data;
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	if (file.bad())
+		return std::nullopt;
+	return SourceStamp { data.size(), common::fnv1a(data) };
+}
+NamesDictionary::NamesDictionary():
+	m_mappedFile(nullptr) {
+}
+NamesDictionary::~NamesDictionary() {
+	unmap();
+}
+void NamesDictionary::unmap() {
+	m_entryView = common::Span<const Entry>();
+	m_nameView = common::Span<const char>();
+	m_index.clear();
+	if (m_mappedFile) {
+		g_mapped_file_unref(m_mappedFile);
+		m_mappedFile = nullptr;
+	}
+}
+std::string NamesDictionary::cacheFilename(const std::string &filename) {
+	std::stringstream stream;
+	stream << "names-" << std::hex << std::setw(16) << std::setfill('0') << common::fnv1a(fs::absolute(filename).string()) << ".bin";
+	return buildCachePath(stream.str().c_str());
+}
+std::unique_ptr<NamesDictionary> NamesDictionary::load(const std::string &filename) {
+	auto stamp = SourceStamp::of(filename);
+	if (!stamp)
+		return nullptr;
+	auto dictionary = std::make_unique<NamesDictionary>();
+	auto binaryFilename = cacheFilename(filename);
+	if (dictionary->loadBinary(binaryFilename, *stamp))
+		return dictionary;
+	if (!dictionary->loadText(filename))
+		return nullptr;
+	dictionary->build();
+	dictionary->saveBinary(binaryFilename, *stamp);
+	return dictionary;
+}
+void NamesDictionary::add(std::string_view name, const Color &color) {
+	if (m_mappedFile) {
+		m_entries.assign(m_entryView.data(), m_entryView.data() + m_entryView.size());
+		m_names.assign(m_nameView.data(), m_nameView.data() + m_nameView.size());
+		m_entryView = common::Span<const Entry>();
+		m_nameView = common::Span<const char>();
+	}
+	m_entries.push_back(Entry { { color.red, color.green, color.blue }, static_cast<uint32_t>(m_names.size()) });
+	m_names.insert(m_names.end(), name.begin(), name.end());
+	m_names.push_back('\0');
+	// index copies attached points before detaching from mapped data, so mapping can only be released afterwards
+	m_index.add(color.rgbToLabD50());
+	if (m_mappedFile) {
+		g_mapped_file_unref(m_mappedFile);
+		m_mappedFile = nullptr;
+	}
+}
+void NamesDictionary::build() {
+	if (m_mappedFile)
+		return;
+	m_index.build();
+	m_entryView = common::Span<const Entry>(m_entries.data(), m_entries.size());
+	m_nameView = common::Span<const char>(m_names.data(), m_names.size());
+}
+bool NamesDictionary::loadText(const std::string &filename) {
+	using namespace common::ops;
+	std::ifstream file(filename.c_str(), std::ifstream::in);
+	if (!file.is_open())
+		return false;
+	std::string line;
+	while (!(file.eof())) {
+		std::getline(file, line);
+		if (line.empty() || line[0] == '!' || line[0] == '#')
+			continue;
+		std::string_view matched;
+		size_t separatorStart, nameStart;
+		if (!common::matchPattern(std::string_view(line), save(count(hex, 6), matched), save(space, separatorStart, nameStart)))
+			continue;
+		Color color;
+		color.red = (fromHex(matched[0]) << 4 | fromHex(matched[1])) * (1 / 255.0f);
+		color.green = (fromHex(matched[2]) << 4 | fromHex(matched[3])) * (1 / 255.0f);
+		color.blue = (fromHex(matched[4]) << 4 | fromHex(matched[5])) * (1 / 255.0f);
+		color.alpha = 1.0f;
+		add(std::string_view(line).substr(nameStart), color);
+	}
+	file.close();
+	return true;
+}
+bool NamesDictionary::loadBinary(const std::string &filename, const SourceStamp &stamp) {
+	auto mappedFile = g_mapped_file_new(filename.c_str(), false, nullptr);
+	if (!mappedFile)
+		return false;
+	const char *data = g_mapped_file_get_contents(mappedFile);
+	size_t size = g_mapped_file_get_length(mappedFile);
+	Header header;
+	if (size < sizeof(Header)) {
+		g_mapped_file_unref(mappedFile);
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(Header));
+	if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version || header.sourceSize != stamp.size || header.sourceHash != stamp.hash) {
+		g_mapped_file_unref(mappedFile);
+		return false;
+	}
+	size_t pointsOffset = sizeof(Header);
+	size_t nodesOffset = pointsOffset + size_t(header.entryCount) * sizeof(math::LabKdTree::Point);
+	size_t entriesOffset = nodesOffset + size_t(header.nodeCount) * sizeof(math::LabKdTree::Node);
+	size_t namesOffset = entriesOffset + size_t(header.entryCount) * sizeof(Entry);
+	if (namesOffset + header.namesSize != size || (header.namesSize > 0 && data[size - 1] != '\0')) {
+		g_mapped_file_unref(mappedFile);
+		return false;
+	}
+	common::Span<const Entry> entries(reinterpret_cast<const Entry *>(data + entriesOffset), header.entryCount);
+	for (const auto &entry: entries) {
+		if (entry.nameOffset >= header.namesSize) {
+			g_mapped_file_unref(mappedFile);
+			return false;
+		}
+	}
+	unmap();
+	m_entries.clear();
+	m_names.clear();
+	if (!m_index.attach(common::Span<const math::LabKdTree::Point>(reinterpret_cast<const math::LabKdTree::Point *>(data + pointsOffset), header.entryCount), common::Span<const math::LabKdTree::Node>(reinterpret_cast<const math::LabKdTree::Node *>(data + nodesOffset), header.nodeCount))) {
+		g_mapped_file_unref(mappedFile);
+		return false;
+	}
+	m_mappedFile = mappedFile;
+	m_entryView = entries;
+	m_nameView = common::Span<const char>(data + namesOffset, header.namesSize);
+	return true;
+}
+bool NamesDictionary::saveBinary(const std::string &filename, const SourceStamp &stamp) const {
+	std::error_code ec;
+	fs::create_directories(fs::path(filename).parent_path(), ec);
+	if (ec)
+		return false;
+	auto points = m_index.points();
+	auto nodes = m_index.nodes();
+	Header header;
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.entryCount = static_cast<uint32_t>(m_entryView.size());
+	header.nodeCount = static_cast<uint32_t>(nodes.size());
+	header.namesSize = static_cast<uint32_t>(m_nameView.size());
+	header.sourceSize = stamp.size;
+	header.sourceHash = stamp.hash;
+	std::string data;
+	data.reserve(sizeof(header) + points.size() * sizeof(math::LabKdTree::Point) + nodes.size() * sizeof(math::LabKdTree::Node) + m_entryView.size() * sizeof(Entry) + m_nameView.size());
+	data.append(reinterpret_cast<const char *>(&header), sizeof(header));
+	data.append(reinterpret_cast<const char *>(points.data()), points.size() * sizeof(math::LabKdTree::Point));
+	data.append(reinterpret_cast<const char *>(nodes.data()), nodes.size() * sizeof(math::LabKdTree::Node));
+	data.append(reinterpret_cast<const char *>(m_entryView.data()), m_entryView.size() * sizeof(Entry));
+	data.append(m_nameView.data(), m_nameView.size());
+	// writes into a uniquely named temporary file and renames it, so concurrently running instances do not overwrite each other's partial output
+	GError *error = nullptr;
+	if (!g_file_set_contents(filename.c_str(), data.data(), data.size(), &error)) {
+		if (error)
+			g_error_free(error);
+		return false;
+	}
+	return true;
+}
+size_t NamesDictionary::size() const {
+	return m_entryView.size();
+}
+const char *NamesDictionary::name(size_t index) const {
+	return m_nameView.data() + m_entryView[index].nameOffset;
+}
+Color NamesDictionary::color(size_t index) const {
+	const auto &entry = m_entryView[index];
+	return Color(entry.color[0], entry.color[1], entry.color[2]);
+}
+const math::LabKdTree &NamesDictionary::index() const {
+	return m_index;
+}
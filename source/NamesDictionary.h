@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "Color.h"
+#include "math/LabKdTree.h"
+#include "common/Span.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+typedef struct _GMappedFile GMappedFile;
+
+/** \file source/NamesDictionary.h
+ * \brief Color name dictionary storage with nearest color index.
+ */
+
+/** \struct NamesDictionary
+ * \brief Single color name dictionary and its nearest color index.
+ *
+ * Dictionary data is either owned, or memory mapped from a precompiled binary file and used without copying. Binary files are created in the user cache directory
+ * the first time a text dictionary is loaded, and are reused while the text dictionary contents do not change.
+ */
+struct NamesDictionary {
+	/**
+	 * Text dictionary size and contents hash used to check if binary dictionary is up to date.
+	 */
+	struct SourceStamp {
+		uint64_t size;
+		uint64_t hash;
+		static std::optional<SourceStamp> of(const std::string &filename);
+	};
+	NamesDictionary();
+	NamesDictionary(const NamesDictionary &) = delete;
+	NamesDictionary &operator=(const NamesDictionary &) = delete;
+	~NamesDictionary();
+	/**
+	 * Load dictionary from a text file, using binary dictionary from the user cache directory when it is up to date.
+	 * @param[in] filename Text dictionary filename.
+	 * @return Loaded dictionary or nullptr if text dictionary could not be read.
+	 */
+	static std::unique_ptr<NamesDictionary> load(const std::string &filename);
+	/**
+	 * Get binary dictionary filename in the user cache directory for a text dictionary.
+	 * @param[in] filename Text dictionary filename.
+	 * @return Binary dictionary filename.
+	 */
+	static std::string cacheFilename(const std::string &filename);
+	/**
+	 * Add color name. Index must be rebuilt after adding names.
+	 * @param[in] name Color name.
+	 * @param[in] color Color in RGB color space.
+	 */
+	void add(std::string_view name, const Color &color);
+	void build();
+	bool loadText(const std::string &filename);
+	bool loadBinary(const std::string &filename, const SourceStamp &stamp);
+	bool saveBinary(const std::string &filename, const SourceStamp &stamp) const;
+	size_t size() const;
+	const char *name(size_t index) const;
+	Color color(size_t index) const;
+	const math::LabKdTree &index() const;
+private:
+	struct Entry {
+		float color[3];
+		uint32_t nameOffset;
+	};
+	std::vector<Entry> m_entries;
+	std::vector<char> m_names;
+	common::Span<const Entry> m_entryView;
+	common::Span<const char> m_nameView;
+	math::LabKdTree m_index;
+	GMappedFile *m_mappedFile;
+	void unmap();
+};
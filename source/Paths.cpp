@@ -86,6 +86,13 @@ static path &getUserConfigPath() {
 	configPath = path(g_get_user_config_dir());
 	return *configPath;
 }
+static path &getUserCachePath() {
+	static std::optional<path> cachePath;
+	if (cachePath)
+		return *cachePath;
+	cachePath = path(g_get_user_cache_dir());
+	return *cachePath;
+}
 static bool validateDataPath(const path &path) {
 	try {
 		std::error_code ec;
@@ -151,3 +158,9 @@ std::string buildConfigPath(const char *filename) {
 	else
 		return (getUserConfigPath() / "gpick").string();
 }
+std::string buildCachePath(const char *filename) {
+	if (filename)
+		return (getUserCachePath() / "gpick" / filename).string();
+	else
+		return (getUserCachePath() / "gpick").string();
+}
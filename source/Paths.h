@@ -37,4 +37,11 @@ std::string buildFilename(const char *filename = nullptr);
  * @return Filename to the configuration file.
  */
 std::string buildConfigPath(const char *filename = nullptr);
+
+/**
+ * Construct filename to a cache file.
+ * @param[in] filename Relative cache file name.
+ * @return Filename to the cache file.
+ */
+std::string buildCachePath(const char *filename = nullptr);
 #endif /* PATHS_H_ */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PointerMotion.h"
+#include <gtk/gtk.h>
+#if defined(GPICK_XINPUT_MOTION) && defined(GDK_WINDOWING_X11)
+#include <gdk/gdkx.h>
+#include <X11/Xlib.h>
+#include <X11/extensions/XInput2.h>
+namespace {
+struct XInputPointerMotionMonitor: PointerMotionMonitor {
+	XInputPointerMotionMonitor(Display *display, Window root, int opcode, std::function<void()> callback):
+		m_display(display),
+		m_root(root),
+		m_opcode(opcode),
+		m_callback(std::move(callback)) {
+		selectEvents(true);
+		gdk_window_add_filter(nullptr, onEvent, this);
+	}
+	virtual ~XInputPointerMotionMonitor() {
+		gdk_window_remove_filter(nullptr, onEvent, this);
+		selectEvents(false);
+	}
+private:
+	Display *m_display;
+	Window m_root;
+	int m_opcode;
+	std::function<void()> m_callback;
+	void selectEvents(bool enable) {
+		unsigned char bits[XIMaskLen(XI_RawMotion)] = { 0 };
+		if (enable)
+			XISetMask(bits, XI_RawMotion);
+		XIEventMask mask;
+		mask.deviceid = XIAllMasterDevices;
+		mask.mask_len = sizeof(bits);
+		mask.mask = bits;
+		XISelectEvents(m_display, m_root, &mask, 1);
+		XFlush(m_display);
+	}
+	static GdkFilterReturn onEvent(GdkXEvent *xevent, GdkEvent *, gpointer data) {
+		auto &monitor = *reinterpret_cast<XInputPointerMotionMonitor *>(data);
+		auto *event = reinterpret_cast<XEvent *>(xevent);
+		if (event->type == GenericEvent && event->xcookie.extension == monitor.m_opcode && event->xcookie.evtype == XI_RawMotion)
+			monitor.m_callback();
+		return GDK_FILTER_CONTINUE;
+	}
+};
+}
+std::unique_ptr<PointerMotionMonitor> PointerMotionMonitor::create(GdkScreen *screen, std::function<void()> callback) {
+	GdkDisplay *gdkDisplay = gdk_screen_get_display(screen);
+#if GTK_MAJOR_VERSION >= 3
+	if (!GDK_IS_X11_DISPLAY(gdkDisplay))
+		return nullptr;
+#endif
+	Display *display = GDK_DISPLAY_XDISPLAY(gdkDisplay);
+	int opcode, eventBase, errorBase;
+	if (!XQueryExtension(display, "XInputExtension", &opcode, &eventBase, &errorBase))
+		return nullptr;
+	int major = 2, minor = 0;
+	if (XIQueryVersion(display, &major, &minor) != Success || major < 2)
+		return nullptr;
+	Window root = RootWindow(display, GDK_SCREEN_XNUMBER(screen));
+	return std::make_unique<XInputPointerMotionMonitor>(display, root, opcode, std::move(callback));
+}
+#else
+std::unique_ptr<PointerMotionMonitor> PointerMotionMonitor::create(GdkScreen *, std::function<void()>) {
+	return nullptr;
+}
+#endif
@@ -19,13 +19,21 @@
 #include "Sampler.h"
 #include "ScreenReader.h"
 #include <cmath>
+#include <cstring>
+#include <vector>
 #include <gdk/gdk.h>
+#if defined(__SSE2__) || defined(_M_X64)
+#define GPICK_SAMPLER_SSE2
+#include <emmintrin.h>
+#endif
 
 struct Sampler {
 	int oversample;
 	SamplerFalloff falloff;
 	float (*falloff_fnc)(float distance);
 	ScreenReader *screen_reader;
+	/** Falloff weights of the (2 * oversample + 1)^2 sampling window, rows are y. Empty when kernel must be rebuilt. */
+	std::vector<float> kernel;
 };
 static float sampler_falloff_none(float distance) {
 	return 1;
@@ -54,6 +62,7 @@ void sampler_destroy(Sampler *sampler) {
 }
 void sampler_set_falloff(Sampler *sampler, SamplerFalloff falloff) {
 	sampler->falloff = falloff;
+	sampler->kernel.clear();
 	switch (falloff) {
 	case SamplerFalloff::none:
 		sampler->falloff_fnc = sampler_falloff_none;
@@ -75,17 +84,77 @@ void sampler_set_falloff(Sampler *sampler, SamplerFalloff falloff) {
 	}
 }
 void sampler_set_oversample(Sampler *sampler, int oversample) {
+	if (sampler->oversample != oversample)
+		sampler->kernel.clear();
 	sampler->oversample = oversample;
 }
-static void getPixel(unsigned char *data, int stride, int x, int y, Color *color) {
-	unsigned char *p;
-	p = data + y * stride + x * 4;
-	color->rgb.red = p[2] * (1 / 255.0f);
-	color->rgb.green = p[1] * (1 / 255.0f);
-	color->rgb.blue = p[0] * (1 / 255.0f);
+static const std::vector<float> &getKernel(Sampler *sampler) {
+	if (!sampler->kernel.empty())
+		return sampler->kernel;
+	int oversample = sampler->oversample;
+	int size = 2 * oversample + 1;
+	sampler->kernel.resize(size * size);
+	float max_distance = static_cast<float>(1 / std::sqrt(2 * std::pow((double)oversample, 2)));
+	for (int y = -oversample; y <= oversample; ++y) {
+		for (int x = -oversample; x <= oversample; ++x) {
+			float f;
+			if (oversample) {
+				f = sampler->falloff_fnc(static_cast<float>(std::sqrt((double)(x * x + y * y)) * max_distance));
+			} else {
+				f = 1;
+			}
+			sampler->kernel[(y + oversample) * size + x + oversample] = f;
+		}
+	}
+	return sampler->kernel;
+}
+#ifdef GPICK_SAMPLER_SSE2
+static __m128 loadPixel(const unsigned char *pixel) {
+	int32_t value;
+	std::memcpy(&value, pixel, 4);
+	__m128i zero = _mm_setzero_si128();
+	return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero));
+}
+/** Accumulates weighted BGRA pixels of one row into sum and returns the sum of weights. */
+static float addRow(const unsigned char *pixels, const float *weights, int count, float sum[4]) {
+	__m128i zero = _mm_setzero_si128();
+	__m128 a = _mm_setzero_ps(), b = _mm_setzero_ps(), weightSum = _mm_setzero_ps();
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i * 4));
+		__m128i low = _mm_unpacklo_epi8(bytes, zero), high = _mm_unpackhi_epi8(bytes, zero);
+		__m128 w = _mm_loadu_ps(weights + i);
+		weightSum = _mm_add_ps(weightSum, w);
+		a = _mm_add_ps(a, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), _mm_shuffle_ps(w, w, _MM_SHUFFLE(0, 0, 0, 0))));
+		b = _mm_add_ps(b, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), _mm_shuffle_ps(w, w, _MM_SHUFFLE(1, 1, 1, 1))));
+		a = _mm_add_ps(a, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 2, 2))));
+		b = _mm_add_ps(b, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 3, 3))));
+	}
+	for (; i < count; ++i) {
+		a = _mm_add_ps(a, _mm_mul_ps(loadPixel(pixels + i * 4), _mm_set1_ps(weights[i])));
+		weightSum = _mm_add_ss(weightSum, _mm_set_ss(weights[i]));
+	}
+	float values[4], weightValues[4];
+	_mm_storeu_ps(values, _mm_add_ps(a, b));
+	_mm_storeu_ps(weightValues, weightSum);
+	for (int channel = 0; channel < 4; ++channel)
+		sum[channel] += values[channel];
+	return weightValues[0] + weightValues[1] + weightValues[2] + weightValues[3];
+}
+#else
+/** Accumulates weighted BGRA pixels of one row into sum and returns the sum of weights. */
+static float addRow(const unsigned char *pixels, const float *weights, int count, float sum[4]) {
+	float weightSum = 0;
+	for (int i = 0; i < count; ++i) {
+		for (int channel = 0; channel < 4; ++channel)
+			sum[channel] += pixels[i * 4 + channel] * weights[i];
+		weightSum += weights[i];
+	}
+	return weightSum;
 }
+#endif
 int sampler_get_color_sample(Sampler *sampler, math::Vector2i &pointer, math::Rectangle<int> &screen_rect, math::Vector2i &offset, Color *color) {
-	Color sample, result = { 0.0f };
+	Color result = { 0.0f };
 	float divider = 0;
 	cairo_surface_t *surface = screen_reader_get_surface(sampler->screen_reader);
 	int x = pointer.x, y = pointer.y;
@@ -98,26 +167,24 @@ int sampler_get_color_sample(Sampler *sampler, math::Vector2i &pointer, math::Re
 	int height = bottom - top;
 	int center_x = x - left;
 	int center_y = y - top;
-	float max_distance = static_cast<float>(1 / std::sqrt(2 * std::pow((double)sampler->oversample, 2)));
+	const std::vector<float> &kernel = getKernel(sampler);
+	int size = 2 * sampler->oversample + 1;
+	int first_x = math::max(-sampler->oversample, -center_x), last_x = math::min(sampler->oversample, width - 1 - center_x);
+	int first_y = math::max(-sampler->oversample, -center_y), last_y = math::min(sampler->oversample, height - 1 - center_y);
 	unsigned char *data = cairo_image_surface_get_data(surface);
 	int stride = cairo_image_surface_get_stride(surface);
-	for (int x = -sampler->oversample; x <= sampler->oversample; ++x) {
-		for (int y = -sampler->oversample; y <= sampler->oversample; ++y) {
-			if ((center_x + x < 0) || (center_y + y < 0)) continue;
-			if ((center_x + x >= width) || (center_y + y >= height)) continue;
-			getPixel(data, stride, offset.x + center_x + x, offset.y + center_y + y, &sample);
-			float f;
-			if (sampler->oversample) {
-				f = sampler->falloff_fnc(static_cast<float>(std::sqrt((double)(x * x + y * y)) * max_distance));
-			} else {
-				f = 1;
-			}
-			result += sample * f;
-			divider += f;
-		}
+	float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int y = first_y; y <= last_y; ++y) {
+		const float *weights = &kernel[(y + sampler->oversample) * size + first_x + sampler->oversample];
+		const unsigned char *pixels = data + (offset.y + center_y + y) * stride + (offset.x + center_x + first_x) * 4;
+		divider += addRow(pixels, weights, last_x - first_x + 1, sum);
+	}
+	if (divider > 0) {
+		float scale = 1 / (255.0f * divider);
+		result.rgb.red = sum[2] * scale;
+		result.rgb.green = sum[1] * scale;
+		result.rgb.blue = sum[0] * scale;
 	}
-	if (divider > 0)
-		result *= 1 / divider;
 	result.alpha = 1;
 	*color = result;
 	return 0;
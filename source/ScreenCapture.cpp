@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ScreenCapture.h"
+#include <iostream>
+namespace {
+struct CairoScreenCapture: IScreenCapture {
+	CairoScreenCapture(GdkScreen *screen):
+		m_screen(screen) {
+	}
+	virtual bool capture(const math::Rectanglei &area, cairo_surface_t *surface, bool &changed) override {
+		changed = true;
+		int left = area.getX();
+		int top = area.getY();
+		int width = area.getWidth();
+		int height = area.getHeight();
+		GdkWindow *rootWindow = gdk_screen_get_root_window(m_screen);
+		cairo_t *rootCairo = gdk_cairo_create(rootWindow);
+		cairo_surface_t *rootSurface = cairo_get_target(rootCairo);
+		if (cairo_surface_status(rootSurface) != CAIRO_STATUS_SUCCESS) {
+			std::cerr << "can not get root window surface" << std::endl;
+			cairo_destroy(rootCairo);
+			return false;
+		}
+		cairo_surface_mark_dirty_rectangle(rootSurface, left, top, width, height);
+		cairo_t *cr = cairo_create(surface);
+		cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+		cairo_set_source_surface(cr, rootSurface, -left, -top);
+		cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_NEAREST);
+		cairo_rectangle(cr, 0, 0, width, height);
+		cairo_fill(cr);
+		cairo_destroy(cr);
+		cairo_destroy(rootCairo);
+		return true;
+	}
+	virtual void invalidate() override {
+	}
+private:
+	GdkScreen *m_screen;
+};
+}
+std::unique_ptr<IScreenCapture> createCairoScreenCapture(GdkScreen *screen) {
+	return std::make_unique<CairoScreenCapture>(screen);
+}
+std::unique_ptr<IScreenCapture> createScreenCapture(GdkScreen *screen) {
+	if (auto capture = createXShmScreenCapture(screen))
+		return capture;
+	return createCairoScreenCapture(screen);
+}
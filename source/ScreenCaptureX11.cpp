@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ScreenCapture.h"
+#include <gtk/gtk.h>
+#if defined(GPICK_XSHM_CAPTURE) && defined(GDK_WINDOWING_X11)
+#include <gdk/gdkx.h>
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <X11/extensions/Xdamage.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+namespace {
+void pushErrorTrap() {
+	gdk_error_trap_push();
+}
+bool popErrorTrap(bool sync) {
+#if GTK_MAJOR_VERSION >= 3
+	if (!sync) {
+		gdk_error_trap_pop_ignored();
+		return true;
+	}
+#endif
+	return gdk_error_trap_pop() == 0;
+}
+bool isLittleEndian() {
+	uint32_t value = 1;
+	return *reinterpret_cast<uint8_t *>(&value) == 1;
+}
+struct XShmScreenCapture: IScreenCapture {
+	XShmScreenCapture(Display *display, Window root, Visual *visual, int depth, int damageEventBase):
+		m_display(display),
+		m_root(root),
+		m_visual(visual),
+		m_depth(depth),
+		m_damageEventBase(damageEventBase),
+		m_damage(0),
+		m_image(nullptr),
+		m_capacity(0),
+		m_attached(false),
+		m_valid(false) {
+		m_shmInfo.shmid = -1;
+		m_shmInfo.shmaddr = nullptr;
+	}
+	virtual ~XShmScreenCapture() {
+		if (m_damage) {
+			gdk_window_remove_filter(nullptr, onEvent, this);
+			XDamageDestroy(m_display, m_damage);
+		}
+		destroyImage();
+	}
+	bool initialize() {
+		if (!createImage(initialSize, initialSize))
+			return false;
+		if (m_image->bits_per_pixel != 32 || m_image->red_mask != 0xff0000 || m_image->green_mask != 0xff00 || m_image->blue_mask != 0xff)
+			return false;
+		if ((m_image->byte_order == LSBFirst) != isLittleEndian())
+			return false;
+		pushErrorTrap();
+		m_damage = XDamageCreate(m_display, m_root, XDamageReportBoundingBox);
+		if (!popErrorTrap(true)) {
+			m_damage = 0;
+			return false;
+		}
+		gdk_window_add_filter(nullptr, onEvent, this);
+		return true;
+	}
+	virtual bool capture(const math::Rectanglei &area, cairo_surface_t *surface, bool &changed) override {
+		changed = false;
+		int width = area.getWidth(), height = area.getHeight();
+		if (width <= 0 || height <= 0)
+			return true;
+		if (width * height > m_capacity) {
+			destroyImage();
+			int size = (std::max(width, height) / initialSize + 1) * initialSize;
+			if (!createImage(size, size))
+				return false;
+			m_valid = false;
+		}
+		math::Rectanglei dirty;
+		if (!m_valid || area != m_area) {
+			dirty = area;
+		} else {
+			dirty = m_damaged.intersection(area);
+			if (dirty.isEmpty())
+				return true;
+		}
+		// Damage is reset before reading, so that changes made during the read are reported again.
+		XDamageSubtract(m_display, m_damage, None, None);
+		m_damaged = math::Rectanglei();
+		bool result;
+		pushErrorTrap();
+		if (dirty == area) {
+			// Shared memory image is reused for smaller areas by shrinking its dimensions.
+			m_image->width = width;
+			m_image->height = height;
+			m_image->bytes_per_line = width * 4;
+			result = XShmGetImage(m_display, m_root, m_image, area.getX(), area.getY(), AllPlanes);
+		} else {
+			result = XGetSubImage(m_display, m_root, dirty.getX(), dirty.getY(), dirty.getWidth(), dirty.getHeight(), AllPlanes, ZPixmap, m_image, dirty.getX() - area.getX(), dirty.getY() - area.getY()) != nullptr;
+		}
+		if (!popErrorTrap(false) || !result) {
+			m_valid = false;
+			return false;
+		}
+		copyToSurface(dirty.getX() - area.getX(), dirty.getY() - area.getY(), dirty.getWidth(), dirty.getHeight(), surface);
+		changed = true;
+		m_area = area;
+		m_valid = true;
+		return true;
+	}
+	virtual void invalidate() override {
+		m_valid = false;
+	}
+private:
+	static const int initialSize = 150;
+	Display *m_display;
+	Window m_root;
+	Visual *m_visual;
+	int m_depth, m_damageEventBase;
+	Damage m_damage;
+	XImage *m_image;
+	XShmSegmentInfo m_shmInfo;
+	int m_capacity;
+	bool m_attached, m_valid;
+	math::Rectanglei m_area, m_damaged;
+	bool createImage(int width, int height) {
+		m_image = XShmCreateImage(m_display, m_visual, m_depth, ZPixmap, nullptr, &m_shmInfo, width, height);
+		if (!m_image)
+			return false;
+		m_shmInfo.shmid = shmget(IPC_PRIVATE, m_image->bytes_per_line * m_image->height, IPC_CREAT | 0600);
+		if (m_shmInfo.shmid < 0)
+			return false;
+		m_shmInfo.shmaddr = m_image->data = reinterpret_cast<char *>(shmat(m_shmInfo.shmid, nullptr, 0));
+		if (m_shmInfo.shmaddr == reinterpret_cast<char *>(-1)) {
+			m_shmInfo.shmaddr = m_image->data = nullptr;
+			shmctl(m_shmInfo.shmid, IPC_RMID, nullptr);
+			return false;
+		}
+		m_shmInfo.readOnly = False;
+		pushErrorTrap();
+		XShmAttach(m_display, &m_shmInfo);
+		m_attached = popErrorTrap(true);
+		// Segment is removed when both processes detach from it.
+		shmctl(m_shmInfo.shmid, IPC_RMID, nullptr);
+		m_capacity = width * height;
+		return m_attached;
+	}
+	void destroyImage() {
+		if (m_attached)
+			XShmDetach(m_display, &m_shmInfo);
+		if (m_shmInfo.shmaddr)
+			shmdt(m_shmInfo.shmaddr);
+		if (m_image) {
+			m_image->data = nullptr;
+			XDestroyImage(m_image);
+		}
+		m_image = nullptr;
+		m_shmInfo.shmid = -1;
+		m_shmInfo.shmaddr = nullptr;
+		m_attached = false;
+		m_capacity = 0;
+	}
+	void copyToSurface(int x, int y, int width, int height, cairo_surface_t *surface) {
+		cairo_surface_flush(surface);
+		uint8_t *data = cairo_image_surface_get_data(surface);
+		int stride = cairo_image_surface_get_stride(surface);
+		for (int row = y; row < y + height; ++row) {
+			const auto *source = reinterpret_cast<const uint32_t *>(m_image->data + row * m_image->bytes_per_line) + x;
+			auto *target = reinterpret_cast<uint32_t *>(data + row * stride) + x;
+			// Root window has no alpha channel, so padding byte is replaced with opaque alpha.
+			for (int i = 0; i < width; ++i)
+				target[i] = source[i] | 0xff000000;
+		}
+		cairo_surface_mark_dirty_rectangle(surface, x, y, width, height);
+	}
+	static GdkFilterReturn onEvent(GdkXEvent *xevent, GdkEvent *, gpointer data) {
+		auto &capture = *reinterpret_cast<XShmScreenCapture *>(data);
+		auto *event = reinterpret_cast<XEvent *>(xevent);
+		if (event->type != capture.m_damageEventBase + XDamageNotify)
+			return GDK_FILTER_CONTINUE;
+		auto *notify = reinterpret_cast<XDamageNotifyEvent *>(event);
+		if (notify->damage != capture.m_damage)
+			return GDK_FILTER_CONTINUE;
+		capture.m_damaged += math::Rectanglei(notify->area.x, notify->area.y, notify->area.x + notify->area.width, notify->area.y + notify->area.height);
+		return GDK_FILTER_REMOVE;
+	}
+};
+}
+std::unique_ptr<IScreenCapture> createXShmScreenCapture(GdkScreen *screen) {
+	GdkDisplay *gdkDisplay = gdk_screen_get_display(screen);
+#if GTK_MAJOR_VERSION >= 3
+	if (!GDK_IS_X11_DISPLAY(gdkDisplay))
+		return nullptr;
+#endif
+	Display *display = GDK_DISPLAY_XDISPLAY(gdkDisplay);
+	int eventBase, errorBase;
+	if (!XShmQueryExtension(display) || !XDamageQueryExtension(display, &eventBase, &errorBase))
+		return nullptr;
+	int screenNumber = GDK_SCREEN_XNUMBER(screen);
+	auto capture = std::make_unique<XShmScreenCapture>(display, RootWindow(display, screenNumber), DefaultVisual(display, screenNumber), DefaultDepth(display, screenNumber), eventBase);
+	if (!capture->initialize())
+		return nullptr;
+	return capture;
+}
+#else
+std::unique_ptr<IScreenCapture> createXShmScreenCapture(GdkScreen *) {
+	return nullptr;
+}
+#endif
@@ -17,13 +17,15 @@
  */
 
 #include "ScreenReader.h"
+#include "ScreenCapture.h"
 #include <gtk/gtk.h>
 #include <algorithm>
-#include <iostream>
+#include <memory>
 struct ScreenReader {
 	cairo_surface_t *surface;
 	int maxSize;
-	GdkScreen *screen;
+	GdkScreen *screen, *captureScreen;
+	std::unique_ptr<IScreenCapture> capture;
 	math::Rectangle<int> readArea;
 };
 struct ScreenReader *screen_reader_new() {
@@ -31,9 +33,11 @@ struct ScreenReader *screen_reader_new() {
 	screen->maxSize = 0;
 	screen->surface = 0;
 	screen->screen = 0;
+	screen->captureScreen = 0;
 	return screen;
 }
 void screen_reader_destroy(ScreenReader *screen) {
+	screen->capture.reset();
 	if (screen->surface) cairo_surface_destroy(screen->surface);
 	delete screen;
 }
@@ -49,34 +53,32 @@ void screen_reader_reset_rect(ScreenReader *screen) {
 	screen->readArea = math::Rectangle<int>();
 	screen->screen = NULL;
 }
-void screen_reader_update_surface(ScreenReader *screen, math::Rectangle<int> *updateRect) {
-	if (!screen->screen) return;
-	int left = screen->readArea.getX();
-	int top = screen->readArea.getY();
+bool screen_reader_update_surface(ScreenReader *screen, math::Rectangle<int> *updateRect) {
+	if (!screen->screen) return false;
 	int width = screen->readArea.getWidth();
 	int height = screen->readArea.getHeight();
+	bool surfaceChanged = false;
 	if (width > screen->maxSize || height > screen->maxSize) {
 		if (screen->surface) cairo_surface_destroy(screen->surface);
+		surfaceChanged = true;
 		screen->maxSize = (std::max(width, height) / 150 + 1) * 150;
 		screen->surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, screen->maxSize, screen->maxSize);
 	}
-	GdkWindow *rootWindow = gdk_screen_get_root_window(screen->screen);
-	cairo_t *rootCairo = gdk_cairo_create(rootWindow);
-	cairo_surface_t *rootSurface = cairo_get_target(rootCairo);
-	if (cairo_surface_status(rootSurface) != CAIRO_STATUS_SUCCESS) {
-		std::cerr << "can not get root window surface" << std::endl;
-		return;
+	if (!screen->capture || screen->captureScreen != screen->screen) {
+		screen->capture = createScreenCapture(screen->screen);
+		screen->captureScreen = screen->screen;
 	}
-	cairo_surface_mark_dirty_rectangle(rootSurface, left, top, width, height);
-	cairo_t *cr = cairo_create(screen->surface);
-	cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
-	cairo_set_source_surface(cr, rootSurface, -left, -top);
-	cairo_pattern_set_filter(cairo_get_source(cr), CAIRO_FILTER_NEAREST);
-	cairo_rectangle(cr, 0, 0, width, height);
-	cairo_fill(cr);
-	cairo_destroy(cr);
-	cairo_destroy(rootCairo);
+	if (surfaceChanged)
+		screen->capture->invalidate();
+	bool changed;
+	if (!screen->capture->capture(screen->readArea, screen->surface, changed))
+		return false;
 	*updateRect = screen->readArea;
+	return changed;
+}
+void screen_reader_set_capture(ScreenReader *screen, std::unique_ptr<IScreenCapture> capture, GdkScreen *gdkScreen) {
+	screen->capture = std::move(capture);
+	screen->captureScreen = gdkScreen;
 }
 cairo_surface_t *screen_reader_get_surface(ScreenReader *screen) {
 	return screen->surface;
@@ -21,11 +21,18 @@
 #include <gdk/gdk.h>
 #include <cairo/cairo.h>
 #include "math/Rectangle.h"
+#include <memory>
 struct ScreenReader;
+struct IScreenCapture;
 ScreenReader *screen_reader_new();
 void screen_reader_reset_rect(ScreenReader *screen);
 void screen_reader_add_rect(ScreenReader *screen, GdkScreen *gdkScreen, math::Rectangle<int> &rect);
-void screen_reader_update_surface(ScreenReader *screen, math::Rectangle<int> *updateRect);
+/** Read added screen area into the surface.
+ * @return True if surface pixels might have changed since previous update.
+ */
+bool screen_reader_update_surface(ScreenReader *screen, math::Rectangle<int> *updateRect);
+/** Replace capture backend used for gdkScreen. By default the fastest available backend is created when screen is first read. */
+void screen_reader_set_capture(ScreenReader *screen, std::unique_ptr<IScreenCapture> capture, GdkScreen *gdkScreen);
 cairo_surface_t *screen_reader_get_surface(ScreenReader *screen);
 void screen_reader_destroy(ScreenReader *screen);
 #endif /* GPICK_SCREEN_READER_H_ */
@@ -256,23 +256,20 @@ static void onDragDataGet(GtkWidget *widget, GdkDragContext *context, GtkSelecti
 			gtk_selection_data_set(selectionData, gdk_atom_intern("application/x-color-object-list", false), 8, (const guchar *)"", 0);
 	} break;
 	case Target::string: {
-		std::stringstream ss;
-		ConverterSerializePosition position(state.colorObjects.size());
+		std::string text;
 		auto converter = state.gs.converters().firstCopy();
 		if (converter) {
-			for (size_t i = 0, count = state.colorObjects.size(); i < count; i++) {
-				if (position.index() + 1 == position.count())
-					position.last(true);
-				if (position.first()) {
-					ss << converter->serialize(state.colorObjects[i], position);
-					position.first(false);
-				} else {
-					ss << "\n" << converter->serialize(state.colorObjects[i], position);
-				}
-				position.incrementIndex();
+			std::vector<const ColorObject *> colorObjects;
+			colorObjects.reserve(state.colorObjects.size());
+			for (const auto &colorObject: state.colorObjects)
+				colorObjects.push_back(&colorObject);
+			auto lines = converter->serialize(colorObjects);
+			for (size_t i = 0; i < lines.size(); i++) {
+				if (i != 0)
+					text += '\n';
+				text += lines[i];
 			}
 		}
-		std::string text = ss.str();
 		gtk_selection_data_set_text(selectionData, text.c_str(), text.length());
 	} break;
 	case Target::color: {
@@ -62,4 +62,5 @@ auto operator~(Enum rhs) -> typename std::enable_if<common::EnableBitmaskOperato
 }
 using common::operator&;
 using common::operator|;
+using common::operator|=;
 using common::operator~;
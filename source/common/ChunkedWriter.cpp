@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ChunkedWriter.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+namespace common {
+ChunkedWriter::ChunkedWriter(size_t chunkSize, size_t threads):
+	m_chunkSize(std::max<size_t>(chunkSize, 1)),
+	m_threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+}
+size_t ChunkedWriter::chunkSize() const {
+	return m_chunkSize;
+}
+size_t ChunkedWriter::threads() const {
+	return m_threads;
+}
+namespace {
+struct ChunkFormatter {
+	ChunkFormatter(const std::ostream &stream, size_t count, size_t chunkSize, const ChunkedWriter::Format &format):
+		m_count(count),
+		m_chunkSize(chunkSize),
+		m_format(format) {
+		m_stream.flags(stream.flags());
+		m_stream.precision(stream.precision());
+		m_stream.fill(stream.fill());
+		m_stream.imbue(stream.getloc());
+	}
+	std::string operator()(size_t chunk) {
+		m_stream.str(std::string());
+		size_t end = std::min(m_count, (chunk + 1) * m_chunkSize);
+		for (size_t i = chunk * m_chunkSize; i < end; ++i)
+			m_format(i, m_stream);
+		return m_stream.str();
+	}
+private:
+	std::ostringstream m_stream;
+	size_t m_count, m_chunkSize;
+	const ChunkedWriter::Format &m_format;
+};
+}
+bool ChunkedWriter::write(std::ostream &stream, size_t count, const Format &format) const {
+	size_t chunks = (count + m_chunkSize - 1) / m_chunkSize;
+	size_t threadCount = std::min(m_threads, chunks);
+	if (threadCount <= 1) {
+		ChunkFormatter formatter(stream, count, m_chunkSize, format);
+		for (size_t chunk = 0; chunk < chunks; ++chunk) {
+			std::string data = formatter(chunk);
+			stream.write(data.data(), data.size());
+			if (!stream.good())
+				return false;
+		}
+		return stream.good();
+	}
+	// Chunk is formatted into slot "chunk % window" only after the chunk previously using that slot was written.
+	const size_t window = threadCount * 2;
+	std::vector<std::string> buffers(window);
+	std::vector<char> ready(window, 0);
+	std::mutex mutex;
+	std::condition_variable formatted, written;
+	size_t nextChunk = 0, writtenChunks = 0;
+	bool failed = false;
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back([&]() {
+			ChunkFormatter formatter(stream, count, m_chunkSize, format);
+			for (;;) {
+				size_t chunk;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					if (failed || nextChunk >= chunks)
+						return;
+					chunk = nextChunk++;
+					written.wait(lock, [&]() {
+						return failed || chunk < writtenChunks + window;
+					});
+					if (failed)
+						return;
+				}
+				std::string data = formatter(chunk);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					buffers[chunk % window] = std::move(data);
+					ready[chunk % window] = 1;
+				}
+				formatted.notify_one();
+			}
+		});
+	}
+	for (size_t chunk = 0; chunk < chunks; ++chunk) {
+		std::string data;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			formatted.wait(lock, [&]() {
+				return ready[chunk % window] != 0;
+			});
+			data = std::move(buffers[chunk % window]);
+			ready[chunk % window] = 0;
+		}
+		stream.write(data.data(), data.size());
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			writtenChunks = chunk + 1;
+			if (!stream.good())
+				failed = true;
+		}
+		written.notify_all();
+		if (failed)
+			break;
+	}
+	for (auto &thread: threads)
+		thread.join();
+	return !failed && stream.good();
+}
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <ostream>
+namespace common {
+/** Formats items in chunks and writes formatted chunks to a stream in item order.
+ * When more than one thread is used, chunks are formatted on worker threads while the calling thread writes already formatted chunks,
+ * so item formatting is overlapped with output. At most a few chunks per thread are kept in memory at once.
+ */
+struct ChunkedWriter {
+	/** Format one item into a chunk stream. Called concurrently from worker threads if thread count is larger than one. */
+	using Format = std::function<void(size_t index, std::ostream &stream)>;
+	/** Create writer.
+	 * @param[in] chunkSize Number of items in a chunk.
+	 * @param[in] threads Number of formatting threads, zero selects hardware concurrency.
+	 */
+	ChunkedWriter(size_t chunkSize = 4096, size_t threads = 0);
+	/** Format and write items.
+	 * Chunk streams copy format flags, precision and locale of the output stream.
+	 * @param[in,out] stream Output stream.
+	 * @param[in] count Number of items.
+	 * @param[in] format Item format function.
+	 * @return True if all chunks were written and stream is still good.
+	 */
+	bool write(std::ostream &stream, size_t count, const Format &format) const;
+	size_t chunkSize() const;
+	size_t threads() const;
+private:
+	size_t m_chunkSize, m_threads;
+};
+}
@@ -17,26 +17,19 @@
  */
 
 #include "Convert.h"
-#include <type_traits>
-#include <boost/spirit/include/qi.hpp>
-namespace qi = boost::spirit::qi;
+#include <charconv>
+#include <cstdint>
+#include <system_error>
 namespace common {
 template<typename T>
 std::optional<T> convertOptional(std::string_view value) {
+	// std::from_chars does not accept plus sign
+	if (value.length() > 1 && value[0] == '+' && value[1] != '-' && value[1] != '+')
+		value.remove_prefix(1);
 	T result = 0;
-	if constexpr (std::is_same_v<T, float>) {
-		if (!qi::parse(value.begin(), value.end(), qi::float_ >> qi::eoi, result))
-			return std::nullopt;
-	}else if constexpr (std::is_same_v<T, double>) {
-		if (!qi::parse(value.begin(), value.end(), qi::double_ >> qi::eoi, result))
-			return std::nullopt;
-	} else if constexpr (std::is_unsigned_v<T>) {
-		if (!qi::parse(value.begin(), value.end(), qi::ulong_ >> qi::eoi, result))
-			return std::nullopt;
-	} else {
-		if (!qi::parse(value.begin(), value.end(), qi::long_ >> qi::eoi, result))
-			return std::nullopt;
-	}
+	auto conversion = std::from_chars(value.data(), value.data() + value.length(), result);
+	if (conversion.ec != std::errc() || conversion.ptr != value.data() + value.length())
+		return std::nullopt;
 	return result;
 }
 template<typename T>
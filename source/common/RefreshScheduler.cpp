@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "RefreshScheduler.h"
+#include <algorithm>
+namespace common {
+namespace {
+RefreshScheduler::Duration toInterval(double rate) {
+	return RefreshScheduler::Duration(static_cast<RefreshScheduler::Duration::rep>(1000000 / std::max(rate, 0.1)));
+}
+}
+RefreshScheduler::RefreshScheduler(double activeRate, double idleRate, Duration idleDelay):
+	m_idleDelay(idleDelay),
+	m_wakeups(0),
+	m_windowWakeups(0),
+	m_wakeupsPerSecond(0),
+	m_started(false) {
+	setRates(activeRate, idleRate);
+	m_interval = m_activeInterval;
+}
+void RefreshScheduler::setRates(double activeRate, double idleRate) {
+	m_activeInterval = toInterval(activeRate);
+	m_idleInterval = std::max(toInterval(idleRate), m_activeInterval);
+	m_interval = std::clamp(m_interval, m_activeInterval, m_idleInterval);
+}
+RefreshScheduler::Duration RefreshScheduler::update(Clock::time_point now, bool changed) {
+	if (!m_started) {
+		m_started = true;
+		m_lastActivity = m_windowStart = now;
+	}
+	m_wakeups++;
+	m_windowWakeups++;
+	auto elapsed = std::chrono::duration<double>(now - m_windowStart).count();
+	if (elapsed >= 1.0) {
+		m_wakeupsPerSecond = m_windowWakeups / elapsed;
+		m_windowWakeups = 0;
+		m_windowStart = now;
+	}
+	if (changed) {
+		m_lastActivity = now;
+		m_interval = m_activeInterval;
+	} else if (now - m_lastActivity >= m_idleDelay) {
+		m_interval = std::min(m_interval * 2, m_idleInterval);
+	}
+	return m_interval;
+}
+bool RefreshScheduler::wake(Clock::time_point now) {
+	m_lastActivity = now;
+	bool backingOff = m_interval > m_activeInterval;
+	m_interval = m_activeInterval;
+	return backingOff;
+}
+RefreshScheduler::Duration RefreshScheduler::interval() const {
+	return m_interval;
+}
+uint64_t RefreshScheduler::wakeups() const {
+	return m_wakeups;
+}
+double RefreshScheduler::wakeupsPerSecond() const {
+	return m_wakeupsPerSecond;
+}
+}
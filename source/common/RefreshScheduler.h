@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+namespace common {
+/** Chooses interval between periodic updates. Runs at active rate while updates find changes, and after idle delay without changes gradually backs off to idle rate. */
+struct RefreshScheduler {
+	using Clock = std::chrono::steady_clock;
+	using Duration = std::chrono::microseconds;
+	/** Create scheduler.
+	 * @param[in] activeRate Updates per second while changes are found.
+	 * @param[in] idleRate Updates per second after a long period without changes.
+	 * @param[in] idleDelay Time without changes before backing off starts.
+	 */
+	RefreshScheduler(double activeRate, double idleRate, Duration idleDelay);
+	void setRates(double activeRate, double idleRate);
+	/** Record update result.
+	 * @param[in] now Update time.
+	 * @param[in] changed True if update found any change.
+	 * @return Interval until the next update.
+	 */
+	Duration update(Clock::time_point now, bool changed);
+	/** Record activity detected outside of updates, for example pointer motion event.
+	 * @param[in] now Activity time.
+	 * @return True if scheduler was backing off and the next update should run immediately.
+	 */
+	bool wake(Clock::time_point now);
+	Duration interval() const;
+	/** @return Total number of updates. */
+	uint64_t wakeups() const;
+	/** @return Updates per second measured over the last complete measurement window of at least one second. */
+	double wakeupsPerSecond() const;
+private:
+	Duration m_activeInterval, m_idleInterval, m_idleDelay, m_interval;
+	Clock::time_point m_lastActivity, m_windowStart;
+	uint64_t m_wakeups, m_windowWakeups;
+	double m_wakeupsPerSecond;
+	bool m_started;
+};
+}
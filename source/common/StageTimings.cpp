@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "StageTimings.h"
+#include <iomanip>
+#include <sstream>
+namespace common {
+StageTimings::Duration StageTimings::Stage::average() const {
+	if (count == 0)
+		return Duration::zero();
+	return total / count;
+}
+StageTimings::Scope::Scope(StageTimings &timings, size_t stage):
+	m_timings(timings),
+	m_stage(stage),
+	m_start(Clock::now()) {
+}
+StageTimings::Scope::~Scope() {
+	m_timings.add(m_stage, std::chrono::duration_cast<Duration>(Clock::now() - m_start));
+}
+StageTimings::StageTimings(std::initializer_list<const char *> names):
+	m_updates(0),
+	m_skipped(0) {
+	m_stages.reserve(names.size());
+	for (auto name: names)
+		m_stages.push_back(Stage { name, 0, Duration::zero(), Duration::zero(), Duration::zero() });
+}
+void StageTimings::add(size_t stage, Duration duration) {
+	auto &entry = m_stages[stage];
+	entry.count++;
+	entry.last = duration;
+	entry.total += duration;
+	if (duration > entry.max)
+		entry.max = duration;
+}
+void StageTimings::skip() {
+	m_skipped++;
+}
+void StageTimings::update() {
+	m_updates++;
+}
+void StageTimings::reset() {
+	for (auto &stage: m_stages) {
+		stage.count = 0;
+		stage.last = stage.total = stage.max = Duration::zero();
+	}
+	m_updates = m_skipped = 0;
+}
+size_t StageTimings::size() const {
+	return m_stages.size();
+}
+const StageTimings::Stage &StageTimings::operator[](size_t stage) const {
+	return m_stages[stage];
+}
+uint64_t StageTimings::updates() const {
+	return m_updates;
+}
+uint64_t StageTimings::skipped() const {
+	return m_skipped;
+}
+std::string StageTimings::format() const {
+	std::stringstream stream;
+	stream.imbue(std::locale::classic());
+	stream << std::fixed << std::setprecision(1);
+	for (const auto &stage: m_stages) {
+		stream << stage.name << ": " << std::chrono::duration<double, std::micro>(stage.last).count() << " us";
+		stream << " (avg " << std::chrono::duration<double, std::micro>(stage.average()).count() << " us)\n";
+	}
+	stream << "skipped: " << m_skipped << "/" << m_updates + m_skipped;
+	return stream.str();
+}
+}
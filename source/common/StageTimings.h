@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+namespace common {
+/** Accumulates durations of processing stages which run repeatedly, for example on every timer tick. */
+struct StageTimings {
+	using Clock = std::chrono::steady_clock;
+	using Duration = std::chrono::nanoseconds;
+	struct Stage {
+		const char *name;
+		uint64_t count;
+		Duration last, total, max;
+		/** @return Average stage duration or zero if stage was never measured. */
+		Duration average() const;
+	};
+	/** Measures time from construction until destruction and adds it to the stage. */
+	struct Scope {
+		Scope(StageTimings &timings, size_t stage);
+		~Scope();
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+	private:
+		StageTimings &m_timings;
+		size_t m_stage;
+		Clock::time_point m_start;
+	};
+	/** Create timings.
+	 * @param[in] names Stage names, string storage must outlive timings.
+	 */
+	StageTimings(std::initializer_list<const char *> names);
+	void add(size_t stage, Duration duration);
+	/** Count update which was skipped without running any stage. */
+	void skip();
+	/** Count update which ran some of the stages. */
+	void update();
+	void reset();
+	size_t size() const;
+	const Stage &operator[](size_t stage) const;
+	uint64_t updates() const;
+	uint64_t skipped() const;
+	/** @return One line per stage with last and average durations in microseconds, followed by skipped update count. */
+	std::string format() const;
+private:
+	std::vector<Stage> m_stages;
+	uint64_t m_updates, m_skipped;
+};
+}
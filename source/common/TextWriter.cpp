@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "TextWriter.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+namespace common {
+TextWriter::TextWriter(char *buffer, size_t size):
+	m_buffer(buffer),
+	m_size(size),
+	m_length(0),
+	m_truncated(false) {
+	m_buffer[0] = 0;
+}
+TextWriter &TextWriter::append(const char *value, size_t length) {
+	size_t available = m_size - 1 - m_length;
+	if (length > available) {
+		length = available;
+		m_truncated = true;
+	}
+	std::memcpy(m_buffer + m_length, value, length);
+	m_length += length;
+	m_buffer[m_length] = 0;
+	return *this;
+}
+TextWriter &TextWriter::operator<<(char value) {
+	return append(&value, 1);
+}
+TextWriter &TextWriter::operator<<(const char *value) {
+	return append(value, std::strlen(value));
+}
+TextWriter &TextWriter::operator<<(std::string_view value) {
+	return append(value.data(), value.length());
+}
+TextWriter &TextWriter::operator<<(int value) {
+	char result[16];
+	auto end = std::to_chars(result, result + sizeof(result), value).ptr;
+	return append(result, end - result);
+}
+TextWriter &TextWriter::fixed(float value, int precision) {
+	char result[64];
+	auto conversion = std::to_chars(result, result + sizeof(result), value, std::chars_format::fixed, precision);
+	if (conversion.ec != std::errc()) {
+		m_truncated = true;
+		return *this;
+	}
+	return append(result, conversion.ptr - result);
+}
+TextWriter &TextWriter::hex(uint32_t value, int digits, bool upperCase) {
+	const char *characters = upperCase ? "0123456789ABCDEF" : "0123456789abcdef";
+	char result[8];
+	int length = 0;
+	do {
+		result[7 - length++] = characters[value & 0xf];
+		value >>= 4;
+	} while (value != 0);
+	digits = std::min(digits, 8);
+	while (length < digits)
+		result[7 - length++] = '0';
+	return append(result + 8 - length, length);
+}
+std::string_view TextWriter::view() const {
+	return std::string_view(m_buffer, m_length);
+}
+size_t TextWriter::length() const {
+	return m_length;
+}
+bool TextWriter::truncated() const {
+	return m_truncated;
+}
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+namespace common {
+/** Appends text and numbers to a caller provided character buffer.
+ * Numbers are formatted with std::to_chars, so output does not depend on current locale and no memory is allocated.
+ * Text which does not fit is dropped like with snprintf, buffer contents are always null terminated.
+ */
+struct TextWriter {
+	/** Create writer.
+	 * @param[out] buffer Output buffer.
+	 * @param[in] size Buffer size including space for null terminator. Must be larger than zero.
+	 */
+	TextWriter(char *buffer, size_t size);
+	template<size_t N>
+	TextWriter(char (&buffer)[N]):
+		TextWriter(buffer, N) {
+	}
+	TextWriter &operator<<(char value);
+	TextWriter &operator<<(const char *value);
+	TextWriter &operator<<(std::string_view value);
+	TextWriter &operator<<(int value);
+	/** Append value with fixed number of fractional digits, same as "%0.*f" format. */
+	TextWriter &fixed(float value, int precision);
+	/** Append value as hexadecimal number padded with zeros to at least given number of digits, same as "%0*x" or "%0*X" format. */
+	TextWriter &hex(uint32_t value, int digits, bool upperCase);
+	std::string_view view() const;
+	size_t length() const;
+	/** @return True if some of the text did not fit into the buffer. */
+	bool truncated() const;
+private:
+	char *m_buffer;
+	size_t m_size, m_length;
+	bool m_truncated;
+	TextWriter &append(const char *value, size_t length);
+};
+}
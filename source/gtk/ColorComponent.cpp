@@ -21,7 +21,7 @@
 #include "Color.h"
 #include "Paths.h"
 #include <cmath>
-#include <vector>
+#include <cstring>
 
 enum {
 	COLOR_CHANGED,
@@ -29,7 +29,15 @@ enum {
 	LAST_SIGNAL
 };
 static constexpr size_t maxNumberOfChannels = 5;
+static constexpr int stripWidth = 200, stripHeight = 16, stripSteps = 100;
 static guint signals[LAST_SIGNAL] = {};
+//! Rendered channel gradient and color components it was rendered for.
+struct GradientStrip {
+	bool valid;
+	float components[4];
+	bool outOfGamut[stripSteps + 1];
+	int outOfGamutCount;
+};
 struct GtkColorComponentPrivate {
 	Color originalColor, color;
 	float alpha;
@@ -41,6 +49,8 @@ struct GtkColorComponentPrivate {
 	ReferenceObserver labObserver;
 	cairo_surface_t *patternSurface;
 	cairo_pattern_t *pattern;
+	cairo_surface_t *stripSurface;
+	GradientStrip strips[maxNumberOfChannels];
 	const char *label[maxNumberOfChannels][2];
 	gchar *text[maxNumberOfChannels];
 	double range[maxNumberOfChannels];
@@ -110,10 +120,17 @@ static void onFinalize(GObject *color_obj) {
 		cairo_surface_destroy(ns->patternSurface);
 	if (ns->pattern)
 		cairo_pattern_destroy(ns->pattern);
+	if (ns->stripSurface)
+		cairo_surface_destroy(ns->stripSurface);
 	gpointer parent_class = g_type_class_peek_parent(G_OBJECT_CLASS(GTK_COLOR_COMPONENT_GET_CLASS(color_obj)));
 	G_OBJECT_CLASS(parent_class)->finalize(color_obj);
 }
+static void invalidateStrips(GtkColorComponentPrivate *ns) {
+	for (size_t i = 0; i < maxNumberOfChannels; ++i)
+		ns->strips[i].valid = false;
+}
 static void setupForColorSpace(GtkColorComponentPrivate *ns, const ColorSpaceDescription &colorSpace) {
+	invalidateStrips(ns);
 	ns->colorSpace = colorSpace.type;
 	ns->channels = colorSpace.channelCount;
 	for (int i = 0; i < colorSpace.channelCount; ++i) {
@@ -134,6 +151,7 @@ GtkWidget *gtk_color_component_new(ColorSpace colorSpace) {
 	ns->labIlluminant = ReferenceIlluminant::D50;
 	ns->labObserver = ReferenceObserver::_2;
 	ns->outOfGamutMask = false;
+	ns->stripSurface = nullptr;
 #if GTK_MAJOR_VERSION >= 3
 	ns->pointerGrab = nullptr;
 #endif
@@ -230,10 +248,148 @@ void gtk_color_component_set_color(GtkColorComponent *colorComponent, const Colo
 	}
 	gtk_widget_queue_draw(GTK_WIDGET(colorComponent));
 }
-static void interpolateColors(Color *color1, Color *color2, float position, Color *result) {
-	result->rgb.red = color1->rgb.red * (1 - position) + color2->rgb.red * position;
-	result->rgb.green = color1->rgb.green * (1 - position) + color2->rgb.green * position;
-	result->rgb.blue = color1->rgb.blue * (1 - position) + color2->rgb.blue * position;
+static void interpolateColors(const Color &color1, const Color &color2, float position, Color &result) {
+	result.rgb.red = color1.rgb.red * (1 - position) + color2.rgb.red * position;
+	result.rgb.green = color1.rgb.green * (1 - position) + color2.rgb.green * position;
+	result.rgb.blue = color1.rgb.blue * (1 - position) + color2.rgb.blue * position;
+}
+/** Convert gradient sample points from component color space to RGB.
+ * Color space dependent setup, like reference white and chromatic adaptation matrix, is done once for all points.
+ * @param[in] ns Color component private data.
+ * @param[in,out] points Sample points.
+ * @param[in] count Number of sample points.
+ * @param[out] outOfGamut Out of RGB gamut flag for each sample point.
+ * @return True if out of gamut flags were calculated.
+ */
+static bool convertToRgb(GtkColorComponentPrivate *ns, Color *points, int count, bool *outOfGamut) {
+	switch (ns->colorSpace) {
+	case ColorSpace::rgb:
+		return false;
+	case ColorSpace::hsv:
+		for (int i = 0; i < count; ++i)
+			points[i] = points[i].hsvToRgb();
+		return false;
+	case ColorSpace::hsl:
+		for (int i = 0; i < count; ++i)
+			points[i] = points[i].hslToRgb();
+		return false;
+	case ColorSpace::cmyk:
+		for (int i = 0; i < count; ++i)
+			points[i] = points[i].cmykToRgb();
+		return false;
+	case ColorSpace::lab: {
+		auto &reference = Color::getReference(ns->labIlluminant, ns->labObserver);
+		auto adaptationMatrix = Color::getChromaticAdaptationMatrix(reference, Color::getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
+		for (int i = 0; i < count; ++i)
+			points[i] = points[i].labToRgb(reference, Color::sRGBInvertedMatrix, adaptationMatrix);
+	} break;
+	case ColorSpace::lch: {
+		auto &reference = Color::getReference(ns->labIlluminant, ns->labObserver);
+		auto adaptationMatrix = Color::getChromaticAdaptationMatrix(reference, Color::getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
+		for (int i = 0; i < count; ++i)
+			points[i] = points[i].lchToRgb(reference, Color::sRGBInvertedMatrix, adaptationMatrix);
+	} break;
+	case ColorSpace::oklab:
+		for (int i = 0; i < count; ++i)
+			points[i] = points[i].oklabToRgb();
+		break;
+	case ColorSpace::oklch:
+		for (int i = 0; i < count; ++i)
+			points[i] = points[i].oklchToRgb();
+		break;
+	}
+	for (int i = 0; i < count; ++i) {
+		outOfGamut[i] = points[i].isOutOfRgbGamut();
+		points[i].normalizeRgbInplace();
+	}
+	return true;
+}
+/** Fill one channel strip with a gradient.
+ * When there are less sample points than pixels, colors between sample points are interpolated.
+ * @param[out] data First pixel of a strip.
+ * @param[in] stride Surface stride.
+ * @param[in] points RGB sample points.
+ * @param[in] steps Number of sample points minus one.
+ */
+static void fillStrip(unsigned char *data, int stride, const Color *points, int steps) {
+	unsigned char *pixel = data;
+	Color c;
+	double intPart;
+	for (int i = 0; i < stripWidth; ++i, pixel += 4) {
+		if (steps == stripWidth - 1) {
+			c = points[i];
+		} else {
+			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / stripWidth, &intPart));
+			int index = i * steps / stripWidth;
+			interpolateColors(points[index], points[index + 1], position, c);
+		}
+		pixel[2] = (unsigned char)(c.rgb.red * 255);
+		pixel[1] = (unsigned char)(c.rgb.green * 255);
+		pixel[0] = (unsigned char)(c.rgb.blue * 255);
+		pixel[3] = 0xff;
+	}
+	for (int y = 1; y < stripHeight - 1; ++y)
+		std::memcpy(data + stride * y, data, stripWidth * 4);
+	std::memset(data + stride * (stripHeight - 1), 0, stripWidth * 4);
+}
+/** Render channel strips which were not rendered yet or were rendered for different color components.
+ * Strip of a channel depends only on all other color components, so changing one component re-renders all strips except its own.
+ * @param[in] ns Color component private data.
+ */
+static void updateStrips(GtkColorComponentPrivate *ns) {
+	if (ns->stripSurface && cairo_image_surface_get_height(ns->stripSurface) != ns->channels * stripHeight) {
+		cairo_surface_destroy(ns->stripSurface);
+		ns->stripSurface = nullptr;
+	}
+	if (!ns->stripSurface) {
+		ns->stripSurface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, stripWidth, ns->channels * stripHeight);
+		invalidateStrips(ns);
+	}
+	cairo_surface_flush(ns->stripSurface);
+	unsigned char *data = cairo_image_surface_get_data(ns->stripSurface);
+	int stride = cairo_image_surface_get_stride(ns->stripSurface);
+	int colorChannels = ns->channels - 1;
+	Color points[stripWidth];
+	for (int j = 0; j < ns->channels; ++j) {
+		GradientStrip &strip = ns->strips[j];
+		if (strip.valid) {
+			// Alpha strip is the same gray gradient for all colors.
+			bool changed = false;
+			for (int k = 0; k < colorChannels && j != colorChannels; ++k) {
+				if (k != j && strip.components[k] != ns->color[k]) {
+					changed = true;
+					break;
+				}
+			}
+			if (!changed)
+				continue;
+		}
+		unsigned char *stripData = data + stride * stripHeight * j;
+		strip.outOfGamutCount = 0;
+		if (j == colorChannels) {
+			for (int i = 0; i < stripWidth; ++i)
+				points[i].rgb.red = points[i].rgb.green = points[i].rgb.blue = (float)i / (float)(stripWidth - 1);
+			fillStrip(stripData, stride, points, stripWidth - 1);
+		} else if (ns->colorSpace == ColorSpace::rgb) {
+			for (int i = 0; i < stripWidth; ++i) {
+				points[i] = ns->color;
+				points[i][j] = (float)i / (float)(stripWidth - 1);
+			}
+			fillStrip(stripData, stride, points, stripWidth - 1);
+		} else {
+			for (int i = 0; i <= stripSteps; ++i) {
+				points[i] = ns->color;
+				points[i][j] = static_cast<float>((i / static_cast<float>(stripSteps)) * ns->range[j] + ns->offset[j]);
+			}
+			if (convertToRgb(ns, points, stripSteps + 1, strip.outOfGamut))
+				strip.outOfGamutCount = stripSteps + 1;
+			fillStrip(stripData, stride, points, stripSteps);
+		}
+		for (int k = 0; k < colorChannels; ++k)
+			strip.components[k] = ns->color[k];
+		strip.valid = true;
+		cairo_surface_mark_dirty_rectangle(ns->stripSurface, 0, stripHeight * j, stripWidth, stripHeight);
+	}
 }
 #if GTK_MAJOR_VERSION >= 3
 #else
@@ -254,349 +410,47 @@ static int get_x_offset(GtkWidget *widget) {
 }
 static gboolean onDraw(GtkWidget *widget, cairo_t *cr) {
 	GtkColorComponentPrivate *ns = GET_PRIVATE(widget);
-	Color c[maxNumberOfChannels];
 	double pointer_pos[maxNumberOfChannels];
-	int steps;
-	int i, j;
 	for (int i = 0; i < ns->channels; ++i) {
 		if (i < 4)
 			pointer_pos[i] = (ns->color[i] - ns->offset[i]) / ns->range[i];
 		else
 			pointer_pos[i] = (ns->alpha - ns->offset[i]) / ns->range[i];
 	}
-	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 200, ns->channels * 16);
-	unsigned char *data = cairo_image_surface_get_data(surface);
-	int stride = cairo_image_surface_get_stride(surface);
-	int surface_width = cairo_image_surface_get_width(surface);
-	unsigned char *col_ptr;
-	Color *rgb_points = new Color[ns->channels * 200];
-	double int_part;
-	math::Matrix3d adaptationMatrix;
-	std::vector<std::vector<bool>> out_of_gamut(maxNumberOfChannels, std::vector<bool>(false, 1));
-	switch (ns->colorSpace) {
-	case ColorSpace::rgb:
-		steps = 1;
-		for (i = 0; i < 3; ++i) {
-			c[i] = ns->color;
-		}
-		for (i = 0; i < surface_width; ++i) {
-			c[0].rgb.red = c[1].rgb.green = c[2].rgb.blue = (float)i / (float)(surface_width - 1);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::hsv:
-		steps = 100;
-		for (i = 0; i < 3; ++i) {
-			c[i] = ns->color;
-		}
-		for (i = 0; i <= steps; ++i) {
-			c[0].hsv.hue = c[1].hsv.saturation = c[2].hsv.value = i / static_cast<float>(steps);
-			for (j = 0; j < 3; ++j) {
-				rgb_points[j * (steps + 1) + i] = c[j].hsvToRgb();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::hsl:
-		steps = 100;
-		for (i = 0; i < 3; ++i) {
-			c[i] = ns->color;
-		}
-		for (i = 0; i <= steps; ++i) {
-			c[0].hsl.hue = c[1].hsl.saturation = c[2].hsl.lightness = i / static_cast<float>(steps);
-			for (j = 0; j < 3; ++j) {
-				rgb_points[j * (steps + 1) + i] = c[j].hslToRgb();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::cmyk:
-		steps = 100;
-		for (i = 0; i < 4; ++i) {
-			c[i] = ns->color;
-		}
-		for (i = 0; i <= steps; ++i) {
-			c[0].cmyk.c = c[1].cmyk.m = c[2].cmyk.y = c[3].cmyk.k = i / static_cast<float>(steps);
-			for (j = 0; j < 4; ++j) {
-				rgb_points[j * (steps + 1) + i] = c[j].cmykToRgb();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			interpolateColors(&rgb_points[3 * (steps + 1) + index], &rgb_points[3 * (steps + 1) + index + 1], position, &c[3]);
-			c[4].rgb.red = c[4].rgb.green = c[4].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::lab:
-		steps = 100;
-		adaptationMatrix = Color::getChromaticAdaptationMatrix(Color::getReference(ns->labIlluminant, ns->labObserver), Color::getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
-		for (j = 0; j < 3; ++j) {
-			c[j] = ns->color;
-			out_of_gamut[j] = std::vector<bool>(steps + 1, false);
-			for (i = 0; i <= steps; ++i) {
-				c[j][j] = static_cast<float>((i / static_cast<float>(steps)) * ns->range[j] + ns->offset[j]);
-				rgb_points[j * (steps + 1) + i] = c[j].labToRgb(Color::getReference(ns->labIlluminant, ns->labObserver), Color::sRGBInvertedMatrix, adaptationMatrix);
-				if (rgb_points[j * (steps + 1) + i].isOutOfRgbGamut()) {
-					out_of_gamut[j][i] = true;
-				}
-				rgb_points[j * (steps + 1) + i].normalizeRgbInplace();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::lch:
-		steps = 100;
-		adaptationMatrix = Color::getChromaticAdaptationMatrix(Color::getReference(ns->labIlluminant, ns->labObserver), Color::getReference(ReferenceIlluminant::D65, ReferenceObserver::_2));
-		for (j = 0; j < 3; ++j) {
-			c[j] = ns->color;
-			out_of_gamut[j] = std::vector<bool>(steps + 1, false);
-			for (i = 0; i <= steps; ++i) {
-				c[j][j] = static_cast<float>((i / static_cast<float>(steps)) * ns->range[j] + ns->offset[j]);
-				rgb_points[j * (steps + 1) + i] = c[j].lchToRgb(Color::getReference(ns->labIlluminant, ns->labObserver), Color::sRGBInvertedMatrix, adaptationMatrix);
-				if (rgb_points[j * (steps + 1) + i].isOutOfRgbGamut()) {
-					out_of_gamut[j][i] = true;
-				}
-				rgb_points[j * (steps + 1) + i].normalizeRgbInplace();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::oklab:
-		steps = 100;
-		for (j = 0; j < 3; ++j) {
-			c[j] = ns->color;
-			out_of_gamut[j] = std::vector<bool>(steps + 1, false);
-			for (i = 0; i <= steps; ++i) {
-				c[j][j] = static_cast<float>((i / static_cast<float>(steps)) * ns->range[j] + ns->offset[j]);
-				rgb_points[j * (steps + 1) + i] = c[j].oklabToRgb();
-				if (rgb_points[j * (steps + 1) + i].isOutOfRgbGamut()) {
-					out_of_gamut[j][i] = true;
-				}
-				rgb_points[j * (steps + 1) + i].normalizeRgbInplace();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	case ColorSpace::oklch:
-		steps = 100;
-		for (j = 0; j < 3; ++j) {
-			c[j] = ns->color;
-			out_of_gamut[j] = std::vector<bool>(steps + 1, false);
-			for (i = 0; i <= steps; ++i) {
-				c[j][j] = static_cast<float>((i / static_cast<float>(steps)) * ns->range[j] + ns->offset[j]);
-				rgb_points[j * (steps + 1) + i] = c[j].oklchToRgb();
-				if (rgb_points[j * (steps + 1) + i].isOutOfRgbGamut()) {
-					out_of_gamut[j][i] = true;
-				}
-				rgb_points[j * (steps + 1) + i].normalizeRgbInplace();
-			}
-		}
-		for (i = 0; i < surface_width; ++i) {
-			float position = static_cast<float>(std::modf(i * static_cast<float>(steps) / surface_width, &int_part));
-			int index = i * steps / surface_width;
-			interpolateColors(&rgb_points[0 * (steps + 1) + index], &rgb_points[0 * (steps + 1) + index + 1], position, &c[0]);
-			interpolateColors(&rgb_points[1 * (steps + 1) + index], &rgb_points[1 * (steps + 1) + index + 1], position, &c[1]);
-			interpolateColors(&rgb_points[2 * (steps + 1) + index], &rgb_points[2 * (steps + 1) + index + 1], position, &c[2]);
-			c[3].rgb.red = c[3].rgb.green = c[3].rgb.blue = (float)i / (float)(surface_width - 1);
-			col_ptr = data + i * 4;
-			for (int y = 0; y < ns->channels * 16; ++y) {
-				if ((y & 0x0f) != 0x0f) {
-					col_ptr[2] = (unsigned char)(c[y / 16].rgb.red * 255);
-					col_ptr[1] = (unsigned char)(c[y / 16].rgb.green * 255);
-					col_ptr[0] = (unsigned char)(c[y / 16].rgb.blue * 255);
-					col_ptr[3] = 0xff;
-				} else {
-					col_ptr[0] = 0x00;
-					col_ptr[1] = 0x00;
-					col_ptr[2] = 0x00;
-					col_ptr[3] = 0x00;
-				}
-				col_ptr += stride;
-			}
-		}
-		break;
-	default:
-		break;
-	}
-	delete[] rgb_points;
-	cairo_surface_mark_dirty(surface);
+	updateStrips(ns);
 	cairo_save(cr);
 	int offset_x = get_x_offset(widget);
-	cairo_set_source_surface(cr, surface, offset_x, 0);
-	cairo_surface_destroy(surface);
-	for (i = 0; i < ns->channels; ++i) {
+	cairo_set_source_surface(cr, ns->stripSurface, offset_x, 0);
+	for (int i = 0; i < ns->channels; ++i) {
 		cairo_rectangle(cr, offset_x, 16 * i, 200, 15);
 		cairo_fill(cr);
 	}
 	cairo_restore(cr);
-	for (i = 0; i < ns->channels; ++i) {
+	for (int i = 0; i < ns->channels; ++i) {
 		cairo_matrix_t matrix;
 		cairo_matrix_init_translate(&matrix, -offset_x - 64, -64 + 5 * i);
 		cairo_pattern_set_matrix(ns->pattern, &matrix);
 		if (ns->outOfGamutMask) {
 			int first_out_of_gamut = 0;
 			bool out_of_gamut_found = false;
+			const GradientStrip &strip = ns->strips[i];
 			cairo_set_source(cr, ns->pattern);
-			for (size_t j = 0; j < out_of_gamut[i].size(); j++) {
-				if (out_of_gamut[i][j]) {
+			for (int j = 0; j < strip.outOfGamutCount; j++) {
+				if (strip.outOfGamut[j]) {
 					if (!out_of_gamut_found) {
 						out_of_gamut_found = true;
 						first_out_of_gamut = j;
 					}
 				} else {
 					if (out_of_gamut_found) {
-						cairo_rectangle(cr, offset_x + (first_out_of_gamut * 200.0 / out_of_gamut[i].size()), 16 * i, (j - first_out_of_gamut) * 200.0 / out_of_gamut[i].size(), 15);
+						cairo_rectangle(cr, offset_x + (first_out_of_gamut * 200.0 / strip.outOfGamutCount), 16 * i, (j - first_out_of_gamut) * 200.0 / strip.outOfGamutCount, 15);
 						cairo_fill(cr);
 						out_of_gamut_found = false;
 					}
 				}
 			}
 			if (out_of_gamut_found) {
-				cairo_rectangle(cr, offset_x + (first_out_of_gamut * 200.0 / out_of_gamut[i].size()), 16 * i, (out_of_gamut[i].size() - first_out_of_gamut) * 200.0 / out_of_gamut[i].size(), 15);
+				cairo_rectangle(cr, offset_x + (first_out_of_gamut * 200.0 / strip.outOfGamutCount), 16 * i, (strip.outOfGamutCount - first_out_of_gamut) * 200.0 / strip.outOfGamutCount, 15);
 				cairo_fill(cr);
 			}
 		}
@@ -803,12 +657,14 @@ static gboolean onMotionNotify(GtkWidget *widget, GdkEventMotion *event) {
 void gtk_color_component_set_lab_illuminant(GtkColorComponent *colorComponent, ReferenceIlluminant illuminant) {
 	GtkColorComponentPrivate *ns = GET_PRIVATE(colorComponent);
 	ns->labIlluminant = illuminant;
+	invalidateStrips(ns);
 	gtk_color_component_set_color(colorComponent, ns->originalColor);
 	gtk_widget_queue_draw(GTK_WIDGET(colorComponent));
 }
 void gtk_color_component_set_lab_observer(GtkColorComponent *colorComponent, ReferenceObserver observer) {
 	GtkColorComponentPrivate *ns = GET_PRIVATE(colorComponent);
 	ns->labObserver = observer;
+	invalidateStrips(ns);
 	gtk_color_component_set_color(colorComponent, ns->originalColor);
 	gtk_widget_queue_draw(GTK_WIDGET(colorComponent));
 }
@@ -29,6 +29,15 @@ struct ColorPoint {
 	double lightness;
 	double saturation;
 };
+//! Number of saturation/value blocks kept in cache, one for each color point.
+const int SatValBlockCacheSize = 10;
+//! Number of distinct hues saturation/value blocks are rendered at.
+const int HueSteps = 1024;
+struct SatValBlock {
+	cairo_surface_t *surface;
+	int hue;
+	uint32_t last_use;
+};
 struct GtkColorWheelPrivate {
 	ColorPoint cpoint[10];
 	uint32_t n_cpoint;
@@ -42,6 +51,10 @@ struct GtkColorWheelPrivate {
 	bool block_editable;
 	const ColorWheelType *color_wheel_type;
 	cairo_surface_t *cache_color_wheel;
+	float cache_radius, cache_circle_width;
+	SatValBlock cache_blocks[SatValBlockCacheSize];
+	int cache_block_size;
+	uint32_t cache_block_clock;
 #if GTK_MAJOR_VERSION >= 3
 	GdkDevice *pointer_grab;
 #endif
@@ -58,13 +71,27 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr);
 #else
 static gboolean expose(GtkWidget *color_wheel, GdkEventExpose *event);
 #endif
-static void finalize(GObject *color_wheel_obj)
+static void invalidate_block_cache(GtkColorWheelPrivate *ns)
+{
+	for (int i = 0; i < SatValBlockCacheSize; ++i){
+		if (ns->cache_blocks[i].surface){
+			cairo_surface_destroy(ns->cache_blocks[i].surface);
+			ns->cache_blocks[i].surface = nullptr;
+		}
+	}
+}
+static void invalidate_cache(GtkColorWheelPrivate *ns)
 {
-	GtkColorWheelPrivate *ns = GET_PRIVATE(color_wheel_obj);
 	if (ns->cache_color_wheel){
 		cairo_surface_destroy(ns->cache_color_wheel);
 		ns->cache_color_wheel = 0;
 	}
+	invalidate_block_cache(ns);
+}
+static void finalize(GObject *color_wheel_obj)
+{
+	GtkColorWheelPrivate *ns = GET_PRIVATE(color_wheel_obj);
+	invalidate_cache(ns);
 	G_OBJECT_CLASS(parent_class)->finalize(color_wheel_obj);
 }
 static void gtk_color_wheel_class_init(GtkColorWheelClass *color_wheel_class)
@@ -108,6 +135,14 @@ GtkWidget* gtk_color_wheel_new()
 	ns->block_editable = true;
 	ns->color_wheel_type = &color_wheel_types_get()[0];
 	ns->cache_color_wheel = 0;
+	ns->cache_radius = ns->cache_circle_width = 0;
+	for (int i = 0; i < SatValBlockCacheSize; ++i){
+		ns->cache_blocks[i].surface = nullptr;
+		ns->cache_blocks[i].hue = 0;
+		ns->cache_blocks[i].last_use = 0;
+	}
+	ns->cache_block_size = 0;
+	ns->cache_block_clock = 0;
 #if GTK_MAJOR_VERSION >= 3
 	ns->pointer_grab = nullptr;
 #endif
@@ -119,10 +154,7 @@ void gtk_color_wheel_set_color_wheel_type(GtkColorWheel *color_wheel, const Colo
 	GtkColorWheelPrivate *ns = GET_PRIVATE(color_wheel);
 	if (ns->color_wheel_type != color_wheel_type){
 		ns->color_wheel_type = color_wheel_type;
-		if (ns->cache_color_wheel){
-			cairo_surface_destroy(ns->cache_color_wheel);
-			ns->cache_color_wheel = 0;
-		}
+		invalidate_cache(ns);
 		gtk_widget_queue_draw(GTK_WIDGET(color_wheel));
 	}
 }
@@ -221,33 +253,99 @@ static void draw_dot(cairo_t *cr, double x, double y, double size)
 	cairo_set_line_width(cr, 1);
 	cairo_stroke(cr);
 }
-static void draw_sat_val_block(cairo_t *cr, double pos_x, double pos_y, double size, double hue)
+/** Fill one row of saturation/value block.
+ * Hue and value are constant along a row, so every channel is a linear function of saturation: channel = value * (1 - saturation * k).
+ * @param[out] row Destination pixels.
+ * @param[in] width Number of pixels in a row.
+ * @param[in] value Value of all pixels in a row.
+ * @param[in] step Saturation change between two neighbouring pixels.
+ * @param[in] k Red, green and blue channel saturation factors.
+ */
+static void fill_sat_val_row(uint32_t *row, int width, float value, float step, const float k[3])
 {
-	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(std::ceil(size)), static_cast<int>(std::ceil(size)));
+	const float value255 = value * 255;
+	const float kr = k[0] * step, kg = k[1] * step, kb = k[2] * step;
+	for (int x = 0; x < width; ++x){
+		float position = static_cast<float>(x);
+		uint32_t red = static_cast<uint32_t>(value255 * (1.0f - position * kr));
+		uint32_t green = static_cast<uint32_t>(value255 * (1.0f - position * kg));
+		uint32_t blue = static_cast<uint32_t>(value255 * (1.0f - position * kb));
+		row[x] = 0xff000000u | (red << 16) | (green << 8) | blue;
+	}
+}
+static void fill_sat_val_block(cairo_surface_t *surface, double size, float hue)
+{
+	float h = (hue - std::floor(hue)) * 6.0f;
+	int i = int(h);
+	float f = h - std::floor(h);
+	// Channel factors matching Color::hsvToRgb sectors: v -> 0, x -> 1, y -> f, z -> 1 - f.
+	float k[3];
+	switch (i){
+	case 0: k[0] = 0; k[1] = 1 - f; k[2] = 1; break;
+	case 1: k[0] = f; k[1] = 0; k[2] = 1; break;
+	case 2: k[0] = 1; k[1] = 0; k[2] = 1 - f; break;
+	case 3: k[0] = 1; k[1] = f; k[2] = 0; break;
+	case 4: k[0] = 1 - f; k[1] = 1; k[2] = 0; break;
+	default: k[0] = 0; k[1] = 1; k[2] = f;
+	}
 	unsigned char *data = cairo_image_surface_get_data(surface);
 	int stride = cairo_image_surface_get_stride(surface);
 	int surface_width = cairo_image_surface_get_width(surface);
 	int surface_height = cairo_image_surface_get_height(surface);
-	Color c;
-	uint8_t *line_data;
+	float step = static_cast<float>(1 / size);
 	for (int y = 0; y < surface_height; ++y){
-		line_data = data + stride * y;
-		for (int x = 0; x < surface_width; ++x){
-			c.hsv.hue = static_cast<float>(hue);
-			c.hsv.saturation = static_cast<float>(x / size);
-			c.hsv.value = static_cast<float>(y / size);
-			c = c.hsvToRgb();
-			line_data[2] = static_cast<uint8_t>(c.rgb.red * 255);
-			line_data[1] = static_cast<uint8_t>(c.rgb.green * 255);
-			line_data[0] = static_cast<uint8_t>(c.rgb.blue * 255);
-			line_data[3] = 0xFF;
-			line_data += 4;
-		}
+		fill_sat_val_row(reinterpret_cast<uint32_t *>(data + stride * y), surface_width, static_cast<float>(y / size), step, k);
 	}
 	cairo_surface_mark_dirty(surface);
+}
+/** Get saturation/value block for a hue, rendering it only when it is not in cache.
+ * Hue is quantized to HueSteps steps, least recently used block is replaced when cache is full.
+ * @param[in] ns Color wheel private data.
+ * @param[in] size Block size.
+ * @param[in] hue Block hue.
+ * @return Cached surface or nullptr if surface allocation failed.
+ */
+static cairo_surface_t *get_sat_val_block(GtkColorWheelPrivate *ns, double size, double hue)
+{
+	int pixel_size = static_cast<int>(std::ceil(size));
+	if (ns->cache_block_size != pixel_size){
+		invalidate_block_cache(ns);
+		ns->cache_block_size = pixel_size;
+	}
+	int quantized_hue = static_cast<int>(std::lround((hue - std::floor(hue)) * HueSteps)) % HueSteps;
+	SatValBlock *replace = &ns->cache_blocks[0];
+	for (int i = 0; i < SatValBlockCacheSize; ++i){
+		SatValBlock &block = ns->cache_blocks[i];
+		if (block.surface && block.hue == quantized_hue){
+			block.last_use = ++ns->cache_block_clock;
+			return block.surface;
+		}
+		if (!block.surface)
+			replace = &block;
+		else if (replace->surface && block.last_use < replace->last_use)
+			replace = &block;
+	}
+	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pixel_size, pixel_size);
+	if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS){
+		std::cerr << "ColorWheel image surface allocation failed" << std::endl;
+		cairo_surface_destroy(surface);
+		return nullptr;
+	}
+	fill_sat_val_block(surface, size, static_cast<float>(quantized_hue) / HueSteps);
+	if (replace->surface)
+		cairo_surface_destroy(replace->surface);
+	replace->surface = surface;
+	replace->hue = quantized_hue;
+	replace->last_use = ++ns->cache_block_clock;
+	return surface;
+}
+static void draw_sat_val_block(GtkColorWheelPrivate *ns, cairo_t *cr, double pos_x, double pos_y, double size, double hue)
+{
+	cairo_surface_t *surface = get_sat_val_block(ns, size, hue);
+	if (!surface)
+		return;
 	cairo_save(cr);
 	cairo_set_source_surface(cr, surface, pos_x - size / 2, pos_y - size / 2);
-	cairo_surface_destroy(surface);
 	cairo_rectangle(cr, pos_x - size / 2, pos_y - size / 2, size, size);
 	cairo_fill(cr);
 	cairo_restore(cr);
@@ -256,6 +354,10 @@ static void draw_wheel(GtkColorWheelPrivate *ns, cairo_t *cr, double radius, dou
 {
 	cairo_surface_t *surface;
 	double inner_radius = radius - width;
+	if (ns->cache_color_wheel && (ns->cache_radius != radius || ns->cache_circle_width != width)){
+		cairo_surface_destroy(ns->cache_color_wheel);
+		ns->cache_color_wheel = 0;
+	}
 	if (ns->cache_color_wheel){
 		surface = ns->cache_color_wheel;
 	}else{
@@ -290,9 +392,11 @@ static void draw_wheel(GtkColorWheelPrivate *ns, cairo_t *cr, double radius, dou
 				line_data += 4;
 			}
 		}
+		cairo_surface_mark_dirty(surface);
 		ns->cache_color_wheel = surface;
+		ns->cache_radius = static_cast<float>(radius);
+		ns->cache_circle_width = static_cast<float>(width);
 	}
-	cairo_surface_mark_dirty(surface);
 	cairo_save(cr);
 	cairo_set_source_surface(cr, surface, 0, 0);
 	cairo_set_line_width(cr, width);
@@ -376,7 +480,7 @@ static gboolean draw(GtkWidget *widget, cairo_t *cr)
 		double block_size = 2 * (ns->radius - ns->circle_width) * sin(math::PI / 4) - 6;
 		Color hsl;
 		ns->color_wheel_type->hue_to_hsl(ns->selected->hue, &hsl);
-		draw_sat_val_block(cr, ns->radius, ns->radius, block_size, hsl.hsl.hue);
+		draw_sat_val_block(ns, cr, ns->radius, ns->radius, block_size, hsl.hsl.hue);
 		draw_dot(cr, ns->radius - block_size / 2 + block_size * ns->selected->saturation, ns->radius - block_size / 2 + block_size * ns->selected->lightness, 4);
 	}
 	for (uint32_t i = 0; i != ns->n_cpoint; i++){
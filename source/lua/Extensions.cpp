@@ -51,10 +51,29 @@ static int addConverter(lua_State *L) {
 	const char *label = luaL_checkstring(L, 3);
 	checkArgumentIsFunctionOrNil(L, 4);
 	if (lua_gettop(L) >= 5) checkArgumentIsFunctionOrNil(L, 5);
-	if (lua_gettop(L) == 4)
-		getGlobalState(L).converters().add(new Converter(name, label, Ref(L, 4), Ref()));
-	else if (lua_gettop(L) >= 5)
-		getGlobalState(L).converters().add(new Converter(name, label, Ref(L, 4), Ref(L, 5)));
+	if (lua_gettop(L) >= 6 && !lua_isnil(L, 6)) luaL_checktype(L, 6, LUA_TTABLE);
+	if (lua_gettop(L) >= 7) checkArgumentIsFunctionOrNil(L, 7);
+	if (lua_gettop(L) < 4)
+		return 0;
+	// nil callbacks are stored as empty references, so hasSerialize/hasDeserialize and batch fallback see them as missing
+	auto converter = new Converter(name, label, lua_isfunction(L, 4) ? Ref(L, 4) : Ref(), lua_gettop(L) >= 5 && lua_isfunction(L, 5) ? Ref(L, 5) : Ref());
+	if (lua_gettop(L) >= 6 && lua_istable(L, 6)) {
+		// optional list of strings, at least one of which must appear in pasted text before deserialize callback is called
+		std::vector<std::string> prefixes;
+		size_t count = lua_rawlen(L, 6);
+		for (size_t i = 1; i <= count; i++) {
+			lua_rawgeti(L, 6, i);
+			size_t length;
+			const char *prefix = lua_tolstring(L, -1, &length);
+			if (prefix && length > 0)
+				prefixes.emplace_back(prefix, length);
+			lua_pop(L, 1);
+		}
+		converter->inputPrefixes(std::move(prefixes));
+	}
+	if (lua_gettop(L) >= 7 && lua_isfunction(L, 7))
+		converter->serializeBatch(Ref(L, 7)); // receives an array of color objects and returns an array of strings
+	getGlobalState(L).converters().add(converter);
 	return 0;
 }
 static int setOptionChangeCallback(lua_State *L) {
@@ -18,11 +18,37 @@
 
 #include "Script.h"
 #include "Lua.h"
+#include "common/Hash.h"
 #include <sstream>
 #include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
 using namespace std;
+namespace fs = std::filesystem;
 namespace lua
 {
+namespace
+{
+const char cacheMagic[8] = { 'G', 'P', 'I', 'C', 'K', 'L', 'U', 'A' };
+const uint32_t cacheVersion = 2;
+struct CacheHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t luaVersion;
+	uint64_t sourceSize;
+	int64_t sourceModified;
+	uint64_t bytecodeSize;
+	uint64_t bytecodeHash;
+};
+static_assert(sizeof(CacheHeader) == 48);
+}
 Script::Script()
 {
 	m_state = luaL_newstate();
@@ -125,6 +151,126 @@ bool Script::run(int arguments_on_stack, int results)
 		return false;
 	}
 }
+static int writeChunk(lua_State *, const void *data, size_t size, void *userData)
+{
+	reinterpret_cast<string*>(userData)->append(reinterpret_cast<const char*>(data), size);
+	return 0;
+}
+static int cachedSearcher(lua_State *L)
+{
+	auto &script = *reinterpret_cast<Script*>(lua_touserdata(L, lua_upvalueindex(1)));
+	const char *name = luaL_checkstring(L, 1);
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "searchpath");
+	lua_pushstring(L, name);
+	lua_getfield(L, -3, "path");
+	if (!lua_isstring(L, -1))
+		return luaL_error(L, "'package.path' must be a string");
+	lua_call(L, 2, 2);
+	const char *filename = lua_tostring(L, -2);
+	if (filename == nullptr)
+		return 1;
+	if (!script.loadFileCached(filename))
+		return luaL_error(L, "error loading module '%s' from file '%s':\n\t%s", name, filename, lua_tostring(L, -1));
+	lua_pushstring(L, filename);
+	return 2;
+}
+void Script::setCachePath(const std::string &path)
+{
+	lua_State *L = m_state;
+	bool installSearcher = m_cache_path.empty() && !path.empty();
+	m_cache_path = path;
+	if (!installSearcher)
+		return;
+	// replaces standard Lua file searcher, which is second after preload searcher
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "searchers");
+	if (lua_istable(L, -1)) {
+		lua_pushlightuserdata(L, this);
+		lua_pushcclosure(L, cachedSearcher, 1);
+		lua_rawseti(L, -2, 2);
+	}
+	lua_pop(L, 2);
+}
+bool Script::loadFileCached(const char *filename)
+{
+	lua_State *L = m_state;
+	if (m_cache_path.empty())
+		return luaL_loadfile(L, filename) == LUA_OK;
+	error_code ec;
+	auto sourceSize = fs::file_size(filename, ec);
+	if (ec)
+		return luaL_loadfile(L, filename) == LUA_OK;
+	auto sourceModified = fs::last_write_time(filename, ec);
+	if (ec)
+		return luaL_loadfile(L, filename) == LUA_OK;
+	stringstream cacheName;
+	cacheName << "lua-" << hex << setw(16) << setfill('0') << common::fnv1a(fs::absolute(filename, ec).string()) << ".luac";
+	auto cacheFilename = fs::path(m_cache_path) / cacheName.str();
+	CacheHeader header;
+	memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+	header.version = cacheVersion;
+	header.luaVersion = LUA_VERSION_NUM;
+	header.sourceSize = sourceSize;
+	header.sourceModified = static_cast<int64_t>(sourceModified.time_since_epoch().count());
+	header.bytecodeSize = 0;
+	header.bytecodeHash = 0;
+	string data;
+	{
+		ifstream file(cacheFilename, ios::in | ios::binary);
+		if (file.is_open())
+			data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	}
+	// Lua does not verify bytecode, so truncated or damaged cache files must be rejected before loading
+	CacheHeader cachedHeader;
+	if (data.size() > sizeof(CacheHeader)) {
+		memcpy(&cachedHeader, data.data(), sizeof(CacheHeader));
+		const char *bytecode = data.data() + sizeof(CacheHeader);
+		size_t bytecodeSize = data.size() - sizeof(CacheHeader);
+		if (memcmp(&cachedHeader, &header, offsetof(CacheHeader, bytecodeSize)) == 0 && cachedHeader.bytecodeSize == bytecodeSize && cachedHeader.bytecodeHash == common::fnv1a(bytecode, bytecodeSize)) {
+			string chunkName = string("@") + filename;
+			if (luaL_loadbufferx(L, bytecode, bytecodeSize, chunkName.c_str(), "b") == LUA_OK)
+				return true;
+			lua_pop(L, 1);
+		}
+	}
+	if (luaL_loadfile(L, filename) != LUA_OK)
+		return false;
+	string bytecode;
+#if LUA_VERSION_NUM >= 503
+	int status = lua_dump(L, writeChunk, &bytecode, 0);
+#else
+	int status = lua_dump(L, writeChunk, &bytecode);
+#endif
+	if (status != 0 || bytecode.empty())
+		return true;
+	fs::create_directories(m_cache_path, ec);
+	if (ec)
+		return true;
+	header.bytecodeSize = bytecode.size();
+	header.bytecodeHash = common::fnv1a(bytecode.data(), bytecode.size());
+	// unique temporary name, so that concurrently running instances do not write into the same file
+	stringstream temporarySuffix;
+	temporarySuffix << "." << hex << random_device {}() << ".tmp";
+	auto temporaryFilename = cacheFilename;
+	temporaryFilename += temporarySuffix.str();
+	{
+		ofstream file(temporaryFilename, ios::out | ios::binary | ios::trunc);
+		if (!file.is_open())
+			return true;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+		file.write(bytecode.data(), bytecode.size());
+		if (!file.good()) {
+			file.close();
+			fs::remove(temporaryFilename, ec);
+			return true;
+		}
+	}
+	fs::rename(temporaryFilename, cacheFilename, ec);
+	if (ec)
+		fs::remove(temporaryFilename, ec);
+	return true;
+}
 static int registerLuaPackage(lua_State *L)
 {
 	lua_getglobal(L, "__script");
@@ -32,6 +32,18 @@ struct Script
 	~Script();
 	operator lua_State*();
 	void setPaths(const std::vector<std::string> &include_paths);
+	/**
+	 * Enable caching of compiled modules.
+	 * Modules loaded with require are stored as bytecode in the given directory and reused while source file size and modification time do not change.
+	 * @param[in] path Cache directory.
+	 */
+	void setCachePath(const std::string &path);
+	/**
+	 * Compile file or load its cached bytecode, and push resulting chunk.
+	 * @param[in] filename Lua source file.
+	 * @return True on success, otherwise error message is pushed.
+	 */
+	bool loadFileCached(const char *filename);
 	bool load(const char *script_name);
 	bool loadCode(const char *script_code);
 	bool run(int arguments_on_stack, int results);
@@ -43,6 +55,7 @@ struct Script
 	lua_State *m_state;
 	bool m_state_owned;
 	std::string m_last_error;
+	std::string m_cache_path;
 };
 }
 #endif /* GPICK_LUA_SCRIPT_H_ */
@@ -22,10 +22,14 @@
 #include "uiApp.h"
 #include "I18N.h"
 #include "version/Version.h"
+#include "tools/ExtractPalette.h"
 #include <gtk/gtk.h>
 #include <string>
 #include <iostream>
 #include <clocale>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 using namespace std;
 
 static gchar **commandline_filename = nullptr;
@@ -37,6 +41,10 @@ static gboolean single_color_pick_mode = FALSE;
 static gboolean version_information = FALSE;
 static gboolean do_not_start = FALSE;
 static gchar *converter_name = nullptr;
+static gboolean extract_palette = FALSE;
+static gint extract_palette_colors = 8;
+static gchar *extract_palette_output = nullptr;
+static gint64 extract_palette_max_pixels = 0;
 static GOptionEntry commandline_entries[] =
 {
 	{"geometry", 'g', 0, G_OPTION_ARG_STRING, &commandline_geometry, "Window geometry", "GEOMETRY"},
@@ -47,12 +55,63 @@ static GOptionEntry commandline_entries[] =
 	{"no-start", 0, 0, G_OPTION_ARG_NONE, &do_not_start, "Do not start Gpick if it is not already running", nullptr},
 	{"converter-name", 'c', 0, G_OPTION_ARG_STRING, &converter_name, "Converter name used for floating picker mode", nullptr},
 	{"version", 'v', 0, G_OPTION_ARG_NONE, &version_information, "Print version information", nullptr},
+	{"extract-palette", 0, 0, G_OPTION_ARG_NONE, &extract_palette, "Extract palettes from image files without starting user interface, see --extract-palette --help", nullptr},
 	{G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &commandline_filename, nullptr, "[FILE...]"},
 	{nullptr}
 };
+static GOptionEntry extract_palette_entries[] =
+{
+	{"extract-palette", 0, 0, G_OPTION_ARG_NONE, &extract_palette, "Extract palettes from image files", nullptr},
+	{"colors", 'n', 0, G_OPTION_ARG_INT, &extract_palette_colors, "Number of colors extracted from each image", "N"},
+	{"output", 'o', 0, G_OPTION_ARG_FILENAME, &extract_palette_output, "Palette file (.gpa, .gpl or .css)", "FILE"},
+	{"max-pixels", 0, 0, G_OPTION_ARG_INT64, &extract_palette_max_pixels, "Scale down images with more pixels before extraction, images are processed at full size by default", "N"},
+	{G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &commandline_filename, nullptr, "IMAGE..."},
+	{nullptr}
+};
+static bool is_extract_palette_mode(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++){
+		if (std::strcmp(argv[i], "--") == 0)
+			return false;
+		if (std::strcmp(argv[i], "--extract-palette") == 0)
+			return true;
+	}
+	return false;
+}
+// Palette extraction runs without display connection, so GTK is neither initialized nor added to option context
+static int extract_palette_main(char **argv)
+{
+	GError *error = nullptr;
+	GOptionContext *context = g_option_context_new("- extract palettes from images");
+	g_option_context_add_main_entries(context, extract_palette_entries, 0);
+	gchar **argv_copy;
+#ifdef WIN32
+	argv_copy = g_win32_get_command_line();
+#else
+	argv_copy = g_strdupv(argv);
+#endif
+	bool parsed = g_option_context_parse_strv(context, &argv_copy, &error);
+	g_option_context_free(context);
+	g_strfreev(argv_copy);
+	if (!parsed){
+		g_print("option parsing failed: %s\n", error->message);
+		g_clear_error(&error);
+		return -1;
+	}
+	if (!commandline_filename || !extract_palette_output){
+		g_print("image files and output file must be specified\n");
+		return -1;
+	}
+	std::vector<std::string> filenames;
+	for (gchar **filename = commandline_filename; *filename; ++filename)
+		filenames.emplace_back(*filename);
+	return tools_extract_palette(filenames, static_cast<uint32_t>(std::max(extract_palette_colors, 0)), extract_palette_output, static_cast<size_t>(std::max<gint64>(extract_palette_max_pixels, 0)));
+}
 int main(int argc, char **argv)
 {
 	std::setlocale(LC_ALL, "");
+	if (is_extract_palette_mode(argc, argv))
+		return extract_palette_main(argv);
 	gtk_init(&argc, &argv);
 	initialize_i18n();
 	g_set_application_name(program_name);
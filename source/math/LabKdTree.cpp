@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "LabKdTree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+namespace math {
+bool LabKdTree::Node::isLeaf() const {
+	return left == 0;
+}
+LabKdTree::LabKdTree():
+	m_attached(false) {
+}
+size_t LabKdTree::add(const Color &color) {
+	if (m_attached)
+		m_points.assign(m_pointView.data(), m_pointView.data() + m_pointView.size());
+	detach();
+	size_t index = m_points.size();
+	m_points.push_back(Point { { color.lab.L, color.lab.a, color.lab.b }, std::sqrt(color.lab.a * color.lab.a + color.lab.b * color.lab.b), static_cast<uint32_t>(index) });
+	return index;
+}
+void LabKdTree::build() {
+	if (m_attached)
+		m_points.assign(m_pointView.data(), m_pointView.data() + m_pointView.size());
+	detach();
+	if (!m_points.empty()) {
+		m_nodes.reserve(2 * (m_points.size() / maxLeafSize + 1));
+		build(0, static_cast<uint32_t>(m_points.size()));
+	}
+	m_pointView = common::Span<const Point>(m_points.data(), m_points.size());
+	m_nodeView = common::Span<const Node>(m_nodes.data(), m_nodes.size());
+}
+uint32_t LabKdTree::build(uint32_t begin, uint32_t end) {
+	Node node;
+	for (int i = 0; i < 3; ++i) {
+		node.min[i] = std::numeric_limits<float>::max();
+		node.max[i] = std::numeric_limits<float>::lowest();
+	}
+	node.maxChroma = 0;
+	for (auto i = begin; i < end; ++i) {
+		const auto &point = m_points[i];
+		for (int j = 0; j < 3; ++j) {
+			node.min[j] = std::min(node.min[j], point.lab[j]);
+			node.max[j] = std::max(node.max[j], point.lab[j]);
+		}
+		node.maxChroma = std::max(node.maxChroma, point.chroma);
+	}
+	node.begin = begin;
+	node.end = end;
+	node.left = node.right = 0;
+	uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+	m_nodes.push_back(node);
+	if (end - begin <= maxLeafSize)
+		return nodeIndex;
+	int axis = 0;
+	for (int i = 1; i < 3; ++i) {
+		if (node.max[i] - node.min[i] > node.max[axis] - node.min[axis])
+			axis = i;
+	}
+	uint32_t middle = begin + (end - begin) / 2;
+	std::nth_element(m_points.begin() + begin, m_points.begin() + middle, m_points.begin() + end, [axis](const Point &a, const Point &b) {
+		return a.lab[axis] < b.lab[axis];
+	});
+	uint32_t left = build(begin, middle);
+	uint32_t right = build(middle, end);
+	m_nodes[nodeIndex].left = left;
+	m_nodes[nodeIndex].right = right;
+	return nodeIndex;
+}
+bool LabKdTree::attach(common::Span<const Point> points, common::Span<const Node> nodes) {
+	if (points.size() >= std::numeric_limits<uint32_t>::max() || nodes.size() >= std::numeric_limits<uint32_t>::max())
+		return false;
+	if ((points.size() == 0) != (nodes.size() == 0))
+		return false;
+	for (const auto &point: points) {
+		if (point.index >= points.size())
+			return false;
+	}
+	for (size_t i = 0; i < nodes.size(); ++i) {
+		const auto &node = nodes[i];
+		if (node.begin > node.end || node.end > points.size())
+			return false;
+		// children always follow their parent, which also rules out cycles that would make search recurse forever
+		if (!node.isLeaf() && (node.left <= i || node.right <= i || node.left >= nodes.size() || node.right >= nodes.size()))
+			return false;
+	}
+	clear();
+	m_pointView = points;
+	m_nodeView = nodes;
+	m_attached = true;
+	return true;
+}
+common::Span<const LabKdTree::Point> LabKdTree::points() const {
+	return m_pointView;
+}
+common::Span<const LabKdTree::Node> LabKdTree::nodes() const {
+	return m_nodeView;
+}
+void LabKdTree::detach() {
+	m_nodes.clear();
+	m_pointView = common::Span<const Point>();
+	m_nodeView = common::Span<const Node>();
+	m_attached = false;
+}
+void LabKdTree::clear() {
+	m_points.clear();
+	detach();
+}
+size_t LabKdTree::size() const {
+	return m_attached ? m_pointView.size() : m_points.size();
+}
+bool LabKdTree::empty() const {
+	return size() == 0;
+}
+float LabKdTree::lowerBound(const Node &node, const Color &color) const {
+	// Lightness difference is used by CIE94 without weighting. For a planar (a, b) distance r between two colors, chroma and hue
+	// terms can not be smaller than r^4 / (Wc^2 + Wh^2), where Wc and Wh are weights calculated from the maximum chroma in the node.
+	double delta[3];
+	for (int i = 0; i < 3; ++i) {
+		if (color.data[i] < node.min[i])
+			delta[i] = node.min[i] - color.data[i];
+		else if (color.data[i] > node.max[i])
+			delta[i] = color.data[i] - node.max[i];
+		else
+			delta[i] = 0;
+	}
+	double planarSquared = delta[1] * delta[1] + delta[2] * delta[2];
+	double chromaWeight = 1 + 0.045 * node.maxChroma;
+	double hueWeight = 1 + 0.015 * node.maxChroma;
+	double bound = std::sqrt(delta[0] * delta[0] + planarSquared * planarSquared / (chromaWeight * chromaWeight + hueWeight * hueWeight));
+	// leave some room for floating point rounding errors
+	return static_cast<float>(bound * 0.999);
+}
+template<typename OnPoint, typename GetLimit>
+void LabKdTree::search(uint32_t nodeIndex, const Color &color, OnPoint &onPoint, GetLimit &getLimit) const {
+	const auto &node = m_nodeView[nodeIndex];
+	if (node.isLeaf()) {
+		for (auto i = node.begin; i < node.end; ++i) {
+			const auto &point = m_pointView[i];
+			onPoint(point.index, Color::distanceLch(Color(point.lab[0], point.lab[1], point.lab[2]), color));
+		}
+		return;
+	}
+	uint32_t first = node.left, second = node.right;
+	float firstBound = lowerBound(m_nodeView[first], color);
+	float secondBound = lowerBound(m_nodeView[second], color);
+	if (secondBound < firstBound) {
+		std::swap(first, second);
+		std::swap(firstBound, secondBound);
+	}
+	if (firstBound <= getLimit())
+		search(first, color, onPoint, getLimit);
+	if (secondBound <= getLimit())
+		search(second, color, onPoint, getLimit);
+}
+std::optional<std::pair<size_t, float>> LabKdTree::nearest(const Color &color) const {
+	if (m_nodeView.size() == 0)
+		return std::nullopt;
+	float resultDistance = std::numeric_limits<float>::max();
+	uint32_t resultIndex = 0;
+	auto onPoint = [&](uint32_t index, float distance) {
+		if (distance < resultDistance || (distance == resultDistance && index < resultIndex)) {
+			resultDistance = distance;
+			resultIndex = index;
+		}
+	};
+	auto getLimit = [&]() {
+		return resultDistance;
+	};
+	search(0, color, onPoint, getLimit);
+	return std::pair<size_t, float>(resultIndex, resultDistance);
+}
+void LabKdTree::nearest(const Color &color, size_t count, std::vector<std::pair<float, size_t>> &results) const {
+	results.clear();
+	if (m_nodeView.size() == 0 || count == 0)
+		return;
+	std::priority_queue<std::pair<float, size_t>> found;
+	auto onPoint = [&](uint32_t index, float distance) {
+		std::pair<float, size_t> item(distance, index);
+		if (found.size() < count) {
+			found.push(item);
+		} else if (item < found.top()) {
+			found.pop();
+			found.push(item);
+		}
+	};
+	auto getLimit = [&]() {
+		return found.size() < count ? std::numeric_limits<float>::max() : found.top().first;
+	};
+	search(0, color, onPoint, getLimit);
+	results.resize(found.size());
+	for (size_t i = found.size(); i > 0; --i) {
+		results[i - 1] = found.top();
+		found.pop();
+	}
+}
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "Color.h"
+#include "common/Span.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+namespace math {
+/** \struct LabKdTree
+ * \brief k-d tree over colors in Lab color space with exact nearest neighbour queries using CIE94 color difference (Color::distanceLch).
+ *
+ * Node pruning uses a lower bound of Color::distanceLch computed from node bounding box and maximum chroma of colors in the node, so search results are the same as
+ * a linear scan over all colors.
+ * Tree can also be attached to externally owned point and node arrays, for example memory mapped from a file.
+ */
+struct LabKdTree {
+	static constexpr size_t maxLeafSize = 8;
+	struct Point {
+		float lab[3];
+		float chroma;
+		uint32_t index;
+	};
+	struct Node {
+		float min[3], max[3];
+		float maxChroma;
+		uint32_t begin, end;
+		uint32_t left, right;
+		bool isLeaf() const;
+	};
+	LabKdTree();
+	/**
+	 * Add color to the tree. Tree must be rebuilt after adding colors.
+	 * @param[in] color Color in Lab color space.
+	 * @return Index of added color.
+	 */
+	size_t add(const Color &color);
+	/**
+	 * Build tree from all added colors.
+	 */
+	void build();
+	/**
+	 * Use externally owned tree data instead of added colors. Data must stay valid while it is used by the tree.
+	 * @param[in] points Points in tree order, as returned by points() of a built tree.
+	 * @param[in] nodes Tree nodes, as returned by nodes() of a built tree.
+	 * @return True if data is consistent and was attached.
+	 */
+	bool attach(common::Span<const Point> points, common::Span<const Node> nodes);
+	common::Span<const Point> points() const;
+	common::Span<const Node> nodes() const;
+	void clear();
+	size_t size() const;
+	bool empty() const;
+	/**
+	 * Find nearest color.
+	 * @param[in] color Color in Lab color space.
+	 * @return Index of nearest color and distance to it, or nothing when tree is empty.
+	 */
+	std::optional<std::pair<size_t, float>> nearest(const Color &color) const;
+	/**
+	 * Find nearest colors.
+	 * @param[in] color Color in Lab color space.
+	 * @param[in] count Maximum number of colors to find.
+	 * @param[out] results Distances and indexes of found colors sorted by distance.
+	 */
+	void nearest(const Color &color, size_t count, std::vector<std::pair<float, size_t>> &results) const;
+private:
+	std::vector<Point> m_points;
+	std::vector<Node> m_nodes;
+	common::Span<const Point> m_pointView;
+	common::Span<const Node> m_nodeView;
+	bool m_attached;
+	uint32_t build(uint32_t begin, uint32_t end);
+	void detach();
+	float lowerBound(const Node &node, const Color &color) const;
+	template<typename OnPoint, typename GetLimit>
+	void search(uint32_t nodeIndex, const Color &color, OnPoint &onPoint, GetLimit &getLimit) const;
+};
+}
@@ -17,22 +17,13 @@
  */
 
 #include "OctreeColorQuantization.h"
+#include <boost/endian/conversion.hpp>
 #include <algorithm>
 #include <cstring>
-#include <new>
+#include <istream>
+#include <ostream>
 namespace math {
 using Node = OctreeColorQuantization::Node;
-template<typename... Args>
-Node *newNode(OctreeColorQuantization::Allocator &allocator, std::vector<Node *> &freeNodes, Args &&...args) {
-	Node *node;
-	if (freeNodes.size() > 0) {
-		node = freeNodes.back();
-		freeNodes.pop_back();
-	} else {
-		node = allocator.allocate(1);
-	}
-	return new (node) Node(std::forward<Args>(args)...);
-}
 template<size_t MaxNodesPerLevel>
 constexpr size_t maxTotalNodes(size_t value, uint8_t depth) {
 	if (depth == 0)
@@ -42,165 +33,144 @@ constexpr size_t maxTotalNodes(size_t value, uint8_t depth) {
 static uint8_t toIndex(uint8_t value, uint8_t depth) {
 	return (value >> (7 - depth)) & 1;
 }
-OctreeColorQuantization::Node::Node() noexcept:
-	m_children { nullptr },
-	m_pixels(0),
-	m_colorSum { 0 } {
+static const Node emptyNode = { { 0 }, 0, { 0, 0, 0 }, 0 };
+static const char serializationMagic[4] = { 'G', 'P', 'O', 'Q' };
+static const uint8_t serializationVersion = 1;
+OctreeColorQuantization::OctreeColorQuantization():
+	m_leafs(0) {
+	m_nodes.reserve(maxTotalNodes<maxNodesPerLevel>(1, maxDepth));
+	m_nodes.push_back(emptyNode);
 }
-OctreeColorQuantization::Node::Node(const Node &node, uint8_t depth, OctreeColorQuantization &ocq):
-	m_children { nullptr },
-	m_pixels(node.m_pixels),
-	m_colorSum { node.m_colorSum[0], node.m_colorSum[1], node.m_colorSum[2] } {
-	if (m_pixels > 0)
-		return;
+OctreeColorQuantization::OctreeColorQuantization(const OctreeColorQuantization &ocq):
+	m_leafs(ocq.m_leafs) {
+	m_nodes.reserve(maxTotalNodes<maxNodesPerLevel>(1, maxDepth));
+	m_nodes.push_back(emptyNode);
+	copyNode(ocq, 0, 0);
+}
+uint32_t OctreeColorQuantization::newNode() {
+	if (!m_freeNodes.empty()) {
+		uint32_t index = m_freeNodes.back();
+		m_freeNodes.pop_back();
+		m_nodes[index] = emptyNode;
+		return index;
+	}
+	m_nodes.push_back(emptyNode);
+	return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+uint32_t OctreeColorQuantization::copyNode(const OctreeColorQuantization &ocq, uint32_t sourceIndex, uint8_t depth) {
+	// child nodes are copied depth first and registered in levels after their subtrees, same order as produced by recursive copying of pointer tree
+	uint32_t index = sourceIndex == 0 ? 0 : newNode();
+	const Node &source = ocq.m_nodes[sourceIndex];
+	m_nodes[index].pixels = source.pixels;
+	std::copy(source.colorSum, source.colorSum + 3, m_nodes[index].colorSum);
+	if (source.isLeaf())
+		return index;
 	for (uint8_t i = 0; i < children; i++) {
-		if (node.m_children[i]) {
-			m_children[i] = newNode(ocq.m_allocator, ocq.m_freeNodes, *node.m_children[i], depth + 1, ocq);
-			if (depth < maxDepth - 1)
-				ocq.m_levels[depth].push_back(m_children[i]);
-		} else {
-			m_children[i] = nullptr;
-		}
+		if (!(source.childMask & (1 << i)))
+			continue;
+		uint32_t child = copyNode(ocq, source.children[i], depth + 1);
+		m_nodes[index].children[i] = child;
+		m_nodes[index].childMask |= static_cast<uint8_t>(1 << i);
+		if (depth < maxDepth - 1)
+			m_levels[depth].push_back(child);
 	}
+	return index;
 }
-void OctreeColorQuantization::Node::clear() {
-	m_pixels = 0;
-	m_colorSum[0] = 0;
-	m_colorSum[1] = 0;
-	m_colorSum[2] = 0;
-	std::memset(m_children, 0, sizeof(m_children));
+void OctreeColorQuantization::freeChild(Node &node, uint8_t child) {
+	m_freeNodes.push_back(node.children[child]);
+	node.children[child] = 0;
+	node.childMask &= static_cast<uint8_t>(~(1 << child));
 }
-size_t OctreeColorQuantization::Node::leafs() const {
-	size_t result = isLeaf() ? 1 : 0;
+size_t OctreeColorQuantization::totalPixels(uint32_t index) const {
+	const Node &node = m_nodes[index];
+	size_t result = node.pixels;
 	for (uint8_t i = 0; i < children; i++) {
-		if (m_children[i])
-			result += m_children[i]->leafs();
+		if (node.childMask & (1 << i))
+			result += totalPixels(node.children[i]);
 	}
 	return result;
 }
-uint8_t OctreeColorQuantization::Node::removeLeafs(OctreeColorQuantization &ocq) {
-	bool wasLeaf = isLeaf();
+uint8_t OctreeColorQuantization::removeLeafs(uint32_t index) {
+	Node &node = m_nodes[index];
+	bool wasLeaf = node.isLeaf();
 	uint8_t result = 0;
 	for (uint8_t i = 0; i < children; i++) {
-		if (!m_children[i])
+		if (!(node.childMask & (1 << i)))
 			continue;
-		auto &node = *m_children[i];
-		ocq.m_freeNodes.push_back(m_children[i]);
-		m_children[i] = nullptr;
-		m_pixels += node.m_pixels;
-		m_colorSum[0] += node.m_colorSum[0];
-		m_colorSum[1] += node.m_colorSum[1];
-		m_colorSum[2] += node.m_colorSum[2];
+		const Node &child = m_nodes[node.children[i]];
+		node.pixels += child.pixels;
+		node.colorSum[0] += child.colorSum[0];
+		node.colorSum[1] += child.colorSum[1];
+		node.colorSum[2] += child.colorSum[2];
+		freeChild(node, i);
 		++result;
 	}
-	if (!wasLeaf && isLeaf())
+	if (!wasLeaf && node.isLeaf())
 		--result;
 	return result;
 }
-uint8_t OctreeColorQuantization::Node::reduceLeafs(uint8_t reduceBy, OctreeColorQuantization &ocq) {
+uint8_t OctreeColorQuantization::reduceLeafs(uint32_t index, uint8_t reduceBy) {
+	Node &node = m_nodes[index];
 	std::array<uint8_t, children> indexes;
 	uint8_t have = 0;
 	for (uint8_t i = 0; i < children; i++) {
-		if (m_children[i]) {
+		if (node.childMask & (1 << i)) {
 			indexes[have++] = i;
 		}
 	}
 	if (have <= reduceBy + 1)
-		return removeLeafs(ocq);
+		return removeLeafs(index);
 	uint8_t reduced = 0;
 	while (reduced < reduceBy) {
-		std::sort(indexes.begin(), indexes.begin() + have, [this](uint8_t a, uint8_t b) {
-			return m_children[a]->m_pixels > m_children[b]->m_pixels;
+		std::sort(indexes.begin(), indexes.begin() + have, [this, &node](uint8_t a, uint8_t b) {
+			return m_nodes[node.children[a]].pixels > m_nodes[node.children[b]].pixels;
 		});
 		uint8_t sourceIndex = indexes[have - 1];
 		uint8_t destinationIndex = indexes[have - 2];
-		auto &sourceNode = *m_children[sourceIndex];
-		auto &destinationNode = *m_children[destinationIndex];
-		destinationNode.m_pixels += sourceNode.m_pixels;
-		destinationNode.m_colorSum[0] += sourceNode.m_colorSum[0];
-		destinationNode.m_colorSum[1] += sourceNode.m_colorSum[1];
-		destinationNode.m_colorSum[2] += sourceNode.m_colorSum[2];
-		ocq.m_freeNodes.push_back(m_children[sourceIndex]);
-		m_children[sourceIndex] = nullptr;
+		const Node &sourceNode = m_nodes[node.children[sourceIndex]];
+		Node &destinationNode = m_nodes[node.children[destinationIndex]];
+		destinationNode.pixels += sourceNode.pixels;
+		destinationNode.colorSum[0] += sourceNode.colorSum[0];
+		destinationNode.colorSum[1] += sourceNode.colorSum[1];
+		destinationNode.colorSum[2] += sourceNode.colorSum[2];
+		freeChild(node, sourceIndex);
 		++reduced;
 		--have;
 	}
 	return reduced;
 }
-void OctreeColorQuantization::Node::add(const Color &color, const Position position, uint8_t depth, OctreeColorQuantization &ocq) {
-	if (ocq.m_leafs + 1 >= maxNodesPerLevel)
-		ocq.reduce(maxNodesPerLevel / 2, false);
-	if (depth == maxDepth || isLeaf()) {
-		if (m_pixels == 0)
-			ocq.m_leafs++;
-		m_pixels++;
-		m_colorSum[0] += color.xyz.x;
-		m_colorSum[1] += color.xyz.y;
-		m_colorSum[2] += color.xyz.z;
-		return;
-	}
-	uint8_t i = toIndex(position[0], depth) | (toIndex(position[1], depth) << 1) | (toIndex(position[2], depth) << 2);
-	if (!m_children[i]) {
-		m_children[i] = newNode(ocq.m_allocator, ocq.m_freeNodes);
-		if (depth < maxDepth - 1)
-			ocq.m_levels[depth].push_back(m_children[i]);
-	}
-	m_children[i]->add(color, position, depth + 1, ocq);
-}
-void OctreeColorQuantization::Node::add(const Color &color, size_t pixels, const Position position, uint8_t depth, OctreeColorQuantization &ocq) {
-	if (ocq.m_leafs + 1 >= maxNodesPerLevel)
-		ocq.reduce(maxNodesPerLevel / 2, false);
-	if (depth == maxDepth || isLeaf()) {
-		if (m_pixels == 0)
-			ocq.m_leafs++;
-		m_pixels += pixels;
-		m_colorSum[0] += color.xyz.x * pixels;
-		m_colorSum[1] += color.xyz.y * pixels;
-		m_colorSum[2] += color.xyz.z * pixels;
-		return;
-	}
-	uint8_t i = toIndex(position[0], depth) | (toIndex(position[1], depth) << 1) | (toIndex(position[2], depth) << 2);
-	if (!m_children[i]) {
-		m_children[i] = newNode(ocq.m_allocator, ocq.m_freeNodes);
-		if (depth < maxDepth - 1)
-			ocq.m_levels[depth].push_back(m_children[i]);
-	}
-	m_children[i]->add(color, pixels, position, depth + 1, ocq);
-}
-bool OctreeColorQuantization::Node::isLeaf() const {
-	return m_pixels > 0;
-}
-size_t OctreeColorQuantization::Node::totalPixels() const {
-	size_t result = m_pixels;
-	for (uint8_t i = 0; i < children; i++) {
-		if (!m_children[i])
-			continue;
-		result += m_children[i]->totalPixels();
-	}
-	return result;
-}
-OctreeColorQuantization::OctreeColorQuantization():
-	m_leafs(0),
-	m_memory(maxTotalNodes<maxNodesPerLevel>(1, maxDepth) * sizeof(Node)),
-	m_bufferResource(m_memory.data(), m_memory.size(), std::pmr::null_memory_resource()),
-	m_allocator(&m_bufferResource) {
-}
-OctreeColorQuantization::OctreeColorQuantization(const OctreeColorQuantization &ocq):
-	m_leafs(ocq.m_leafs),
-	m_memory(maxTotalNodes<maxNodesPerLevel>(1, maxDepth) * sizeof(Node)),
-	m_bufferResource(m_memory.data(), m_memory.size(), std::pmr::null_memory_resource()),
-	m_allocator(&m_bufferResource),
-	m_root(ocq.m_root, 0, *this) {
-}
 void OctreeColorQuantization::add(const Color &color, const Position position) {
-	m_root.add(color, position, 0, *this);
+	add(color, 1, position);
 }
 void OctreeColorQuantization::add(const Color &color, size_t pixels, const Position position) {
-	m_root.add(color, pixels, position, 0, *this);
+	uint32_t index = 0;
+	for (uint8_t depth = 0;; depth++) {
+		if (m_leafs + 1 >= maxNodesPerLevel)
+			reduce(maxNodesPerLevel / 2, false);
+		if (depth == maxDepth || m_nodes[index].isLeaf()) {
+			Node &node = m_nodes[index];
+			if (node.pixels == 0)
+				m_leafs++;
+			node.pixels += pixels;
+			node.colorSum[0] += color.xyz.x * pixels;
+			node.colorSum[1] += color.xyz.y * pixels;
+			node.colorSum[2] += color.xyz.z * pixels;
+			return;
+		}
+		uint8_t i = toIndex(position[0], depth) | (toIndex(position[1], depth) << 1) | (toIndex(position[2], depth) << 2);
+		if (!(m_nodes[index].childMask & (1 << i))) {
+			uint32_t child = newNode();
+			m_nodes[index].children[i] = child;
+			m_nodes[index].childMask |= static_cast<uint8_t>(1 << i);
+			if (depth < maxDepth - 1)
+				m_levels[depth].push_back(child);
+		}
+		index = m_nodes[index].children[i];
+	}
 }
 void OctreeColorQuantization::clear() {
-	m_root.clear();
-	m_bufferResource.release();
+	m_nodes.clear();
+	m_nodes.push_back(emptyNode);
 	for (auto &level: m_levels)
 		level.clear();
 	m_freeNodes.clear();
@@ -208,15 +178,17 @@ void OctreeColorQuantization::clear() {
 }
 void OctreeColorQuantization::rebuildLevel(uint8_t level) {
 	if (level == 0) {
+		const Node &root = m_nodes[0];
 		for (uint8_t i = 0; i < children; i++) {
-			if (m_root.m_children[i])
-				m_levels[level].push_back(m_root.m_children[i]);
+			if (root.childMask & (1 << i))
+				m_levels[level].push_back(root.children[i]);
 		}
 	} else {
-		for (auto node: m_levels[level - 1]) {
+		for (auto index: m_levels[level - 1]) {
+			const Node &node = m_nodes[index];
 			for (uint8_t i = 0; i < children; i++) {
-				if (node->m_children[i])
-					m_levels[level].push_back(node->m_children[i]);
+				if (node.childMask & (1 << i))
+					m_levels[level].push_back(node.children[i]);
 			}
 		}
 	}
@@ -227,32 +199,32 @@ void OctreeColorQuantization::reduce(size_t numberOfColors, bool accurate) {
 	if (m_leafs <= numberOfColors)
 		return;
 	for (int i = static_cast<int>(maxDepth - 2); i >= 0; --i) {
-		std::vector<Node *> &level = m_levels[i];
+		std::vector<uint32_t> &level = m_levels[i];
 		if (level.size() <= numberOfColors) {
-			std::sort(level.begin(), level.end(), [](Node *a, Node *b) {
-				return a->totalPixels() < b->totalPixels();
+			std::sort(level.begin(), level.end(), [this](uint32_t a, uint32_t b) {
+				return totalPixels(a) < totalPixels(b);
 			});
 		}
-		for (auto node: level) {
+		for (auto index: level) {
 			if (accurate && (m_leafs - numberOfColors < 8)) {
-				m_leafs -= node->reduceLeafs(m_leafs - numberOfColors, *this);
+				m_leafs -= reduceLeafs(index, static_cast<uint8_t>(m_leafs - numberOfColors));
 			} else {
-				m_leafs -= node->removeLeafs(*this);
+				m_leafs -= removeLeafs(index);
 			}
 			if (m_leafs <= numberOfColors) {
 				int levelIndex = i;
 				for (; i < static_cast<int>(maxDepth - 1); ++i) {
 					m_levels[i].clear();
 				}
-				rebuildLevel(levelIndex);
+				rebuildLevel(static_cast<uint8_t>(levelIndex));
 				return;
 			}
 		}
 	}
 	if (m_leafs - numberOfColors < 8) {
-		m_leafs -= m_root.reduceLeafs(m_leafs - numberOfColors, *this);
+		m_leafs -= reduceLeafs(0, static_cast<uint8_t>(m_leafs - numberOfColors));
 	} else {
-		m_leafs -= m_root.removeLeafs(*this);
+		m_leafs -= removeLeafs(0);
 	}
 	for (int i = 0; i < static_cast<int>(maxDepth - 1); ++i) {
 		m_levels[i].clear();
@@ -261,4 +233,181 @@ void OctreeColorQuantization::reduce(size_t numberOfColors, bool accurate) {
 size_t OctreeColorQuantization::size() const {
 	return m_leafs;
 }
+void OctreeColorQuantization::collapseNode(uint32_t index) {
+	if (m_nodes[index].isLeaf())
+		return;
+	for (uint8_t i = 0; i < children; i++) {
+		if (!(m_nodes[index].childMask & (1 << i)))
+			continue;
+		collapseNode(m_nodes[index].children[i]);
+		Node &node = m_nodes[index];
+		const Node &child = m_nodes[node.children[i]];
+		node.pixels += child.pixels;
+		node.colorSum[0] += child.colorSum[0];
+		node.colorSum[1] += child.colorSum[1];
+		node.colorSum[2] += child.colorSum[2];
+		freeChild(node, i);
+	}
+}
+void OctreeColorQuantization::mergeNode(uint32_t index, const OctreeColorQuantization &ocq, uint32_t sourceIndex, uint8_t depth) {
+	const Node &source = ocq.m_nodes[sourceIndex];
+	if (source.isLeaf() || m_nodes[index].isLeaf()) {
+		// coarser of both trees determines resolution of merged node
+		collapseNode(index);
+		Node &node = m_nodes[index];
+		auto addLeaf = [&node](const float colorSum[3], size_t pixels) {
+			node.pixels += pixels;
+			node.colorSum[0] += colorSum[0];
+			node.colorSum[1] += colorSum[1];
+			node.colorSum[2] += colorSum[2];
+		};
+		ocq.visit(sourceIndex, addLeaf);
+		return;
+	}
+	for (uint8_t i = 0; i < children; i++) {
+		if (!(source.childMask & (1 << i)))
+			continue;
+		if (m_nodes[index].childMask & (1 << i)) {
+			mergeNode(m_nodes[index].children[i], ocq, source.children[i], depth + 1);
+		} else {
+			uint32_t child = copyNode(ocq, source.children[i], depth + 1);
+			m_nodes[index].children[i] = child;
+			m_nodes[index].childMask |= static_cast<uint8_t>(1 << i);
+		}
+	}
+}
+void OctreeColorQuantization::rebuildLevels() {
+	for (auto &level: m_levels)
+		level.clear();
+	for (uint8_t level = 0; level < maxDepth - 1; level++)
+		rebuildLevel(level);
+	m_leafs = 0;
+	auto countLeaf = [this](const float *, size_t) {
+		m_leafs++;
+	};
+	visit(0, countLeaf);
+	if (m_leafs + 1 >= maxNodesPerLevel)
+		reduce(maxNodesPerLevel / 2, false);
+}
+void OctreeColorQuantization::merge(const OctreeColorQuantization &ocq) {
+	if (&ocq == this) {
+		OctreeColorQuantization copy(ocq);
+		merge(copy);
+		return;
+	}
+	mergeNode(0, ocq, 0, 0);
+	rebuildLevels();
+}
+template<typename T>
+static bool write(std::ostream &stream, T value) {
+	value = boost::endian::native_to_little(value);
+	stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	return stream.good();
+}
+template<typename T>
+static bool read(std::istream &stream, T &value) {
+	stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+	value = boost::endian::little_to_native(value);
+	return stream.good();
+}
+static bool writeFloat(std::ostream &stream, float value) {
+	static_assert(sizeof(float) == sizeof(uint32_t), "sizeof(float) != sizeof(uint32_t)");
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return write(stream, bits);
+}
+static bool readFloat(std::istream &stream, float &value) {
+	uint32_t bits;
+	if (!read(stream, bits))
+		return false;
+	std::memcpy(&value, &bits, sizeof(value));
+	return true;
+}
+// pixel counts are written as variable length integers, 7 bits per byte
+static bool writeCount(std::ostream &stream, uint64_t value) {
+	do {
+		uint8_t byte = value & 0x7f;
+		value >>= 7;
+		if (value)
+			byte |= 0x80;
+		if (!write(stream, byte))
+			return false;
+	} while (value);
+	return true;
+}
+static bool readCount(std::istream &stream, uint64_t &value) {
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		uint8_t byte;
+		if (!read(stream, byte))
+			return false;
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return true;
+	}
+	return false;
+}
+bool OctreeColorQuantization::serializeNode(std::ostream &stream, uint32_t index) const {
+	const Node &node = m_nodes[index];
+	uint8_t childMask = node.isLeaf() ? 0 : node.childMask;
+	if (!write(stream, childMask))
+		return false;
+	if (childMask == 0) {
+		if (!writeCount(stream, node.pixels))
+			return false;
+		if (node.pixels == 0)
+			return true;
+		return writeFloat(stream, node.colorSum[0]) && writeFloat(stream, node.colorSum[1]) && writeFloat(stream, node.colorSum[2]);
+	}
+	for (uint8_t i = 0; i < children; i++) {
+		if ((childMask & (1 << i)) && !serializeNode(stream, node.children[i]))
+			return false;
+	}
+	return true;
+}
+bool OctreeColorQuantization::serialize(std::ostream &stream) const {
+	stream.write(serializationMagic, sizeof(serializationMagic));
+	if (!write(stream, serializationVersion))
+		return false;
+	return serializeNode(stream, 0);
+}
+bool OctreeColorQuantization::deserializeNode(std::istream &stream, uint32_t index, uint8_t depth) {
+	uint8_t childMask;
+	if (!read(stream, childMask))
+		return false;
+	if (childMask == 0) {
+		uint64_t pixels;
+		if (!readCount(stream, pixels))
+			return false;
+		Node &node = m_nodes[index];
+		node.pixels = static_cast<size_t>(pixels);
+		if (pixels == 0)
+			return true;
+		return readFloat(stream, node.colorSum[0]) && readFloat(stream, node.colorSum[1]) && readFloat(stream, node.colorSum[2]);
+	}
+	if (depth >= maxDepth)
+		return false;
+	for (uint8_t i = 0; i < children; i++) {
+		if (!(childMask & (1 << i)))
+			continue;
+		uint32_t child = newNode();
+		m_nodes[index].children[i] = child;
+		m_nodes[index].childMask |= static_cast<uint8_t>(1 << i);
+		if (!deserializeNode(stream, child, depth + 1))
+			return false;
+	}
+	return true;
+}
+bool OctreeColorQuantization::deserialize(std::istream &stream) {
+	clear();
+	char magic[sizeof(serializationMagic)];
+	stream.read(magic, sizeof(magic));
+	uint8_t version;
+	if (!stream.good() || std::memcmp(magic, serializationMagic, sizeof(magic)) != 0 || !read(stream, version) || version != serializationVersion || !deserializeNode(stream, 0, 0)) {
+		clear();
+		return false;
+	}
+	rebuildLevels();
+	return true;
+}
 }
@@ -22,7 +22,7 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
-#include <memory_resource>
+#include <iosfwd>
 #include <utility>
 #include <vector>
 namespace math {
@@ -30,37 +30,18 @@ struct OctreeColorQuantization {
 	static constexpr uint8_t children = 8;
 	static constexpr uint8_t maxDepth = 8;
 	static constexpr size_t maxNodesPerLevel = 4096;
-	struct Node;
-	using Allocator = std::pmr::polymorphic_allocator<Node>;
 	using Position = std::array<uint8_t, 3>;
+	/** \struct Node
+	 * \brief Octree node stored in contiguous node array. Children are referenced by index, index 0 is the root node and is never a child.
+	 */
 	struct Node {
-		Node() noexcept;
-		Node(const Node &node, uint8_t depth, OctreeColorQuantization &ocq);
-		Node &operator=(const Node &node);
-		void add(const Color &color, const Position position, uint8_t depth, OctreeColorQuantization &ocq);
-		void add(const Color &color, size_t pixels, const Position position, uint8_t depth, OctreeColorQuantization &ocq);
-		void clear();
-		uint8_t removeLeafs(OctreeColorQuantization &ocq);
-		uint8_t reduceLeafs(uint8_t reduceBy, OctreeColorQuantization &ocq);
-		size_t leafs() const;
-		bool isLeaf() const;
-		size_t totalPixels() const;
-		template<typename Callback>
-		void visit(Callback &&callback) const {
-			if (isLeaf()) {
-				callback(m_colorSum, m_pixels);
-				return;
-			}
-			for (uint8_t i = 0; i < children; i++) {
-				if (m_children[i])
-					m_children[i]->visit(callback);
-			}
+		uint32_t children[OctreeColorQuantization::children];
+		size_t pixels;
+		float colorSum[3];
+		uint8_t childMask;
+		bool isLeaf() const {
+			return pixels > 0;
 		}
-	private:
-		Node *m_children[children];
-		size_t m_pixels;
-		float m_colorSum[3];
-		friend struct OctreeColorQuantization;
 	};
 	OctreeColorQuantization();
 	OctreeColorQuantization(const OctreeColorQuantization &ocq);
@@ -68,21 +49,59 @@ struct OctreeColorQuantization {
 	void add(const Color &color, size_t pixels, const Position position);
 	void clear();
 	void reduce(size_t numberOfColors, bool accurate = true);
+	/**
+	 * Merge another octree into this octree node by node.
+	 * Where both trees have a node, pixel counts and color sums are added. Where one tree has a leaf and the other has a subtree, the subtree is collapsed into a leaf.
+	 * @param[in] ocq Octree to merge.
+	 */
+	void merge(const OctreeColorQuantization &ocq);
+	/**
+	 * Write compact binary representation of octree.
+	 * Nodes are written in depth first order as child occupancy masks, leafs additionally store pixel count and color sum.
+	 * @param[out] stream Output stream.
+	 * @return True on success.
+	 */
+	bool serialize(std::ostream &stream) const;
+	/**
+	 * Replace octree with octree read from binary representation written by serialize.
+	 * @param[in] stream Input stream.
+	 * @return True on success. Octree is left empty on failure.
+	 */
+	bool deserialize(std::istream &stream);
 	size_t size() const;
 	template<typename Callback>
 	void visit(Callback &&callback) {
-		m_root.visit(std::forward<Callback>(callback));
+		visit(0, callback);
 	}
 private:
 	size_t m_leafs;
-	std::array<std::vector<Node *>, maxDepth - 1> m_levels;
-	std::vector<Node *> m_freeNodes;
-	std::vector<uint8_t> m_memory;
-	std::pmr::monotonic_buffer_resource m_bufferResource;
-	Allocator m_allocator;
-	Node m_root;
+	std::vector<Node> m_nodes;
+	std::array<std::vector<uint32_t>, maxDepth - 1> m_levels;
+	std::vector<uint32_t> m_freeNodes;
+	template<typename Callback>
+	void visit(uint32_t index, Callback &callback) const {
+		const Node &node = m_nodes[index];
+		if (node.isLeaf()) {
+			callback(node.colorSum, node.pixels);
+			return;
+		}
+		for (uint8_t i = 0; i < children; i++) {
+			if (node.childMask & (1 << i))
+				visit(node.children[i], callback);
+		}
+	}
+	uint32_t newNode();
+	uint32_t copyNode(const OctreeColorQuantization &ocq, uint32_t sourceIndex, uint8_t depth);
+	void mergeNode(uint32_t index, const OctreeColorQuantization &ocq, uint32_t sourceIndex, uint8_t depth);
+	void collapseNode(uint32_t index);
+	bool serializeNode(std::ostream &stream, uint32_t index) const;
+	bool deserializeNode(std::istream &stream, uint32_t index, uint8_t depth);
+	void rebuildLevels();
+	void freeChild(Node &node, uint8_t child);
+	size_t totalPixels(uint32_t index) const;
+	uint8_t removeLeafs(uint32_t index);
+	uint8_t reduceLeafs(uint32_t index, uint8_t reduceBy);
 	void rebuildLevel(uint8_t level);
-	friend struct Node;
 };
 }
 #endif /* GPICK_MATH_OCTREE_COLOR_QUANTIZATION_H_ */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "PaletteQuantization.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+namespace math {
+// Cube root approximation for octree positions, relative error is below 2e-6 which is far below 8-bit fixed-point precision.
+static float fastCbrt(float value) {
+	if (value <= 0)
+		return 0;
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	bits = bits / 3 + 709921077;
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	for (int i = 0; i < 2; i++)
+		result = (2 * result + value / (result * result)) * (1 / 3.0f);
+	return result;
+}
+static float exactCbrt(float value) {
+	return std::cbrt(value);
+}
+template<float (*cbrt)(float)>
+static Vector3f linearRgbToOklab(const Color &color) {
+	float l = cbrt(0.4122214708f * color.red + 0.5363325363f * color.green + 0.0514459929f * color.blue);
+	float m = cbrt(0.2119034982f * color.red + 0.6806995451f * color.green + 0.1073969566f * color.blue);
+	float s = cbrt(0.0883024619f * color.red + 0.2817188376f * color.green + 0.6299787005f * color.blue);
+	return Vector3f(
+		0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+		1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+		0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s);
+}
+static uint8_t toFixedPoint(float value) {
+	return static_cast<uint8_t>(std::max(std::min(static_cast<int>(value * 256), 255), 0));
+}
+OctreeColorQuantization::Position oklabPosition(const Color &linearColor) {
+	auto oklab = linearRgbToOklab<fastCbrt>(linearColor);
+	const float abScale = 1 / 0.64f;
+	return { toFixedPoint(oklab.x), toFixedPoint(oklab.y * abScale + 0.5f), toFixedPoint(oklab.z * abScale + 0.5f) };
+}
+namespace {
+struct WeightedColor {
+	Vector3f oklab;
+	size_t pixels;
+};
+std::vector<WeightedColor> leafs(OctreeColorQuantization &octree) {
+	std::vector<WeightedColor> result;
+	result.reserve(octree.size());
+	octree.visit([&result](const float sum[3], size_t pixels) {
+		Color color(sum[0] / pixels, sum[1] / pixels, sum[2] / pixels);
+		result.push_back({ linearRgbToOklab<exactCbrt>(color), pixels });
+	});
+	return result;
+}
+void refine(const std::vector<WeightedColor> &points, std::vector<WeightedColor> &centroids, size_t iterations) {
+	std::vector<size_t> assignment(points.size(), std::numeric_limits<size_t>::max());
+	std::vector<std::array<double, 3>> sums(centroids.size());
+	for (size_t iteration = 0; iteration < iterations; ++iteration) {
+		bool changed = false;
+		for (size_t i = 0; i < points.size(); ++i) {
+			size_t best = 0;
+			float bestDistance = std::numeric_limits<float>::max();
+			for (size_t j = 0; j < centroids.size(); ++j) {
+				auto difference = points[i].oklab - centroids[j].oklab;
+				float distance = difference.x * difference.x + difference.y * difference.y + difference.z * difference.z;
+				if (distance < bestDistance) {
+					bestDistance = distance;
+					best = j;
+				}
+			}
+			if (assignment[i] != best) {
+				assignment[i] = best;
+				changed = true;
+			}
+		}
+		if (!changed)
+			break;
+		std::fill(sums.begin(), sums.end(), std::array<double, 3> { 0, 0, 0 });
+		for (auto &centroid: centroids)
+			centroid.pixels = 0;
+		for (size_t i = 0; i < points.size(); ++i) {
+			auto &sum = sums[assignment[i]];
+			double weight = static_cast<double>(points[i].pixels);
+			sum[0] += points[i].oklab.x * weight;
+			sum[1] += points[i].oklab.y * weight;
+			sum[2] += points[i].oklab.z * weight;
+			centroids[assignment[i]].pixels += points[i].pixels;
+		}
+		for (size_t j = 0; j < centroids.size(); ++j) {
+			// empty clusters keep their previous position
+			if (centroids[j].pixels == 0)
+				continue;
+			double weight = static_cast<double>(centroids[j].pixels);
+			centroids[j].oklab.x = static_cast<float>(sums[j][0] / weight);
+			centroids[j].oklab.y = static_cast<float>(sums[j][1] / weight);
+			centroids[j].oklab.z = static_cast<float>(sums[j][2] / weight);
+		}
+	}
+}
+}
+std::vector<PaletteColor> reducePalette(const OctreeColorQuantization &octree, size_t numberOfColors, size_t kMeansIterations) {
+	OctreeColorQuantization reducedOctree(octree);
+	std::vector<PaletteColor> result;
+	if (kMeansIterations == 0) {
+		reducedOctree.reduce(numberOfColors);
+		reducedOctree.visit([&result](const float sum[3], size_t pixels) {
+			Color color(sum[0] / pixels, sum[1] / pixels, sum[2] / pixels, 1.0f);
+			result.push_back({ color.nonLinearRgbInplace(), pixels });
+		});
+		return result;
+	}
+	auto points = leafs(reducedOctree);
+	reducedOctree.reduce(numberOfColors);
+	auto centroids = leafs(reducedOctree);
+	refine(points, centroids, kMeansIterations);
+	for (const auto &centroid: centroids) {
+		if (centroid.pixels == 0)
+			continue;
+		Color color(centroid.oklab.x, centroid.oklab.y, centroid.oklab.z, 1.0f);
+		result.push_back({ color.oklabToRgb().normalizeRgbInplace(), centroid.pixels });
+	}
+	return result;
+}
+}
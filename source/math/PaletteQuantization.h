@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "OctreeColorQuantization.h"
+#include "Color.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+namespace math {
+/** \enum QuantizationEngine
+ * \brief Color space used to partition colors into octree nodes.
+ */
+enum class QuantizationEngine : uint8_t {
+	rgb = 0, /**< 8-bit sRGB components. */
+	oklab = 1, /**< 8-bit fixed-point Oklab coordinates. */
+};
+/** \struct PaletteColor
+ * \brief Palette color with number of pixels it represents.
+ */
+struct PaletteColor {
+	Color color;
+	size_t pixels;
+};
+/**
+ * Get octree position of a color for Oklab quantization engine.
+ * Lightness is mapped from [0, 1] range and a, b from [-0.32, 0.32] range to 8-bit values, so perceptually close colors share octree branches and neutral colors are at the center of a and b axes.
+ * @param[in] linearColor Color in linear RGB color space.
+ * @return Octree position.
+ */
+OctreeColorQuantization::Position oklabPosition(const Color &linearColor);
+/**
+ * Reduce octree to a palette.
+ * Optional k-means refinement clusters octree leafs in Oklab color space, starting from reduced leafs.
+ * @param[in] octree Octree filled with linear RGB colors.
+ * @param[in] numberOfColors Maximum number of palette colors.
+ * @param[in] kMeansIterations Maximum number of k-means refinement iterations. Zero disables refinement.
+ * @return Palette colors in sRGB color space.
+ */
+std::vector<PaletteColor> reducePalette(const OctreeColorQuantization &octree, size_t numberOfColors, size_t kMeansIterations = 0);
+}
@@ -68,6 +68,29 @@ struct Rectangle {
 		*this = *this + rect;
 		return *this;
 	};
+	bool operator==(const Rectangle &rect) const {
+		if (m_empty || rect.m_empty)
+			return m_empty == rect.m_empty;
+		return m_x1 == rect.m_x1 && m_y1 == rect.m_y1 && m_x2 == rect.m_x2 && m_y2 == rect.m_y2;
+	}
+	bool operator!=(const Rectangle &rect) const {
+		return !(*this == rect);
+	}
+	/** Get area shared by both rectangles.
+	 * @param[in] rect Other rectangle.
+	 * @return Common area or empty rectangle if rectangles do not overlap.
+	 */
+	Rectangle intersection(const Rectangle &rect) const {
+		if (m_empty || rect.m_empty)
+			return Rectangle();
+		T x1 = m_x1 > rect.m_x1 ? m_x1 : rect.m_x1;
+		T y1 = m_y1 > rect.m_y1 ? m_y1 : rect.m_y1;
+		T x2 = m_x2 < rect.m_x2 ? m_x2 : rect.m_x2;
+		T y2 = m_y2 < rect.m_y2 ? m_y2 : rect.m_y2;
+		if (x1 >= x2 || y1 >= y2)
+			return Rectangle();
+		return Rectangle(x1, y1, x2, y2);
+	}
 	Rectangle impose(const Rectangle &rect) const {
 		Rectangle r;
 		r.m_x1 = rect.m_x1 + m_x1 * rect.getWidth();
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "IncrementalParser.h"
+#include <algorithm>
+namespace text_file_parser {
+namespace {
+struct StringTextFile: public TextView {
+	StringTextFile(std::string_view text, std::vector<Color> &colors):
+		TextView(text),
+		m_colors(colors),
+		m_failed(false) {
+	}
+	virtual ~StringTextFile() {
+	}
+	virtual void outOfMemory() override {
+		m_failed = true;
+	}
+	virtual void syntaxError(size_t, size_t, size_t, size_t) override {
+		m_failed = true;
+	}
+	virtual void addColor(const Color &color) override {
+		m_colors.push_back(color);
+	}
+	bool failed() const {
+		return m_failed;
+	}
+private:
+	std::vector<Color> &m_colors;
+	bool m_failed;
+};
+}
+IncrementalParser::IncrementalParser(size_t blockSize, size_t threads):
+	m_blockSize(std::max<size_t>(blockSize, 1)),
+	m_scannedBytes(0),
+	m_failedBlocks(0),
+	m_initialized(false),
+	m_parallelParser(1024 * 1024, threads) {
+}
+void IncrementalParser::clear() {
+	m_initialized = false;
+	m_text.clear();
+	m_blocks.clear();
+	m_colors.clear();
+	m_failedBlocks = 0;
+}
+const std::vector<Color> &IncrementalParser::colors() const {
+	return m_colors;
+}
+size_t IncrementalParser::scannedBytes() const {
+	return m_scannedBytes;
+}
+size_t IncrementalParser::blockEnd(std::string_view text, size_t position) const {
+	if (text.length() - position <= m_blockSize)
+		return text.length();
+	auto newline = text.find('\n', position + m_blockSize - 1);
+	return newline == std::string_view::npos ? text.length() : newline + 1;
+}
+bool IncrementalParser::parse(std::string_view text, const Configuration &configuration, Change &change) {
+	size_t previousColorCount = m_colors.size();
+	bool reset = !m_initialized || configuration != m_configuration;
+	if (reset) {
+		clear();
+		m_configuration = configuration;
+		m_initialized = true;
+	}
+	std::string_view oldText = m_text;
+	size_t prefix = 0, suffix = 0, commonLength = std::min(oldText.length(), text.length());
+	while (prefix < commonLength && oldText[prefix] == text[prefix])
+		prefix++;
+	while (suffix < commonLength - prefix && oldText[oldText.length() - suffix - 1] == text[text.length() - suffix - 1])
+		suffix++;
+	m_scannedBytes = 0;
+	if (!reset && prefix == oldText.length() && prefix == text.length()) {
+		change.first = m_colors.size();
+		change.removed = change.inserted = 0;
+		return m_failedBlocks == 0;
+	}
+	// Scanning starts at the block containing the first changed character. Block offsets are always at line starts, so scanner state at block start is known.
+	auto firstBlock = static_cast<size_t>(std::upper_bound(m_blocks.begin(), m_blocks.end(), prefix, [](size_t position, const Block &block) {
+		return position < block.offset;
+	}) - m_blocks.begin());
+	if (firstBlock > 0)
+		firstBlock--;
+	size_t position = firstBlock < m_blocks.size() ? m_blocks[firstBlock].offset : 0;
+	State state = firstBlock < m_blocks.size() ? m_blocks[firstBlock].startState : State::normal;
+	size_t firstColor = 0;
+	for (size_t i = 0; i < firstBlock; i++)
+		firstColor += m_blocks[i].colorCount;
+	// Old block offsets after the changed text can be reused: text after them is unchanged and character before them is still a newline.
+	size_t oldEnd = oldText.length() - suffix;
+	auto shiftedOffset = [&](size_t index) {
+		return m_blocks[index].offset + text.length() - oldText.length();
+	};
+	size_t reusedBlock = firstBlock;
+	while (reusedBlock < m_blocks.size() && m_blocks[reusedBlock].offset <= oldEnd)
+		reusedBlock++;
+	std::vector<Block> blocks;
+	std::vector<Color> colors;
+	bool synchronized = false;
+	// Without previous blocks there is nothing to synchronize with, so large text is split into blocks up front and blocks are scanned on multiple threads.
+	if (m_blocks.empty() && m_parallelParser.threads() > 1 && text.length() > m_parallelParser.chunkSize()) {
+		std::vector<std::string_view> parts;
+		for (size_t end = 0; position < text.length(); position = end) {
+			end = blockEnd(text, position);
+			parts.push_back(text.substr(position, end - position));
+		}
+		auto results = m_parallelParser.scan(parts, m_configuration);
+		size_t offset = 0;
+		for (size_t i = 0; i < parts.size(); i++) {
+			Block block;
+			block.offset = offset;
+			block.length = parts[i].length();
+			block.startState = results[i].startState;
+			block.failed = results[i].failed;
+			block.colorCount = results[i].colors.size();
+			colors.insert(colors.end(), results[i].colors.begin(), results[i].colors.end());
+			blocks.push_back(block);
+			offset += block.length;
+		}
+		m_scannedBytes = text.length();
+	}
+	while (position < text.length()) {
+		while (reusedBlock < m_blocks.size() && shiftedOffset(reusedBlock) < position)
+			reusedBlock++;
+		if (reusedBlock < m_blocks.size() && shiftedOffset(reusedBlock) == position) {
+			if (m_blocks[reusedBlock].startState == state) {
+				synchronized = true;
+				break;
+			}
+			reusedBlock++;
+		}
+		size_t end = blockEnd(text, position);
+		if (reusedBlock < m_blocks.size() && shiftedOffset(reusedBlock) < end)
+			end = shiftedOffset(reusedBlock);
+		Block block;
+		block.offset = position;
+		block.length = end - position;
+		block.startState = state;
+		size_t colorCount = colors.size();
+		StringTextFile textFile(text.substr(position, block.length), colors);
+		block.failed = !textFile.parse(m_configuration, state) || textFile.failed();
+		block.colorCount = colors.size() - colorCount;
+		blocks.push_back(block);
+		m_scannedBytes += block.length;
+		position = end;
+	}
+	size_t lastBlock = synchronized ? reusedBlock : m_blocks.size();
+	size_t removedColors = 0;
+	for (size_t i = firstBlock; i < lastBlock; i++)
+		removedColors += m_blocks[i].colorCount;
+	for (size_t i = lastBlock; i < m_blocks.size(); i++)
+		m_blocks[i].offset = shiftedOffset(i);
+	m_blocks.erase(m_blocks.begin() + firstBlock, m_blocks.begin() + lastBlock);
+	m_blocks.insert(m_blocks.begin() + firstBlock, blocks.begin(), blocks.end());
+	m_colors.erase(m_colors.begin() + firstColor, m_colors.begin() + firstColor + removedColors);
+	m_colors.insert(m_colors.begin() + firstColor, colors.begin(), colors.end());
+	m_failedBlocks = std::count_if(m_blocks.begin(), m_blocks.end(), [](const Block &block) {
+		return block.failed;
+	});
+	m_text.assign(text);
+	change.first = firstColor;
+	change.removed = reset ? previousColorCount : removedColors;
+	change.inserted = colors.size();
+	return m_failedBlocks == 0;
+}
+}
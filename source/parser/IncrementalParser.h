@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "TextFile.h"
+#include "ParallelParser.h"
+#include "Color.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+namespace text_file_parser {
+/**
+ * Text parser which remembers scanner state and found colors for blocks of lines.
+ * When text changes, only blocks containing changes are scanned again, scanning stops as soon as a block boundary with unchanged scanner state is reached.
+ */
+struct IncrementalParser {
+	/**
+	 * Range of colors replaced by the last parse.
+	 */
+	struct Change {
+		size_t first, removed, inserted;
+	};
+	/**
+	 * Create parser.
+	 * @param[in] blockSize Minimal block size in bytes. Blocks end after a newline character, so lines longer than block size form a single block.
+	 * @param[in] threads Number of threads used when large text is scanned from the start, zero selects hardware concurrency.
+	 */
+	IncrementalParser(size_t blockSize = 4096, size_t threads = 1);
+	/**
+	 * Parse text, reusing results of the previous parse for unchanged text.
+	 * All text is scanned again if configuration has changed.
+	 * @param[in] text Text.
+	 * @param[in] configuration Parser configuration.
+	 * @param[out] change Colors removed from and inserted into the color list since the previous parse.
+	 * @return True on success.
+	 */
+	bool parse(std::string_view text, const Configuration &configuration, Change &change);
+	/**
+	 * Forget previous text and parse results.
+	 */
+	void clear();
+	const std::vector<Color> &colors() const;
+	/**
+	 * Get number of bytes scanned during the last parse.
+	 * @return Scanned byte count.
+	 */
+	size_t scannedBytes() const;
+private:
+	struct Block {
+		size_t offset, length, colorCount;
+		State startState;
+		bool failed;
+	};
+	size_t m_blockSize, m_scannedBytes, m_failedBlocks;
+	bool m_initialized;
+	ParallelParser m_parallelParser;
+	Configuration m_configuration;
+	std::string m_text;
+	std::vector<Block> m_blocks;
+	std::vector<Color> m_colors;
+	size_t blockEnd(std::string_view text, size_t position) const;
+};
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ParallelParser.h"
+#include "Color.h"
+#include <algorithm>
+#include <atomic>
+#include <string_view>
+#include <thread>
+#include <vector>
+namespace text_file_parser {
+namespace {
+struct ChunkTextFile: public TextView {
+	std::vector<Color> m_colors;
+	bool m_outOfMemory, m_syntaxError;
+	size_t m_startLine, m_startColumn, m_endLine, m_endColumn;
+	State m_startState, m_endState;
+	ChunkTextFile():
+		m_outOfMemory(false),
+		m_syntaxError(false),
+		m_startLine(0),
+		m_startColumn(0),
+		m_endLine(0),
+		m_endColumn(0),
+		m_startState(State::normal),
+		m_endState(State::normal) {
+	}
+	virtual ~ChunkTextFile() {
+	}
+	virtual void outOfMemory() override {
+		m_outOfMemory = true;
+	}
+	virtual void syntaxError(size_t startLine, size_t startColumn, size_t endLine, size_t endColumn) override {
+		m_syntaxError = true;
+		m_startLine = startLine;
+		m_startColumn = startColumn;
+		m_endLine = endLine;
+		m_endColumn = endColumn;
+	}
+	virtual void addColor(const Color &color) override {
+		m_colors.push_back(color);
+	}
+	void scan(std::string_view text, const Configuration &configuration, State startState) {
+		setText(text);
+		m_colors.clear();
+		m_outOfMemory = m_syntaxError = false;
+		m_startState = m_endState = startState;
+		TextFile::parse(configuration, m_endState);
+	}
+};
+// Chunks are scanned on worker threads, assuming that all chunks except the first one start in normal state.
+void scanChunks(const std::vector<std::string_view> &chunks, const Configuration &configuration, State startState, size_t threadCount, std::vector<ChunkTextFile> &results) {
+	results.resize(chunks.size());
+	std::atomic<size_t> nextChunk(0);
+	std::vector<std::thread> threads;
+	threadCount = std::min(threadCount, chunks.size());
+	threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back([&]() {
+			for (size_t chunk = nextChunk++; chunk < chunks.size(); chunk = nextChunk++)
+				results[chunk].scan(chunks[chunk], configuration, chunk == 0 ? startState : State::normal);
+		});
+	}
+	for (auto &thread: threads)
+		thread.join();
+}
+}
+ParallelParser::ParallelParser(size_t chunkSize, size_t threads):
+	m_chunkSize(std::max<size_t>(chunkSize, 1)),
+	m_threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+}
+size_t ParallelParser::chunkSize() const {
+	return m_chunkSize;
+}
+size_t ParallelParser::threads() const {
+	return m_threads;
+}
+bool ParallelParser::parse(TextFile &textFile, const Configuration &configuration) const {
+	std::string_view text;
+	if (m_threads <= 1 || !textFile.contents(text) || text.length() <= m_chunkSize)
+		return textFile.parse(configuration);
+	std::vector<std::string_view> chunks;
+	for (size_t position = 0; position < text.length();) {
+		size_t end = text.length();
+		if (text.length() - position > m_chunkSize) {
+			auto newline = text.find('\n', position + m_chunkSize - 1);
+			if (newline != std::string_view::npos)
+				end = newline + 1;
+		}
+		chunks.push_back(text.substr(position, end - position));
+		position = end;
+	}
+	if (chunks.size() <= 1)
+		return textFile.parse(configuration);
+	std::vector<ChunkTextFile> results;
+	scanChunks(chunks, configuration, State::normal, m_threads, results);
+	// Results are merged in text order. A chunk scanned with wrong start state is scanned again, which can only happen when the previous chunk ends inside a multi-line comment.
+	State state = State::normal;
+	size_t line = 0;
+	for (size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+		auto &result = results[chunk];
+		if (result.m_startState != state)
+			result.scan(chunks[chunk], configuration, state);
+		for (const auto &color: result.m_colors)
+			textFile.addColor(color);
+		if (result.m_syntaxError) {
+			textFile.syntaxError(line + result.m_startLine, result.m_startColumn, line + result.m_endLine, result.m_endColumn);
+			return false;
+		}
+		if (result.m_outOfMemory) {
+			textFile.outOfMemory();
+			return true;
+		}
+		state = result.m_endState;
+		line += std::count(chunks[chunk].begin(), chunks[chunk].end(), '\n');
+	}
+	return true;
+}
+std::vector<ParallelParser::Part> ParallelParser::scan(const std::vector<std::string_view> &parts, const Configuration &configuration, State startState) const {
+	std::vector<ChunkTextFile> results;
+	scanChunks(parts, configuration, startState, m_threads, results);
+	std::vector<Part> output(parts.size());
+	State state = startState;
+	for (size_t part = 0; part < parts.size(); ++part) {
+		auto &result = results[part];
+		if (result.m_startState != state)
+			result.scan(parts[part], configuration, state);
+		output[part].startState = state;
+		output[part].endState = state = result.m_endState;
+		output[part].colors = std::move(result.m_colors);
+		output[part].failed = result.m_syntaxError || result.m_outOfMemory;
+	}
+	return output;
+}
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "TextFile.h"
+#include "Color.h"
+#include <cstddef>
+#include <string_view>
+#include <vector>
+namespace text_file_parser {
+/**
+ * Text parser which splits text available in memory into chunks after newline characters and scans chunks on multiple threads.
+ * Each chunk is scanned assuming it does not start inside a multi-line comment. If the previous chunk ends inside one, the chunk is scanned again with correct start state before its results are used.
+ * Colors and syntax error positions are the same as when text is parsed at once.
+ */
+struct ParallelParser {
+	/**
+	 * Result of scanning one part of text.
+	 */
+	struct Part {
+		State startState, endState;
+		std::vector<Color> colors;
+		bool failed;
+	};
+	/**
+	 * Create parser.
+	 * @param[in] chunkSize Minimal chunk size in bytes. Chunks end after a newline character, so lines longer than chunk size form a single chunk.
+	 * @param[in] threads Number of scanning threads, zero selects hardware concurrency.
+	 */
+	ParallelParser(size_t chunkSize = 1024 * 1024, size_t threads = 0);
+	/**
+	 * Parse text.
+	 * Text which is not available in memory, or fits into a single chunk, is parsed on the calling thread.
+	 * Colors and errors are reported to text file from the calling thread in text order.
+	 * @param[in,out] textFile Text file.
+	 * @param[in] configuration Parser configuration.
+	 * @return True on success.
+	 */
+	bool parse(TextFile &textFile, const Configuration &configuration) const;
+	/**
+	 * Scan text parts on multiple threads.
+	 * Each part is scanned starting in the end state of the previous part, so results are the same as when parts are parsed one after another. Unlike parse(), scanning continues after parts with errors.
+	 * @param[in] parts Text parts in text order, each part except the last one ending after a newline character.
+	 * @param[in] configuration Parser configuration.
+	 * @param[in] startState Scanner state at the start of the first part.
+	 * @return Results of each part.
+	 */
+	std::vector<Part> scan(const std::vector<std::string_view> &parts, const Configuration &configuration, State startState = State::normal) const;
+	size_t chunkSize() const;
+	size_t threads() const;
+private:
+	size_t m_chunkSize, m_threads;
+};
+}
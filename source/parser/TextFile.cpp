@@ -17,6 +17,8 @@
  */
 
 #include "TextFile.h"
+#include <algorithm>
+#include <cstring>
 namespace text_file_parser {
 Configuration::Configuration(bool initialValue) {
 	singleLineCComments = initialValue;
@@ -35,10 +37,57 @@ Configuration::Configuration(bool initialValue) {
 	floatValues = initialValue;
 	intValues = initialValue;
 }
-bool scanner(TextFile &text_file, const Configuration &configuration);
+bool Configuration::operator==(const Configuration &configuration) const {
+	return singleLineCComments == configuration.singleLineCComments &&
+		singleLineHashComments == configuration.singleLineHashComments &&
+		multiLineCComments == configuration.multiLineCComments &&
+		shortHex == configuration.shortHex &&
+		fullHex == configuration.fullHex &&
+		shortHexWithAlpha == configuration.shortHexWithAlpha &&
+		fullHexWithAlpha == configuration.fullHexWithAlpha &&
+		cssRgb == configuration.cssRgb &&
+		cssRgba == configuration.cssRgba &&
+		cssHsl == configuration.cssHsl &&
+		cssHsla == configuration.cssHsla &&
+		cssOklch == configuration.cssOklch &&
+		cssOklab == configuration.cssOklab &&
+		floatValues == configuration.floatValues &&
+		intValues == configuration.intValues;
+}
+bool Configuration::operator!=(const Configuration &configuration) const {
+	return !(*this == configuration);
+}
+bool scanner(TextFile &text_file, const Configuration &configuration, State &state);
 bool TextFile::parse(const Configuration &configuration) {
-	return scanner(*this, configuration);
+	State state = State::normal;
+	return scanner(*this, configuration, state);
+}
+bool TextFile::parse(const Configuration &configuration, State &state) {
+	return scanner(*this, configuration, state);
 }
 TextFile::~TextFile() {
 }
+bool TextFile::contents(std::string_view &) {
+	return false;
+}
+TextView::TextView(std::string_view text):
+	m_text(text),
+	m_position(0) {
+}
+TextView::~TextView() {
+}
+size_t TextView::read(char *buffer, size_t length) {
+	length = std::min(length, m_text.length() - m_position);
+	std::memcpy(buffer, m_text.data() + m_position, length);
+	m_position += length;
+	return length;
+}
+bool TextView::contents(std::string_view &contents) {
+	contents = m_text;
+	return true;
+}
+void TextView::setText(std::string_view text) {
+	m_text = text;
+	m_position = 0;
+}
 }
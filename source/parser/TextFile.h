@@ -18,10 +18,13 @@
 
 #pragma once
 #include <cstddef>
+#include <string_view>
 struct Color;
 namespace text_file_parser {
 struct Configuration {
 	Configuration(bool initialValue = true);
+	bool operator==(const Configuration &configuration) const;
+	bool operator!=(const Configuration &configuration) const;
 	bool singleLineCComments;
 	bool singleLineHashComments;
 	bool multiLineCComments;
@@ -38,12 +41,48 @@ struct Configuration {
 	bool floatValues;
 	bool intValues;
 };
+/**
+ * Scanner state at line boundaries.
+ */
+enum struct State {
+	normal,
+	multiLineComment,
+};
 struct TextFile {
 	bool parse(const Configuration &configuration);
+	/**
+	 * Parse text starting in specified scanner state.
+	 * Text parsed in parts split after newline characters produces the same colors as text parsed at once, if end state of each part is used as start state of the next one.
+	 * @param[in] configuration Parser configuration.
+	 * @param[in,out] state Scanner state at the start of text, set to scanner state at the end of text.
+	 * @return True on success.
+	 */
+	bool parse(const Configuration &configuration, State &state);
 	virtual ~TextFile();
 	virtual void outOfMemory() = 0;
 	virtual void syntaxError(size_t startLine, size_t startColumn, size_t endLine, size_t endColunn) = 0;
 	virtual size_t read(char *buffer, size_t length) = 0;
+	/**
+	 * Get whole text, if it is available in memory.
+	 * Scanner runs directly over returned text instead of reading it in chunks, so there is no token length limit.
+	 * @param[out] contents Text, which must stay valid until parsing ends.
+	 * @return True if text is available.
+	 */
+	virtual bool contents(std::string_view &contents);
 	virtual void addColor(const Color &color) = 0;
 };
+/**
+ * Text file with text available in memory, for example memory mapped file or text from user interface.
+ */
+struct TextView: public TextFile {
+	TextView(std::string_view text = std::string_view());
+	virtual ~TextView();
+	virtual size_t read(char *buffer, size_t length) override;
+	virtual bool contents(std::string_view &contents) override;
+protected:
+	void setText(std::string_view text);
+private:
+	std::string_view m_text;
+	size_t m_position;
+};
 }
@@ -23,6 +23,7 @@
 #include <functional>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cmath>
 #include <algorithm>
 #include <cstdint>
@@ -41,18 +42,18 @@ struct FSM {
 	int cs;
 	int act;
 	char ws;
-	char *ts, *te;
+	const char *ts, *te, *start;
 	char buffer[8 * 1024];
-	int line, column, lineStart, bufferOffset;
+	int line, column, lineStart;
 	int64_t numberI64;
 	std::vector<std::pair<int64_t, Unit>> numbersI64;
-	char *numberStart;
+	const char *numberStart;
 	std::vector<std::pair<double, Unit>> numbersDouble;
 	std::function<void(const Color&)> addColor;
 	void handleNewline() {
 		line++;
 		column = 0;
-		lineStart = te - buffer;
+		lineStart = te - start;
 	}
 	int hexToInt(char hex) {
 		if (hex >= '0' && hex <= '9') return hex - '0';
@@ -70,6 +71,7 @@ struct FSM {
 		color.green = hexPairToInt(ts + startIndex + 2) / 255.0f;
 		color.blue = hexPairToInt(ts + startIndex + 4) / 255.0f;
 		color.alpha = 1;
+		clearNumberStacks();
 		addColor(color);
 	}
 	void colorHexShort(bool withHashSymbol) {
@@ -79,6 +81,7 @@ struct FSM {
 		color.green = hexToInt(ts[startIndex + 1]) / 15.0f;
 		color.blue = hexToInt(ts[startIndex + 2]) / 15.0f;
 		color.alpha = 1;
+		clearNumberStacks();
 		addColor(color);
 	}
 	void colorHexWithAlphaFull(bool withHashSymbol) {
@@ -88,6 +91,7 @@ struct FSM {
 		color.green = hexPairToInt(ts + startIndex + 2) / 255.0f;
 		color.blue = hexPairToInt(ts + startIndex + 4) / 255.0f;
 		color.alpha = hexPairToInt(ts + startIndex + 6) / 255.0f;
+		clearNumberStacks();
 		addColor(color);
 	}
 	void colorHexWithAlphaShort(bool withHashSymbol) {
@@ -97,6 +101,7 @@ struct FSM {
 		color.green = hexToInt(ts[startIndex + 1]) / 15.0f;
 		color.blue = hexToInt(ts[startIndex + 2]) / 15.0f;
 		color.alpha = hexToInt(ts[startIndex + 3]) / 15.0f;
+		clearNumberStacks();
 		addColor(color);
 	}
 	float getPercentage(size_t index, double unitlessMultiplier = 1.0, double percentageMultiplier = 1.0, double percentageOffset = 0) const {
@@ -142,7 +147,7 @@ struct FSM {
 		color.green = getPercentage(1, 1.0 / 255);
 		color.blue = getPercentage(2, 1.0 / 255);
 		color.alpha = numbersDouble.size() == 4 ? getPercentage(3) : 1;
-		numbersDouble.clear();
+		clearNumberStacks();
 		addColor(color);
 	}
 	void colorHsl() {
@@ -151,7 +156,7 @@ struct FSM {
 		color.hsl.saturation = getPercentage(1);
 		color.hsl.lightness = getPercentage(2);
 		color.alpha = numbersDouble.size() == 4 ? getPercentage(3) : 1;
-		numbersDouble.clear();
+		clearNumberStacks();
 		addColor(color.normalizeRgb().hslToRgb());
 	}
 	void colorOklch() {
@@ -160,7 +165,7 @@ struct FSM {
 		color.oklch.C = getPercentage(1, 1.0, 0.4);
 		color.oklch.h = getDegrees(2) * 360.0f;
 		color.alpha = numbersDouble.size() == 4 ? getPercentage(3) : 1;
-		numbersDouble.clear();
+		clearNumberStacks();
 		addColor(color.oklchToRgb().normalizeRgb());
 	}
 	void colorOklab() {
@@ -169,7 +174,7 @@ struct FSM {
 		color.oklab.a = getPercentage(1, 1.0, 0.8, -0.4);
 		color.oklab.b = getPercentage(2, 1.0, 0.8, -0.4);
 		color.alpha = numbersDouble.size() == 4 ? getPercentage(3) : 1;
-		numbersDouble.clear();
+		clearNumberStacks();
 		addColor(color.oklabToRgb().normalizeRgb());
 	}
 	void colorValues() {
@@ -181,7 +186,7 @@ struct FSM {
 			color.alpha = static_cast<float>(numbersDouble[3].first);
 		else
 			color.alpha = 1;
-		numbersDouble.clear();
+		clearNumberStacks();
 		addColor(color);
 	}
 	void colorValueIntegers() {
@@ -193,7 +198,7 @@ struct FSM {
 			color.alpha = numbersI64[3].first / 255.0f;
 		else
 			color.alpha = 1;
-		numbersI64.clear();
+		clearNumberStacks();
 		addColor(color);
 	}
 	double parseDouble(const char *start, const char *end) {
@@ -279,9 +284,9 @@ struct FSM {
 		( integer ws+ integer ws+ integer (ws+ integer)? ) when intValues { fsm.colorValueIntegers(); };
 		( number ws* separator ws* number ws* separator ws* number (ws* separator ws* number)? ) when floatValues { fsm.colorValues(); };
 		( number ws+ number ws+ number (ws+ number)? ) when floatValues { fsm.colorValues(); };
-		( '//' ) when singleLineCComments { fgoto singleLineComment; };
-		( '/*' ) when multiLineCComments { fgoto multiLineComment; };
-		( '#' ) when singleLineHashComments { fgoto singleLineComment; };
+		( '//' ) when singleLineCComments { fsm.clearNumberStacks(); fgoto singleLineComment; };
+		( '/*' ) when multiLineCComments { fsm.clearNumberStacks(); fgoto multiLineComment; };
+		( '#' ) when singleLineHashComments { fsm.clearNumberStacks(); fgoto singleLineComment; };
 		( any - newline ) { fsm.clearNumberStacks(); };
 		( newline ) { fsm.clearNumberStacks(); };
 		*|;
@@ -289,49 +294,64 @@ struct FSM {
 
 %% write data;
 
-bool scanner(TextFile &textFile, const Configuration &configuration) {
+bool scanner(TextFile &textFile, const Configuration &configuration, State &state) {
 	FSM fsm = {};
 	bool parseError = false;
 	fsm.addColor = [&textFile](const Color &color) {
 		textFile.addColor(color.normalizeRgb());
 	};
 	%% write init;
+	if (state == State::multiLineComment)
+		fsm.cs = text_file_en_multiLineComment;
+	// Text available in memory is scanned in place, otherwise it is read into a buffer in chunks.
+	std::string_view contents;
+	bool inPlace = textFile.contents(contents);
+	fsm.start = inPlace ? contents.data() : fsm.buffer;
 	int have = 0;
-	while (1) {
-		char *p = fsm.buffer + have;
-		int ws = sizeof(fsm.buffer) - have;
-		if (ws == 0) {
-			textFile.outOfMemory();
-			break;
-		}
-		char *eof = 0;
-		auto readSize = textFile.read(fsm.buffer + have, ws);
-		char *pe = p + readSize;
-		if (readSize > 0) {
-			if (readSize < sizeof(fsm.buffer))
-				eof = pe;
-			%% write exec;
-			if (fsm.cs == text_file_error) {
-				parseError = true;
-				textFile.syntaxError(fsm.line, fsm.ts - fsm.buffer - fsm.lineStart, fsm.line, fsm.te - fsm.buffer - fsm.lineStart);
+	bool done = false;
+	while (!done) {
+		const char *p, *pe, *eof = nullptr;
+		if (inPlace) {
+			p = contents.data();
+			pe = eof = p + contents.length();
+			done = true;
+		} else {
+			p = fsm.buffer + have;
+			size_t ws = sizeof(fsm.buffer) - have;
+			if (ws == 0) {
+				textFile.outOfMemory();
 				break;
 			}
-			if (fsm.ts == 0) {
-				have = 0;
-				fsm.lineStart -= sizeof(fsm.buffer);
-			} else {
-				have = pe - fsm.ts;
-				std::memmove(fsm.buffer, fsm.ts, have);
-				int bufferMovement = fsm.ts - fsm.buffer;
-				fsm.te -= bufferMovement;
-				fsm.lineStart -= bufferMovement;
-				fsm.ts = fsm.buffer;
-				fsm.bufferOffset += fsm.ts - fsm.buffer;
+			auto readSize = textFile.read(fsm.buffer + have, ws);
+			pe = p + readSize;
+			if (readSize < ws) {
+				eof = pe;
+				done = true;
 			}
-		} else {
+		}
+		%% write exec;
+		if (fsm.cs == text_file_error) {
+			parseError = true;
+			textFile.syntaxError(fsm.line, fsm.ts - fsm.start - fsm.lineStart, fsm.line, fsm.te - fsm.start - fsm.lineStart);
+			break;
+		}
+		if (done)
 			break;
+		if (fsm.ts == 0) {
+			have = 0;
+			fsm.lineStart -= pe - fsm.buffer;
+		} else {
+			have = pe - fsm.ts;
+			int bufferMovement = fsm.ts - fsm.buffer;
+			std::memmove(fsm.buffer, fsm.ts, have);
+			fsm.te -= bufferMovement;
+			if (fsm.numberStart && fsm.numberStart >= fsm.ts)
+				fsm.numberStart -= bufferMovement;
+			fsm.lineStart -= bufferMovement;
+			fsm.ts = fsm.buffer;
 		}
 	}
+	state = fsm.cs == text_file_en_multiLineComment ? State::multiLineComment : State::normal;
 	return parseError == false;
 }
 }
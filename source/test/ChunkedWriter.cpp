@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "common/ChunkedWriter.h"
+#include <sstream>
+#include <string>
+using namespace common;
+namespace {
+std::string expected(size_t count) {
+	std::ostringstream stream;
+	for (size_t i = 0; i < count; ++i)
+		stream << i << ' ' << i * 0.5 << '\n';
+	return stream.str();
+}
+std::string write(const ChunkedWriter &writer, size_t count) {
+	std::ostringstream stream;
+	BOOST_CHECK(writer.write(stream, count, [](size_t index, std::ostream &stream) {
+		stream << index << ' ' << index * 0.5 << '\n';
+	}));
+	return stream.str();
+}
+}
+BOOST_AUTO_TEST_SUITE(chunkedWriter)
+BOOST_AUTO_TEST_CASE(empty) {
+	BOOST_CHECK_EQUAL(write(ChunkedWriter(4, 4), 0), "");
+}
+BOOST_AUTO_TEST_CASE(itemOrder) {
+	for (size_t threads: { 1, 2, 3, 8 }) {
+		for (size_t count: { 1, 7, 8, 9, 100, 1000 }) {
+			BOOST_CHECK_EQUAL(write(ChunkedWriter(8, threads), count), expected(count));
+		}
+	}
+}
+BOOST_AUTO_TEST_CASE(streamFormat) {
+	std::ostringstream stream;
+	stream.precision(2);
+	stream.setf(std::ios::fixed);
+	BOOST_CHECK(ChunkedWriter(2, 2).write(stream, 5, [](size_t index, std::ostream &stream) {
+		stream << index / 3.0 << ';';
+	}));
+	BOOST_CHECK_EQUAL(stream.str(), "0.00;0.33;0.67;1.00;1.33;");
+}
+BOOST_AUTO_TEST_CASE(writeError) {
+	std::ostringstream stream;
+	stream.setstate(std::ios::badbit);
+	BOOST_CHECK(!ChunkedWriter(4, 4).write(stream, 100, [](size_t index, std::ostream &stream) {
+		stream << index;
+	}));
+}
+BOOST_AUTO_TEST_SUITE_END()
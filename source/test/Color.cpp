@@ -20,6 +20,8 @@
 #include "Common.h"
 #include "Color.h"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 namespace {
 const Color testColor = { 0.5f, 0.25f, 0.1f, 1.0f };
 struct Initialize {
@@ -168,4 +170,29 @@ BOOST_AUTO_TEST_CASE(sRGBMatrix) {
 	auto result = Color(Color::sRGBInvertedMatrix * (Color::sRGBMatrix * testColor.rgbVector<double>()));
 	BOOST_CHECK_EQUAL(result, testColor);
 }
+BOOST_AUTO_TEST_CASE(linearRgbChannel) {
+	for (int i = 0; i < 256; i++) {
+		BOOST_CHECK_EQUAL(Color::linearRgbChannel(static_cast<uint8_t>(i)), Color(i, i, i).linearRgb().red);
+	}
+}
+BOOST_AUTO_TEST_CASE(fastGamma) {
+	const int steps = 1 << 20;
+	float maxLinearError = 0, maxNonLinearError = 0;
+	for (int i = -16; i <= steps + 16; i++) {
+		float value = static_cast<float>(i) / steps;
+		Color color(value, value, value);
+		Color::setGammaMode(GammaMode::exact);
+		Color linear = color.linearRgb(), nonLinear = color.nonLinearRgb();
+		Color::setGammaMode(GammaMode::fast);
+		Color fastLinear = color.linearRgb(), fastNonLinear = color.nonLinearRgb();
+		maxLinearError = std::max(maxLinearError, std::abs(fastLinear.red - linear.red));
+		maxNonLinearError = std::max(maxNonLinearError, std::abs(fastNonLinear.red - nonLinear.red));
+		BOOST_REQUIRE(Color(color).linearRgbInplace() == fastLinear);
+		BOOST_REQUIRE(Color(color).nonLinearRgbInplace() == fastNonLinear);
+	}
+	Color::setGammaMode(GammaMode::exact);
+	BOOST_TEST_MESSAGE("maximum errors: " << maxLinearError << ", " << maxNonLinearError);
+	BOOST_CHECK_LE(maxLinearError, 3e-7f);
+	BOOST_CHECK_LE(maxNonLinearError, 3e-7f);
+}
 BOOST_AUTO_TEST_SUITE_END()
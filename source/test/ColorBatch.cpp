@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ColorBatch.h"
+#include "Color.h"
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+	~Initialize() {
+		batch::setImplementation(batch::bestImplementation());
+	}
+};
+struct Tolerance {
+	float values[3];
+	bool hue[3];
+};
+void checkConversion(void (*convert)(const batch::Colors &, const batch::Colors &), std::function<Color(const Color &)> convertColor, const Tolerance &tolerance) {
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<float> channel(0.0f, 1.0f);
+	const size_t count = 1003;
+	std::vector<float> input[3];
+	for (auto &values: input)
+		values.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		for (int j = 0; j < 3; ++j)
+			input[j][i] = i < 8 ? (i & (1 << j) ? 1.0f : 0.0f) : (i < 16 ? 0.5f : channel(generator));
+	}
+	for (auto implementation: { batch::Implementation::scalar, batch::Implementation::sse2, batch::Implementation::avx2 }) {
+		if (batch::setImplementation(implementation) != implementation)
+			continue;
+		std::vector<float> output[3];
+		for (auto &values: output)
+			values.resize(count);
+		convert(batch::Colors(input[0].data(), input[1].data(), input[2].data(), count), batch::Colors(output[0].data(), output[1].data(), output[2].data(), count));
+		for (size_t i = 0; i < count; ++i) {
+			Color expected = convertColor(Color(input[0][i], input[1][i], input[2][i]));
+			for (int j = 0; j < 3; ++j) {
+				float difference = std::abs(output[j][i] - expected.data[j]);
+				if (tolerance.hue[j]) {
+					float period = j == 0 ? 1.0f : 360.0f;
+					difference = std::min(difference, period - difference);
+					if (j == 2 && expected.data[1] < 1e-2f)
+						continue;
+				}
+				BOOST_CHECK_SMALL(difference, tolerance.values[j]);
+			}
+		}
+	}
+}
+}
+BOOST_FIXTURE_TEST_SUITE(colorBatch, Initialize)
+BOOST_AUTO_TEST_CASE(linearRgb) {
+	checkConversion(batch::linearRgb, [](const Color &color) {
+		return color.linearRgb();
+	}, { { 1e-4f, 1e-4f, 1e-4f }, { false, false, false } });
+}
+BOOST_AUTO_TEST_CASE(rgbToLabD50) {
+	checkConversion(batch::rgbToLabD50, [](const Color &color) {
+		return color.rgbToLabD50();
+	}, { { 1e-3f, 1e-3f, 1e-3f }, { false, false, false } });
+}
+BOOST_AUTO_TEST_CASE(rgbToLchD50) {
+	checkConversion(batch::rgbToLchD50, [](const Color &color) {
+		return color.rgbToLchD50();
+	}, { { 1e-3f, 1e-3f, 1e-2f }, { false, false, true } });
+}
+BOOST_AUTO_TEST_CASE(rgbToOklab) {
+	checkConversion(batch::rgbToOklab, [](const Color &color) {
+		return color.rgbToOklab();
+	}, { { 1e-4f, 1e-4f, 1e-4f }, { false, false, false } });
+}
+BOOST_AUTO_TEST_CASE(rgbToHsl) {
+	checkConversion(batch::rgbToHsl, [](const Color &color) {
+		return color.rgbToHsl();
+	}, { { 1e-4f, 1e-4f, 1e-4f }, { true, false, false } });
+}
+BOOST_AUTO_TEST_CASE(rgbToHsv) {
+	checkConversion(batch::rgbToHsv, [](const Color &color) {
+		return color.rgbToHsv();
+	}, { { 1e-4f, 1e-4f, 1e-4f }, { true, false, false } });
+}
+BOOST_AUTO_TEST_CASE(inplace) {
+	std::vector<float> values[3] = { { 0.1f, 0.5f, 0.9f, 0.2f, 0.3f }, { 0.4f, 0.5f, 0.1f, 0.2f, 0.3f }, { 0.7f, 0.5f, 0.3f, 0.2f, 0.3f } };
+	batch::Colors colors(values[0].data(), values[1].data(), values[2].data(), values[0].size());
+	batch::rgbToHsv(colors, colors);
+	Color expected = Color(0.9f, 0.1f, 0.3f).rgbToHsv();
+	BOOST_CHECK_SMALL(std::abs(values[0][2] - expected.hsv.hue), 1e-4f);
+	BOOST_CHECK_SMALL(std::abs(values[1][2] - expected.hsv.saturation), 1e-4f);
+	BOOST_CHECK_SMALL(std::abs(values[2][2] - expected.hsv.value), 1e-4f);
+}
+BOOST_AUTO_TEST_SUITE_END()
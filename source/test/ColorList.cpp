@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "IPalette.h"
+#include <string>
+#include <vector>
+namespace {
+struct RecordingPalette: public IPalette {
+	std::vector<ColorObject *> rows;
+	size_t rangeCalls = 0;
+	virtual void add(ColorList &, ColorObject *colorObject) override {
+		rows.push_back(colorObject);
+	}
+	virtual void insert(ColorList &, ColorObject *colorObject, size_t position) override {
+		rows.insert(rows.begin() + position, colorObject);
+	}
+	virtual void insertRange(ColorList &, common::Span<ColorObject *const> colorObjects, size_t position) override {
+		rangeCalls++;
+		auto at = position == IPalette::append ? rows.end() : rows.begin() + position;
+		rows.insert(at, colorObjects.data(), colorObjects.data() + colorObjects.size());
+	}
+	virtual void remove(ColorList &, ColorObject *) override {
+	}
+	virtual void removeRange(ColorList &, size_t first, size_t count) override {
+		rows.erase(rows.begin() + first, rows.begin() + first + count);
+	}
+	virtual void removeSelected(ColorList &) override {
+	}
+	virtual void clear(ColorList &) override {
+		rows.clear();
+	}
+	virtual void update(ColorList &) override {
+	}
+};
+std::vector<ColorObject> makeColors(size_t count, const char *prefix) {
+	std::vector<ColorObject> colorObjects;
+	for (size_t i = 0; i < count; i++)
+		colorObjects.emplace_back(prefix + std::to_string(i), Color(i / static_cast<float>(count), 0.5f, 0.25f));
+	return colorObjects;
+}
+void checkRows(ColorList &colorList, const RecordingPalette &palette) {
+	BOOST_REQUIRE_EQUAL(palette.rows.size(), colorList.size());
+	size_t index = 0;
+	for (auto *colorObject: colorList)
+		BOOST_CHECK(palette.rows[index++] == colorObject);
+}
+}
+BOOST_AUTO_TEST_SUITE(colorList)
+BOOST_AUTO_TEST_CASE(addRange) {
+	RecordingPalette palette;
+	ColorList colorList(palette);
+	colorList.add(ColorObject("first", Color(0.0f, 0.0f, 0.0f)));
+	auto colorObjects = makeColors(1000, "range ");
+	colorList.addRange(common::Span<const ColorObject>(colorObjects.data(), colorObjects.size()));
+	BOOST_CHECK_EQUAL(palette.rangeCalls, 1u);
+	BOOST_REQUIRE_EQUAL(colorList.size(), 1001u);
+	checkRows(colorList, palette);
+	size_t index = 0;
+	for (auto *colorObject: colorList) {
+		if (index > 0) {
+			BOOST_CHECK(colorObject != &colorObjects[index - 1]);
+			BOOST_CHECK_EQUAL(colorObject->getName(), colorObjects[index - 1].getName());
+		}
+		index++;
+	}
+	colorList.addRange(common::Span<const ColorObject>());
+	BOOST_CHECK_EQUAL(palette.rangeCalls, 1u);
+}
+BOOST_AUTO_TEST_CASE(addList) {
+	RecordingPalette palette;
+	ColorList colorList(palette), source;
+	auto colorObjects = makeColors(10, "");
+	source.addRange(common::Span<const ColorObject>(colorObjects.data(), colorObjects.size()));
+	colorList.add(source);
+	BOOST_CHECK_EQUAL(palette.rangeCalls, 1u);
+	checkRows(colorList, palette);
+	BOOST_CHECK(*colorList.begin() == *source.begin());
+	BOOST_CHECK_EQUAL((*colorList.begin())->references(), 2u);
+}
+BOOST_AUTO_TEST_CASE(insertRange) {
+	RecordingPalette palette;
+	ColorList colorList(palette);
+	auto colorObjects = makeColors(4, "");
+	colorList.addRange(common::Span<const ColorObject>(colorObjects.data(), colorObjects.size()));
+	std::vector<ColorObject *> inserted;
+	for (size_t i = 0; i < 3; i++)
+		inserted.push_back(new ColorObject("inserted", Color(1.0f, 1.0f, 1.0f)));
+	colorList.insertRange(common::Span<ColorObject *const>(inserted.data(), inserted.size()), 2, true);
+	BOOST_CHECK_EQUAL(palette.rangeCalls, 2u);
+	checkRows(colorList, palette);
+	std::vector<std::string> names;
+	for (auto *colorObject: colorList)
+		names.push_back(colorObject->getName());
+	BOOST_CHECK((names == std::vector<std::string> { "0", "1", "inserted", "inserted", "inserted", "2", "3" }));
+	colorList.insertRange(common::Span<ColorObject *const>(inserted.data(), inserted.size()), 0);
+	BOOST_CHECK_EQUAL(palette.rangeCalls, 2u);
+	BOOST_CHECK_EQUAL(colorList.size(), 10u);
+	BOOST_CHECK_EQUAL(inserted[0]->references(), 3u);
+	for (auto *colorObject: inserted)
+		colorObject->release();
+}
+BOOST_AUTO_TEST_CASE(insertRangePastEnd) {
+	RecordingPalette palette;
+	ColorList colorList(palette);
+	auto colorObjects = makeColors(2, "");
+	colorList.addRange(common::Span<const ColorObject>(colorObjects.data(), colorObjects.size()));
+	auto *inserted = new ColorObject("inserted", Color(1.0f, 1.0f, 1.0f));
+	colorList.insertRange(common::Span<ColorObject *const>(&inserted, 1), 100, true);
+	checkRows(colorList, palette);
+	BOOST_REQUIRE_EQUAL(colorList.size(), 3u);
+	BOOST_CHECK(colorList.back() == inserted);
+	inserted->release();
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2009-2020, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "Converter.h"
+#include "ColorObject.h"
+#include "lua/Script.h"
+#include "lua/Ref.h"
+#include "lua/ColorObject.h"
+#include "lua/Lua.h"
+#include <string>
+#include <vector>
+using namespace lua;
+namespace {
+Ref loadFunction(Script &script, const char *code) {
+	lua_State *L = script;
+	BOOST_REQUIRE(script.loadCode(code));
+	BOOST_REQUIRE(script.run(0, 1));
+	Ref ref(L, -1);
+	lua_pop(L, 1);
+	return ref;
+}
+}
+BOOST_AUTO_TEST_SUITE(converter)
+BOOST_AUTO_TEST_CASE(serializeBatch) {
+	Script script;
+	lua_State *L = script;
+	registerColorObject(L);
+	lua_pop(L, 1);
+	Converter converter("batch", "Batch", Ref(), Ref());
+	converter.serializeBatch(loadFunction(script, R"(return function(colorObjects, position)
+		local result = {}
+		for i, colorObject in ipairs(colorObjects) do
+			result[i] = colorObject:getName() .. '@' .. (position.index + i - 1) .. '/' .. position.count
+		end
+		return result
+	end)"));
+	BOOST_CHECK(converter.hasSerialize());
+	std::vector<ColorObject> colorObjects;
+	for (size_t i = 0; i < 2500; i++)
+		colorObjects.emplace_back(std::to_string(i), Color(0.5f));
+	std::vector<const ColorObject *> pointers;
+	for (auto &colorObject: colorObjects)
+		pointers.push_back(&colorObject);
+	auto results = converter.serialize(pointers);
+	BOOST_REQUIRE_EQUAL(results.size(), colorObjects.size());
+	for (size_t i = 0; i < results.size(); i++)
+		BOOST_CHECK_EQUAL(results[i], std::to_string(i) + "@" + std::to_string(i) + "/2500");
+	BOOST_CHECK_EQUAL(converter.serialize(colorObjects[7], ConverterSerializePosition(10, 7)), "7@7/10");
+	BOOST_CHECK_EQUAL(lua_gettop(L), 0);
+}
+BOOST_AUTO_TEST_CASE(serializeBatchInvalidResult) {
+	Script script;
+	lua_State *L = script;
+	registerColorObject(L);
+	lua_pop(L, 1);
+	Converter converter("batch", "Batch", Ref(), Ref());
+	converter.serializeBatch(loadFunction(script, R"(return function(colorObjects, position)
+		if position.index > 0 then
+			error('failed')
+		end
+		local result = {}
+		for i = 1, #colorObjects do
+			result[i] = 'ok'
+		end
+		result[2] = {}
+		return result
+	end)"));
+	std::vector<ColorObject> colorObjects(1500, ColorObject("", Color(0.5f)));
+	std::vector<const ColorObject *> pointers;
+	for (auto &colorObject: colorObjects)
+		pointers.push_back(&colorObject);
+	auto results = converter.serialize(pointers);
+	BOOST_REQUIRE_EQUAL(results.size(), colorObjects.size());
+	BOOST_CHECK_EQUAL(results[0], "ok");
+	BOOST_CHECK(results[1].empty());
+	BOOST_CHECK_EQUAL(results[1023], "ok");
+	BOOST_CHECK(results[1024].empty());
+	BOOST_CHECK_EQUAL(lua_gettop(L), 0);
+}
+BOOST_AUTO_TEST_SUITE_END()
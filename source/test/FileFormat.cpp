@@ -24,6 +24,7 @@
 #include <string_view>
 #include <sstream>
 #include <fstream>
+#include <cstdio>
 BOOST_AUTO_TEST_SUITE(fileFormat)
 const struct ColorAndName {
 	Color color;
@@ -110,4 +111,26 @@ BOOST_AUTO_TEST_CASE(load) {
 		BOOST_CHECK_MESSAGE(loaded[i].name == savedColors[i].name, "loaded wrong name at index " << i << ", " << loaded[i].name << " != " << savedColors[i].name);
 	}
 }
+BOOST_AUTO_TEST_CASE(loadMissingFile) {
+	ColorList colors;
+	auto result = paletteFileLoad("test/missing.gpa", colors);
+	BOOST_REQUIRE(!result);
+	BOOST_CHECK(result.error() == ErrorCode::fileCouldNotBeOpened);
+	BOOST_CHECK_EQUAL(colors.size(), 0u);
+}
+BOOST_AUTO_TEST_CASE(loadTruncated) {
+	std::ifstream goodFile("test/palette-0.3.gpa", std::ios::binary);
+	BOOST_REQUIRE(goodFile.is_open());
+	std::string data((std::istreambuf_iterator<char>(goodFile)), std::istreambuf_iterator<char>());
+	{
+		std::ofstream truncatedFile("test/truncated.gpa", std::ios::binary | std::ios::trunc);
+		truncatedFile.write(data.data(), data.size() / 2);
+	}
+	ColorList colors;
+	auto result = paletteFileLoad("test/truncated.gpa", colors);
+	std::remove("test/truncated.gpa");
+	BOOST_REQUIRE(!result);
+	BOOST_CHECK(result.error() == ErrorCode::readFailed);
+	BOOST_CHECK_EQUAL(colors.size(), 0u);
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,11 @@
 #include "InternalConverters.h"
 #include "ColorObject.h"
 #include "Common.h"
+#include "common/First.h"
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
 BOOST_AUTO_TEST_SUITE(internalConverters)
 BOOST_AUTO_TEST_CASE(webHex) {
 	Converter::Options options = {};
@@ -555,4 +560,176 @@ BOOST_AUTO_TEST_CASE(valueRgba) {
 			BOOST_CHECK_MESSAGE(colorObject.getColor() == colors[i].color, "wrong color at index " << i << ", " << colorObject.getColor() << " != " << colors[i].color);
 	}
 }
+BOOST_AUTO_TEST_CASE(inputClassification) {
+	BOOST_CHECK(ConverterInput("").flags() == ConverterInputFlags::none);
+	BOOST_CHECK(ConverterInput("#204").has(ConverterInputFlags::hash3));
+	BOOST_CHECK(!ConverterInput("#204").has(ConverterInputFlags::hash4));
+	BOOST_CHECK(ConverterInput("##20408040").has(ConverterInputFlags::hash8));
+	BOOST_CHECK(!ConverterInput("# 204080").has(ConverterInputFlags::hash3));
+	BOOST_CHECK(ConverterInput("# 204080").has(ConverterInputFlags::hex6));
+	BOOST_CHECK(ConverterInput("color: rgb(1 2 3)").has(ConverterInputFlags::rgbFunction));
+	BOOST_CHECK(!ConverterInput("rgba(1 2 3)").has(ConverterInputFlags::rgbFunction));
+	BOOST_CHECK(ConverterInput("rgba(1 2 3)").has(ConverterInputFlags::rgbaFunction | ConverterInputFlags::numbers3));
+	BOOST_CHECK(ConverterInput("1.5e3 -.5 +2").has(ConverterInputFlags::numbers3));
+	BOOST_CHECK(!ConverterInput("1.5.5").has(ConverterInputFlags::numbers3));
+	BOOST_CHECK(ConverterInput("1;2\t3,4").has(ConverterInputFlags::numbers4 | ConverterInputFlags::comma | ConverterInputFlags::semicolon | ConverterInputFlags::tab));
+}
+BOOST_AUTO_TEST_CASE(inputClassificationAcceptsAllMatches) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	std::vector<std::string> texts = {
+		"", "#", "##204080", "# 204080", "20408", "1,1,,1,", "1.5.5, 2, 3", "+.5 -1e2 3", "rgb( 1 , 2 , 3 )", "hsl(1, 2%, 3% / 4)", "oklch(1% 0.2 3)",
+	};
+	const char *wrappers[][2] = { { "", "" }, { " ", " " }, { "color: ", ";" }, { "[", "]\t" }, { "x", "x" } };
+	for (int variant = 0; variant < 16; variant++) {
+		options.upperCaseHex = variant & 1;
+		options.cssPercentages = variant & 2;
+		options.cssAlphaPercentage = variant & 4;
+		options.cssCommaSeparators = variant & 8;
+		for (int i = 0; i < 27; i++) {
+			Color color(i % 3 / 2.0f, i / 3 % 3 / 2.0f, i / 9 / 2.0f, (i % 2) * 0.5f + 0.25f);
+			for (auto *converter: converters.all()) {
+				if (!converter->hasSerialize())
+					continue;
+				auto text = converter->serialize(color);
+				for (auto &wrapper: wrappers)
+					texts.push_back(wrapper[0] + text + wrapper[1]);
+			}
+		}
+	}
+	ColorObject colorObject;
+	float quality;
+	for (auto *converter: converters.all()) {
+		if (!converter->hasDeserialize())
+			continue;
+		size_t matched = 0;
+		for (const auto &text: texts) {
+			if (!converter->deserialize(text.c_str(), colorObject, quality))
+				continue;
+			matched++;
+			BOOST_CHECK_MESSAGE(converter->accepts(ConverterInput(text)), converter->name() << " rejects matching input \"" << text << "\"");
+		}
+		BOOST_CHECK_MESSAGE(matched > 0, converter->name() << " matched nothing");
+	}
+}
+static bool firstDeserialize(const char *value, ColorObject &colorObject, float &quality, const Converter::Options &) {
+	if (std::string_view(value) != "both")
+		return false;
+	colorObject.setColor(Color(1.0f, 0.0f, 0.0f));
+	quality = 1;
+	return true;
+}
+static bool secondDeserialize(const char *value, ColorObject &colorObject, float &quality, const Converter::Options &) {
+	if (std::string_view(value) != "both" && std::string_view(value) != "second")
+		return false;
+	colorObject.setColor(Color(0.0f, 0.0f, 1.0f));
+	quality = 1;
+	return true;
+}
+BOOST_AUTO_TEST_CASE(bulkDeserializer) {
+	Converter::Options options = {};
+	Converters converters;
+	converters.add("test_first", "", Converter::Callback<Converter::Serialize>(), Converter::Callback<Converter::Deserialize>(firstDeserialize, options));
+	converters.add("test_second", "", Converter::Callback<Converter::Serialize>(), Converter::Callback<Converter::Deserialize>(secondDeserialize, options));
+	addInternalConverters(converters, options);
+	for (auto *converter: converters.all())
+		converter->paste(true);
+	converters.rebuildCopyPasteArrays();
+	BOOST_REQUIRE(!converters.allPaste().empty());
+	std::vector<std::string> texts = { "", "text", "0.5 0.5 0.5", "1, 2, 3", "0.5, 0.5, 0.5", "1 2 3 4", "1, 2, 3, 4", "#abc #aabbcc", "255;128;0", " #204080 x", "second", "both", "second", "second" };
+	for (int i = 0; i < 27; i++) {
+		Color color(i % 3 / 2.0f, i / 3 % 3 / 2.0f, i / 9 / 2.0f, (i % 2) * 0.5f + 0.25f);
+		for (auto *converter: converters.all()) {
+			if (!converter->hasSerialize())
+				continue;
+			auto text = converter->serialize(color);
+			texts.push_back(text);
+			texts.push_back(text);
+			texts.push_back("x " + text);
+		}
+		texts.push_back(texts[i % 8]);
+	}
+	BulkDeserializer deserializer(converters.allPaste());
+	ColorObject colorObject, expectedColorObject;
+	float quality;
+	for (const auto &text: texts) {
+		common::First<float, std::greater<float>, ColorObject> bestConversion;
+		for (auto *converter: converters.allPaste()) {
+			if (converter->deserialize(text.c_str(), expectedColorObject, quality) && quality > 0)
+				bestConversion(quality, expectedColorObject);
+		}
+		bool good = deserializer.deserialize(text, colorObject);
+		BOOST_REQUIRE_MESSAGE(good == static_cast<bool>(bestConversion), "wrong result for \"" << text << "\"");
+		if (good)
+			BOOST_CHECK_MESSAGE(colorObject.getColor() == bestConversion.data<ColorObject>().getColor(), "wrong color for \"" << text << "\", " << colorObject.getColor() << " != " << bestConversion.data<ColorObject>().getColor());
+	}
+}
+BOOST_AUTO_TEST_CASE(serializeList) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	std::vector<ColorObject> colorObjects;
+	for (int i = 0; i < 5; i++)
+		colorObjects.emplace_back("", Color(i / 4.0f, 0.5f, 1 - i / 4.0f));
+	std::vector<const ColorObject *> pointers;
+	for (const auto &colorObject: colorObjects)
+		pointers.push_back(&colorObject);
+	for (auto *converter: converters.all()) {
+		if (!converter->hasSerialize())
+			continue;
+		auto lines = converter->serialize(pointers);
+		BOOST_REQUIRE(lines.size() == colorObjects.size());
+		for (size_t i = 0; i < colorObjects.size(); i++)
+			BOOST_CHECK(lines[i] == converter->serialize(colorObjects[i], ConverterSerializePosition(colorObjects.size(), i)));
+	}
+	BOOST_CHECK(converters.byName("color_web_hex")->serialize(std::vector<const ColorObject *>()).empty());
+}
+BOOST_AUTO_TEST_CASE(mixedInputThroughput, *boost::unit_test::disabled()) {
+	Converter::Options options = {};
+	Converters converters;
+	addInternalConverters(converters, options);
+	for (auto *converter: converters.all())
+		converter->paste(true);
+	converters.rebuildCopyPasteArrays();
+	std::vector<Converter *> serializers;
+	for (auto *converter: converters.all()) {
+		if (converter->hasSerialize())
+			serializers.push_back(converter);
+	}
+	BOOST_REQUIRE(!serializers.empty());
+	// every tenth line is plain text no converter accepts
+	std::vector<std::string> lines;
+	for (size_t i = 0; i < 20000; i++) {
+		if (i % 10 == 9) {
+			lines.push_back("plain text line " + std::to_string(i));
+			continue;
+		}
+		Color color(i % 17 / 16.0f, i % 29 / 28.0f, i % 41 / 40.0f, i % 5 / 4.0f);
+		lines.push_back(serializers[i % serializers.size()]->serialize(color));
+	}
+	ColorObject colorObject;
+	float quality;
+	size_t allMatched = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const auto &line: lines) {
+		common::First<float, std::greater<float>, ColorObject> bestConversion;
+		for (auto *converter: converters.allPaste()) {
+			if (converter->deserialize(line.c_str(), colorObject, quality) && quality > 0)
+				bestConversion(quality, colorObject);
+		}
+		if (bestConversion)
+			allMatched++;
+	}
+	std::chrono::duration<double> allTime = std::chrono::steady_clock::now() - start;
+	size_t classifiedMatched = 0;
+	start = std::chrono::steady_clock::now();
+	for (const auto &line: lines) {
+		if (converters.deserialize(line, colorObject))
+			classifiedMatched++;
+	}
+	std::chrono::duration<double> classifiedTime = std::chrono::steady_clock::now() - start;
+	BOOST_CHECK_EQUAL(classifiedMatched, allMatched);
+	BOOST_TEST_MESSAGE("all converters: " << lines.size() / allTime.count() << " lines/s, classified input: " << lines.size() / classifiedTime.count() << " lines/s, " << lines.size() << " lines, " << allMatched << " colors");
+}
 BOOST_AUTO_TEST_SUITE_END()
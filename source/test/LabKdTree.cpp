@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "math/LabKdTree.h"
+#include "NamesDictionary.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+using namespace math;
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+};
+std::vector<Color> randomLabColors(size_t count, std::mt19937 &generator) {
+	std::uniform_real_distribution<float> channel(0.0f, 1.0f);
+	std::vector<Color> colors;
+	colors.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+		colors.push_back(Color(channel(generator), channel(generator), channel(generator)).rgbToLabD50());
+	return colors;
+}
+std::pair<size_t, float> linearNearest(const std::vector<Color> &colors, const Color &color) {
+	std::pair<size_t, float> result(0, Color::distanceLch(colors[0], color));
+	for (size_t i = 1; i < colors.size(); ++i) {
+		float distance = Color::distanceLch(colors[i], color);
+		if (distance < result.second)
+			result = { i, distance };
+	}
+	return result;
+}
+}
+BOOST_FIXTURE_TEST_SUITE(labKdTree, Initialize)
+BOOST_AUTO_TEST_CASE(empty) {
+	LabKdTree tree;
+	tree.build();
+	BOOST_CHECK(tree.empty());
+	BOOST_CHECK(!tree.nearest(Color(50.0f, 0.0f, 0.0f)));
+	std::vector<std::pair<float, size_t>> results;
+	tree.nearest(Color(50.0f, 0.0f, 0.0f), 5, results);
+	BOOST_CHECK(results.empty());
+}
+BOOST_AUTO_TEST_CASE(nearestMatchesLinearSearch) {
+	std::mt19937 generator(1);
+	auto colors = randomLabColors(5000, generator);
+	LabKdTree tree;
+	for (const auto &color: colors)
+		tree.add(color);
+	tree.build();
+	BOOST_CHECK_EQUAL(tree.size(), colors.size());
+	for (const auto &query: randomLabColors(500, generator)) {
+		auto expected = linearNearest(colors, query);
+		auto result = tree.nearest(query);
+		BOOST_REQUIRE(result);
+		BOOST_CHECK_EQUAL(result->second, expected.second);
+	}
+}
+BOOST_AUTO_TEST_CASE(nearestCountMatchesLinearSearch) {
+	std::mt19937 generator(2);
+	auto colors = randomLabColors(3000, generator);
+	LabKdTree tree;
+	for (const auto &color: colors)
+		tree.add(color);
+	tree.build();
+	std::vector<std::pair<float, size_t>> results, expected;
+	for (const auto &query: randomLabColors(100, generator)) {
+		expected.clear();
+		for (size_t i = 0; i < colors.size(); ++i)
+			expected.emplace_back(Color::distanceLch(colors[i], query), i);
+		std::sort(expected.begin(), expected.end());
+		expected.resize(9);
+		tree.nearest(query, 9, results);
+		BOOST_REQUIRE_EQUAL(results.size(), expected.size());
+		for (size_t i = 0; i < results.size(); ++i)
+			BOOST_CHECK_EQUAL(results[i].first, expected[i].first);
+	}
+}
+BOOST_AUTO_TEST_CASE(rebuild) {
+	LabKdTree tree;
+	tree.add(Color(50.0f, 10.0f, 10.0f));
+	tree.build();
+	tree.add(Color(80.0f, -10.0f, 10.0f));
+	tree.build();
+	auto result = tree.nearest(Color(79.0f, -10.0f, 10.0f));
+	BOOST_REQUIRE(result);
+	BOOST_CHECK_EQUAL(result->first, 1u);
+	tree.clear();
+	tree.build();
+	BOOST_CHECK(!tree.nearest(Color(79.0f, -10.0f, 10.0f)));
+}
+BOOST_AUTO_TEST_CASE(attach) {
+	std::mt19937 generator(3);
+	auto colors = randomLabColors(1000, generator);
+	LabKdTree tree;
+	for (const auto &color: colors)
+		tree.add(color);
+	tree.build();
+	std::vector<LabKdTree::Point> points(tree.points().data(), tree.points().data() + tree.points().size());
+	std::vector<LabKdTree::Node> nodes(tree.nodes().data(), tree.nodes().data() + tree.nodes().size());
+	LabKdTree attachedTree;
+	BOOST_REQUIRE(attachedTree.attach(common::Span<const LabKdTree::Point>(points.data(), points.size()), common::Span<const LabKdTree::Node>(nodes.data(), nodes.size())));
+	BOOST_CHECK_EQUAL(attachedTree.size(), colors.size());
+	for (const auto &query: randomLabColors(100, generator)) {
+		auto expected = tree.nearest(query);
+		auto result = attachedTree.nearest(query);
+		BOOST_REQUIRE(result);
+		BOOST_CHECK_EQUAL(result->first, expected->first);
+	}
+	LabKdTree invalidTree;
+	auto corrupt = [&](size_t nodeIndex, uint32_t left) {
+		auto corruptNodes = nodes;
+		corruptNodes[nodeIndex].left = left;
+		return invalidTree.attach(common::Span<const LabKdTree::Point>(points.data(), points.size()), common::Span<const LabKdTree::Node>(corruptNodes.data(), corruptNodes.size()));
+	};
+	BOOST_CHECK(!corrupt(0, static_cast<uint32_t>(nodes.size())));
+	BOOST_REQUIRE(!nodes[1].isLeaf());
+	BOOST_CHECK(!corrupt(1, 1));
+	BOOST_REQUIRE(!nodes[2].isLeaf());
+	BOOST_CHECK(!corrupt(2, 1));
+	attachedTree.add(Color(50.0f, 0.0f, 0.0f));
+	attachedTree.build();
+	BOOST_CHECK_EQUAL(attachedTree.size(), colors.size() + 1);
+	auto result = attachedTree.nearest(Color(50.0f, 0.0f, 0.0f));
+	BOOST_REQUIRE(result);
+	BOOST_CHECK_EQUAL(result->first, colors.size());
+}
+BOOST_AUTO_TEST_CASE(lookupThroughput, *boost::unit_test::disabled()) {
+	// bundled dictionaries, relative to source directory tests are run from
+	const char *filenames[] = {
+		"../share/gpick/names-xkcd.txt",
+		"../share/gpick/names-meodai-short.txt",
+		"../share/gpick/names-meodai-best.txt",
+		"../share/gpick/names-meodai-all.txt",
+	};
+	// every color of a 32x32x32 RGB grid, which covers color space evenly instead of random sampling
+	const int steps = 32;
+	std::vector<Color> queries;
+	queries.reserve(steps * steps * steps);
+	for (int red = 0; red < steps; ++red)
+		for (int green = 0; green < steps; ++green)
+			for (int blue = 0; blue < steps; ++blue)
+				queries.push_back(Color(red / float(steps - 1), green / float(steps - 1), blue / float(steps - 1)).rgbToLabD50());
+	for (auto filename: filenames) {
+		NamesDictionary dictionary;
+		BOOST_REQUIRE(dictionary.loadText(filename));
+		auto start = std::chrono::steady_clock::now();
+		dictionary.build();
+		std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - start;
+		std::vector<Color> colors;
+		colors.reserve(dictionary.size());
+		for (size_t i = 0; i < dictionary.size(); ++i)
+			colors.push_back(dictionary.color(i).rgbToLabD50());
+		start = std::chrono::steady_clock::now();
+		std::vector<std::pair<size_t, float>> treeResults;
+		treeResults.reserve(queries.size());
+		for (const auto &query: queries)
+			treeResults.push_back(*dictionary.index().nearest(query));
+		std::chrono::duration<double, std::micro> treeTime = std::chrono::steady_clock::now() - start;
+		// linear scan over every 16th grid color keeps largest dictionary runtime reasonable
+		const size_t linearStride = 16;
+		size_t linearQueries = 0, mismatches = 0;
+		start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < queries.size(); i += linearStride, ++linearQueries) {
+			// dictionaries contain duplicate colors, so distances are compared instead of indices
+			if (std::abs(linearNearest(colors, queries[i]).second - treeResults[i].second) > 1e-3f)
+				mismatches++;
+		}
+		std::chrono::duration<double, std::micro> linearTime = std::chrono::steady_clock::now() - start;
+		BOOST_CHECK_EQUAL(mismatches, 0u);
+		BOOST_TEST_MESSAGE(filename << ": " << colors.size() << " colors, build: " << buildTime.count() << " ms, k-d tree: " << treeTime.count() / queries.size() << " us per lookup, linear scan: " << linearTime.count() / linearQueries << " us per lookup");
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2009-2020, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "NamesDictionary.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+namespace fs = std::filesystem;
+namespace {
+struct Fixture {
+	fs::path path;
+	std::string textFilename, binaryFilename;
+	Fixture():
+		path(fs::temp_directory_path() / "gpick-test-names-dictionary") {
+		fs::remove_all(path);
+		fs::create_directories(path);
+		textFilename = (path / "names.txt").string();
+		binaryFilename = (path / "names.bin").string();
+		writeText("ff0000 Red\n00ff00 Green\n0000ff Blue\n808080 Gray\n");
+	}
+	~Fixture() {
+		std::error_code ec;
+		fs::remove_all(path, ec);
+	}
+	void writeText(const char *text) {
+		std::ofstream file(textFilename, std::ios::out | std::ios::trunc);
+		file << text;
+	}
+	NamesDictionary::SourceStamp stamp() {
+		auto stamp = NamesDictionary::SourceStamp::of(textFilename);
+		BOOST_REQUIRE(stamp);
+		return *stamp;
+	}
+	void saveBinary() {
+		NamesDictionary dictionary;
+		BOOST_REQUIRE(dictionary.loadText(textFilename));
+		dictionary.build();
+		BOOST_REQUIRE(dictionary.saveBinary(binaryFilename, stamp()));
+	}
+};
+}
+BOOST_FIXTURE_TEST_SUITE(namesDictionary, Fixture)
+BOOST_AUTO_TEST_CASE(binaryRoundTrip) {
+	NamesDictionary text;
+	BOOST_REQUIRE(text.loadText(textFilename));
+	text.build();
+	BOOST_REQUIRE(text.saveBinary(binaryFilename, stamp()));
+	NamesDictionary binary;
+	BOOST_REQUIRE(binary.loadBinary(binaryFilename, stamp()));
+	BOOST_REQUIRE_EQUAL(binary.size(), 4u);
+	for (size_t i = 0; i < binary.size(); i++) {
+		BOOST_CHECK_EQUAL(std::string(binary.name(i)), std::string(text.name(i)));
+		BOOST_CHECK(binary.color(i) == text.color(i));
+	}
+	auto nearest = binary.index().nearest(Color(0.1f, 0.9f, 0.2f).rgbToLabD50());
+	BOOST_REQUIRE(nearest);
+	BOOST_CHECK_EQUAL(std::string(binary.name(nearest->first)), "Green");
+	binary.add("White", Color(1.0f));
+	binary.build();
+	BOOST_REQUIRE_EQUAL(binary.size(), 5u);
+	BOOST_CHECK_EQUAL(std::string(binary.name(0)), "Red");
+	BOOST_CHECK_EQUAL(std::string(binary.name(4)), "White");
+}
+BOOST_AUTO_TEST_CASE(staleSource) {
+	saveBinary();
+	auto previous = stamp();
+	writeText("ff0000 Red\n00ff00 Grass\n0000ff Blue\n808080 Gray\n");
+	auto current = stamp();
+	BOOST_CHECK_EQUAL(previous.size, current.size);
+	NamesDictionary dictionary;
+	BOOST_CHECK(!dictionary.loadBinary(binaryFilename, current));
+	BOOST_CHECK_EQUAL(dictionary.size(), 0u);
+}
+BOOST_AUTO_TEST_CASE(truncatedCache) {
+	saveBinary();
+	auto size = fs::file_size(binaryFilename);
+	for (auto truncatedSize: { size - 1, size / 2, size_t(16), size_t(0) }) {
+		fs::resize_file(binaryFilename, truncatedSize);
+		NamesDictionary dictionary;
+		BOOST_CHECK(!dictionary.loadBinary(binaryFilename, stamp()));
+		BOOST_CHECK_EQUAL(dictionary.size(), 0u);
+	}
+	NamesDictionary dictionary;
+	BOOST_CHECK(!dictionary.loadBinary((path / "missing.bin").string(), stamp()));
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -19,6 +19,11 @@
 #include <boost/test/unit_test.hpp>
 #include "math/OctreeColorQuantization.h"
 #include <algorithm>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <tuple>
+#include <vector>
 using namespace math;
 BOOST_AUTO_TEST_SUITE(octreeColorQuantization)
 template<typename T>
@@ -92,4 +97,115 @@ BOOST_AUTO_TEST_CASE(merge) {
 	});
 	BOOST_CHECK_EQUAL(mergedOctree.size(), 200u);
 }
+using Leafs = std::vector<std::tuple<float, float, float, size_t>>;
+static Leafs leafs(OctreeColorQuantization &octree) {
+	Leafs result;
+	octree.visit([&](const float sum[3], size_t pixels) {
+		result.emplace_back(sum[0], sum[1], sum[2], pixels);
+	});
+	std::sort(result.begin(), result.end());
+	return result;
+}
+static void addRandomPixels(std::mt19937 &random, size_t count, OctreeColorQuantization &octree1, OctreeColorQuantization &octree2) {
+	for (size_t i = 0; i < count; i++) {
+		std::array<uint8_t, 3> position = { static_cast<uint8_t>(random() & 0xe0), static_cast<uint8_t>(random() & 0xe0), static_cast<uint8_t>(random() & 0xe0) };
+		// color values are multiples of 1/8 so sums are exact regardless of addition order
+		Color color(position[0] / 256.0f, position[1] / 256.0f, position[2] / 256.0f);
+		octree1.add(color, position);
+		octree2.add(color, position);
+	}
+}
+BOOST_AUTO_TEST_CASE(mergeNodes) {
+	std::mt19937 random(1);
+	OctreeColorQuantization octree1, octree2, combined;
+	addRandomPixels(random, 20000, octree1, combined);
+	addRandomPixels(random, 30000, octree2, combined);
+	octree1.merge(octree2);
+	BOOST_CHECK_EQUAL(octree1.size(), combined.size());
+	BOOST_CHECK(leafs(octree1) == leafs(combined));
+	octree1.reduce(10);
+	combined.reduce(10);
+	BOOST_CHECK_EQUAL(octree1.size(), 10u);
+	BOOST_CHECK_EQUAL(combined.size(), 10u);
+}
+BOOST_AUTO_TEST_CASE(mergeReduced) {
+	std::mt19937 random(2);
+	OctreeColorQuantization octree1, octree2, empty;
+	addRandomPixels(random, 20000, octree1, empty);
+	empty.clear();
+	addRandomPixels(random, 20000, octree2, empty);
+	empty.clear();
+	octree2.reduce(1);
+	octree1.merge(octree2);
+	octree1.merge(empty);
+	size_t pixels = 0;
+	octree1.visit([&](const float[3], size_t count) {
+		pixels += count;
+	});
+	BOOST_CHECK_EQUAL(pixels, 40000u);
+	BOOST_CHECK_EQUAL(octree1.size(), 1u);
+}
+BOOST_AUTO_TEST_CASE(serialize) {
+	std::mt19937 random(3);
+	OctreeColorQuantization octree, deserialized, empty;
+	addRandomPixels(random, 20000, octree, empty);
+	octree.reduce(100);
+	std::stringstream stream;
+	BOOST_REQUIRE(octree.serialize(stream));
+	BOOST_REQUIRE(deserialized.deserialize(stream));
+	BOOST_CHECK_EQUAL(deserialized.size(), octree.size());
+	BOOST_CHECK(leafs(deserialized) == leafs(octree));
+	deserialized.reduce(10);
+	octree.reduce(10);
+	BOOST_CHECK(leafs(deserialized) == leafs(octree));
+	std::string data = stream.str();
+	std::stringstream truncated(data.substr(0, data.size() / 2));
+	BOOST_CHECK(!deserialized.deserialize(truncated));
+	BOOST_CHECK_EQUAL(deserialized.size(), 0u);
+}
+static std::vector<OctreeColorQuantization::Position> benchmarkPositions(std::mt19937 &random, size_t count, bool clustered) {
+	std::vector<OctreeColorQuantization::Position> centers(16);
+	for (auto &center: centers)
+		center = { static_cast<uint8_t>(random()), static_cast<uint8_t>(random()), static_cast<uint8_t>(random()) };
+	std::normal_distribution<float> noise(0.0f, 12.0f);
+	std::vector<OctreeColorQuantization::Position> positions(count);
+	for (auto &position: positions) {
+		if (clustered) {
+			const auto &center = centers[random() % centers.size()];
+			for (int i = 0; i < 3; i++)
+				position[i] = static_cast<uint8_t>(std::clamp(static_cast<int>(center[i] + noise(random)), 0, 255));
+		} else {
+			position = { static_cast<uint8_t>(random()), static_cast<uint8_t>(random()), static_cast<uint8_t>(random()) };
+		}
+	}
+	return positions;
+}
+BOOST_AUTO_TEST_CASE(throughput, *boost::unit_test::disabled()) {
+	std::mt19937 random(4);
+	const struct {
+		const char *name;
+		size_t pixels;
+		bool clustered;
+	} inputs[] = {
+		{ "8 Mpx clustered", 8 * 1024 * 1024, true },
+		{ "0.5 Mpx clustered", 512 * 1024, true },
+		{ "0.5 Mpx wide spread", 512 * 1024, false },
+	};
+	for (const auto &input: inputs) {
+		auto positions = benchmarkPositions(random, input.pixels, input.clustered);
+		OctreeColorQuantization octree;
+		auto start = std::chrono::steady_clock::now();
+		for (const auto &position: positions)
+			octree.add(Color(position[0] / 255.0f, position[1] / 255.0f, position[2] / 255.0f), position);
+		std::chrono::duration<double, std::milli> addTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		OctreeColorQuantization copy(octree);
+		std::chrono::duration<double, std::milli> copyTime = std::chrono::steady_clock::now() - start;
+		start = std::chrono::steady_clock::now();
+		copy.reduce(16);
+		std::chrono::duration<double, std::milli> reduceTime = std::chrono::steady_clock::now() - start;
+		BOOST_CHECK_EQUAL(copy.size(), 16u);
+		BOOST_TEST_MESSAGE(input.name << ": add " << addTime.count() << " ms, copy " << copyTime.count() << " ms, reduce " << reduceTime.count() << " ms, " << octree.size() << " leafs");
+	}
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "math/PaletteQuantization.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+using namespace math;
+namespace {
+struct Initialize {
+	Initialize() {
+		Color::initialize();
+	}
+};
+size_t totalPixels(const std::vector<PaletteColor> &palette) {
+	size_t result = 0;
+	for (const auto &color: palette)
+		result += color.pixels;
+	return result;
+}
+// Image made of smooth gradients with noisy color clusters, in sRGB color space.
+std::vector<Color> syntheticImage(size_t width, size_t height, uint32_t seed) {
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> channel(0.0f, 1.0f);
+	std::normal_distribution<float> noise(0.0f, 0.03f);
+	std::vector<Color> centers(12);
+	for (auto &center: centers)
+		center = Color(channel(random), channel(random), channel(random));
+	Color gradientStart(channel(random), channel(random), channel(random)), gradientEnd(channel(random), channel(random), channel(random));
+	std::vector<Color> pixels;
+	pixels.reserve(width * height);
+	for (size_t y = 0; y < height; y++) {
+		for (size_t x = 0; x < width; x++) {
+			Color color;
+			if (x < width / 3) {
+				float t = static_cast<float>(y) / static_cast<float>(height);
+				color = gradientStart * (1 - t) + gradientEnd * t;
+			} else {
+				color = centers[(x / 64 + y / 64 * 7) % centers.size()];
+				for (int i = 0; i < 3; i++)
+					color[i] += noise(random);
+			}
+			color.alpha = 1.0f;
+			pixels.push_back(color.normalizeRgb());
+		}
+	}
+	return pixels;
+}
+}
+BOOST_FIXTURE_TEST_SUITE(paletteQuantization, Initialize)
+BOOST_AUTO_TEST_CASE(oklabPosition) {
+	auto black = math::oklabPosition(Color(0.0f));
+	BOOST_CHECK_EQUAL(black[0], 0);
+	BOOST_CHECK_EQUAL(black[1], 128);
+	BOOST_CHECK_EQUAL(black[2], 128);
+	auto white = math::oklabPosition(Color(1.0f));
+	BOOST_CHECK_EQUAL(white[0], 255);
+	BOOST_CHECK_EQUAL(white[1], 128);
+	BOOST_CHECK_EQUAL(white[2], 128);
+	for (int i = 0; i < 256; i++) {
+		auto position = math::oklabPosition(Color(i, i, i).linearRgb());
+		auto expected = Color(i, i, i).rgbToOklab();
+		BOOST_CHECK_LE(std::abs(position[0] - expected.oklab.L * 256), 1.0f);
+		BOOST_CHECK(position[1] == 127 || position[1] == 128);
+		BOOST_CHECK(position[2] == 127 || position[2] == 128);
+	}
+	auto red = math::oklabPosition(Color(1.0f, 0.0f, 0.0f));
+	BOOST_CHECK_GT(red[1], 128 + 32);
+}
+BOOST_AUTO_TEST_CASE(reduce) {
+	std::mt19937 random(1);
+	OctreeColorQuantization octree;
+	for (int i = 0; i < 10000; i++) {
+		OctreeColorQuantization::Position position = { static_cast<uint8_t>(random()), static_cast<uint8_t>(random()), static_cast<uint8_t>(random()) };
+		octree.add(Color(position[0], position[1], position[2]).linearRgb(), position);
+	}
+	octree.reduce(1000);
+	auto palette = reducePalette(octree, 16);
+	BOOST_CHECK_EQUAL(palette.size(), 16u);
+	BOOST_CHECK_EQUAL(totalPixels(palette), 10000u);
+	auto refinedPalette = reducePalette(octree, 16, 10);
+	BOOST_CHECK_LE(refinedPalette.size(), 16u);
+	BOOST_CHECK_EQUAL(totalPixels(refinedPalette), 10000u);
+}
+BOOST_AUTO_TEST_CASE(refineClusters) {
+	// two tight clusters split across octree branches, refinement must find both cluster centers
+	std::mt19937 random(2);
+	std::normal_distribution<float> noise(0.0f, 0.01f);
+	const Color centers[] = { Color(0.2f, 0.5f, 0.5f), Color(0.55f, 0.45f, 0.52f) };
+	OctreeColorQuantization octree;
+	for (int i = 0; i < 20000; i++) {
+		Color color = centers[i % 2];
+		for (int j = 0; j < 3; j++)
+			color[j] += noise(random);
+		Color linear = color.linearRgb();
+		octree.add(linear, math::oklabPosition(linear));
+	}
+	octree.reduce(1000);
+	auto palette = reducePalette(octree, 2, 20);
+	BOOST_REQUIRE_EQUAL(palette.size(), 2u);
+	BOOST_CHECK_EQUAL(totalPixels(palette), 20000u);
+	std::sort(palette.begin(), palette.end(), [](const PaletteColor &a, const PaletteColor &b) {
+		return a.color.red < b.color.red;
+	});
+	for (size_t i = 0; i < 2; i++) {
+		BOOST_CHECK_LT(Color::distanceLch(palette[i].color.rgbToLabD50(), centers[i].rgbToLabD50()), 1.0f);
+		BOOST_CHECK_EQUAL(palette[i].pixels, 10000u);
+	}
+}
+BOOST_AUTO_TEST_CASE(engineQuality, *boost::unit_test::disabled()) {
+	const size_t numberOfColors = 16;
+	for (uint32_t seed = 1; seed <= 3; seed++) {
+		auto image = syntheticImage(1024, 1024, seed);
+		std::vector<Color> imageLab;
+		imageLab.reserve(image.size());
+		for (const auto &color: image)
+			imageLab.push_back(color.rgbToLabD50());
+		const struct {
+			const char *name;
+			QuantizationEngine engine;
+			size_t kMeansIterations;
+		} engines[] = {
+			{ "RGB octree", QuantizationEngine::rgb, 0 },
+			{ "Oklab octree", QuantizationEngine::oklab, 0 },
+			{ "Oklab octree + k-means", QuantizationEngine::oklab, 20 },
+		};
+		for (const auto &engine: engines) {
+			auto start = std::chrono::steady_clock::now();
+			OctreeColorQuantization octree;
+			for (const auto &color: image) {
+				Color linear = color.linearRgb();
+				OctreeColorQuantization::Position position;
+				if (engine.engine == QuantizationEngine::oklab)
+					position = math::oklabPosition(linear);
+				else
+					position = { static_cast<uint8_t>(color.red * 255), static_cast<uint8_t>(color.green * 255), static_cast<uint8_t>(color.blue * 255) };
+				octree.add(linear, position);
+			}
+			octree.reduce(1000);
+			auto palette = reducePalette(octree, numberOfColors, engine.kMeansIterations);
+			std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+			std::vector<Color> paletteLab;
+			for (const auto &paletteColor: palette)
+				paletteLab.push_back(paletteColor.color.rgbToLabD50());
+			// mean CIE76 color difference between each pixel and its nearest palette color
+			double totalDistance = 0;
+			for (const auto &color: imageLab) {
+				float nearest = std::numeric_limits<float>::max();
+				for (const auto &paletteColor: paletteLab) {
+					float distance = 0;
+					for (int i = 0; i < 3; i++)
+						distance += (color[i] - paletteColor[i]) * (color[i] - paletteColor[i]);
+					nearest = std::min(nearest, distance);
+				}
+				totalDistance += std::sqrt(nearest);
+			}
+			BOOST_CHECK_EQUAL(totalPixels(palette), image.size());
+			BOOST_TEST_MESSAGE("seed " << seed << ", " << engine.name << ": " << time.count() << " ms, mean dE " << totalDistance / image.size() << ", " << palette.size() << " colors");
+		}
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
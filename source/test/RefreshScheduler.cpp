@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "common/RefreshScheduler.h"
+using namespace common;
+using namespace std::chrono_literals;
+BOOST_AUTO_TEST_SUITE(refreshScheduler)
+BOOST_AUTO_TEST_CASE(backOff) {
+	RefreshScheduler scheduler(50, 2, 1s);
+	RefreshScheduler::Clock::time_point now;
+	BOOST_CHECK(scheduler.update(now, true) == 20ms);
+	now += 500ms;
+	BOOST_CHECK(scheduler.update(now, false) == 20ms);
+	now += 600ms;
+	BOOST_CHECK(scheduler.update(now, false) == 40ms);
+	BOOST_CHECK(scheduler.update(now, false) == 80ms);
+	for (int i = 0; i < 10; i++)
+		scheduler.update(now, false);
+	BOOST_CHECK(scheduler.interval() == 500ms);
+	BOOST_CHECK(scheduler.update(now, true) == 20ms);
+}
+BOOST_AUTO_TEST_CASE(wake) {
+	RefreshScheduler scheduler(50, 2, 0s);
+	RefreshScheduler::Clock::time_point now;
+	BOOST_CHECK(!scheduler.wake(now));
+	scheduler.update(now, false);
+	BOOST_CHECK(scheduler.interval() == 40ms);
+	BOOST_CHECK(scheduler.wake(now));
+	BOOST_CHECK(scheduler.interval() == 20ms);
+	BOOST_CHECK(!scheduler.wake(now));
+}
+BOOST_AUTO_TEST_CASE(rates) {
+	RefreshScheduler scheduler(50, 2, 0s);
+	RefreshScheduler::Clock::time_point now;
+	for (int i = 0; i < 20; i++)
+		scheduler.update(now, false);
+	BOOST_CHECK(scheduler.interval() == 500ms);
+	scheduler.setRates(50, 10);
+	BOOST_CHECK(scheduler.interval() == 100ms);
+	scheduler.setRates(50, 100);
+	BOOST_CHECK(scheduler.interval() == 20ms);
+}
+BOOST_AUTO_TEST_CASE(wakeupsPerSecond) {
+	RefreshScheduler scheduler(50, 2, 1s);
+	RefreshScheduler::Clock::time_point now;
+	for (int i = 0; i < 10; i++) {
+		scheduler.update(now, true);
+		now += 100ms;
+	}
+	BOOST_CHECK_EQUAL(scheduler.wakeupsPerSecond(), 0);
+	scheduler.update(now, true);
+	BOOST_CHECK_EQUAL(scheduler.wakeups(), 11u);
+	BOOST_CHECK_CLOSE(scheduler.wakeupsPerSecond(), 11.0, 1e-6);
+}
+BOOST_AUTO_TEST_CASE(idleWakeups, *boost::unit_test::disabled()) {
+	// rates used by the color picker: 30 Hz default refresh rate, 10 Hz idle rate when pointer is polled and 2 Hz idle rate with pointer motion events
+	const struct {
+		const char *name;
+		double idleRate;
+	} modes[] = {
+		{ "fixed rate", 30 },
+		{ "polling", 10 },
+		{ "motion events", 2 },
+	};
+	double fixedRate = 0;
+	for (const auto &mode: modes) {
+		RefreshScheduler scheduler(30, mode.idleRate, 1s);
+		RefreshScheduler::Clock::time_point now;
+		// pointer moves for 5 seconds, then stays still for 60 seconds
+		const auto activeEnd = now + 5s, idleEnd = activeEnd + 60s;
+		while (now < activeEnd)
+			now += scheduler.update(now, true);
+		auto activeWakeups = scheduler.wakeups();
+		while (now < idleEnd)
+			now += scheduler.update(now, false);
+		double idleRate = static_cast<double>(scheduler.wakeups() - activeWakeups) / 60;
+		if (fixedRate == 0)
+			fixedRate = idleRate;
+		BOOST_CHECK_LE(idleRate, fixedRate);
+		BOOST_TEST_MESSAGE(mode.name << ": " << activeWakeups / 5.0 << " wakeups/s while active, " << idleRate << " wakeups/s while idle, " << 100 * (1 - idleRate / fixedRate) << "% fewer idle wakeups");
+	}
+}
+BOOST_AUTO_TEST_SUITE_END()
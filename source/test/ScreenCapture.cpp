@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#if defined(GPICK_XSHM_CAPTURE)
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <algorithm>
+#include <chrono>
+#endif
+BOOST_AUTO_TEST_SUITE(screenCapture)
+#if defined(GPICK_XSHM_CAPTURE)
+BOOST_AUTO_TEST_CASE(captureLatency, *boost::unit_test::disabled()) {
+	Display *display = XOpenDisplay(nullptr);
+	if (!display) {
+		BOOST_TEST_MESSAGE("no X display, skipping");
+		return;
+	}
+	int screen = DefaultScreen(display);
+	Window root = RootWindow(display, screen);
+	if (!XShmQueryExtension(display)) {
+		BOOST_TEST_MESSAGE("XShm extension is not available, skipping");
+		XCloseDisplay(display);
+		return;
+	}
+	// small sampler area, zoomed preview sized area and the whole screen
+	const int screenWidth = DisplayWidth(display, screen), screenHeight = DisplayHeight(display, screen);
+	const struct {
+		int width, height, iterations;
+	} areas[] = {
+		{ 21, 21, 2000 },
+		{ 150, 150, 1000 },
+		{ screenWidth, screenHeight, 50 },
+	};
+	XShmSegmentInfo shmInfo;
+	XImage *shmImage = XShmCreateImage(display, DefaultVisual(display, screen), DefaultDepth(display, screen), ZPixmap, nullptr, &shmInfo, screenWidth, screenHeight);
+	BOOST_REQUIRE(shmImage);
+	shmInfo.shmid = shmget(IPC_PRIVATE, shmImage->bytes_per_line * shmImage->height, IPC_CREAT | 0600);
+	BOOST_REQUIRE(shmInfo.shmid >= 0);
+	shmInfo.shmaddr = shmImage->data = reinterpret_cast<char *>(shmat(shmInfo.shmid, nullptr, 0));
+	shmInfo.readOnly = False;
+	BOOST_REQUIRE(XShmAttach(display, &shmInfo));
+	XSync(display, False);
+	shmctl(shmInfo.shmid, IPC_RMID, nullptr);
+	for (const auto &area: areas) {
+		auto startTime = std::chrono::steady_clock::now();
+		for (int i = 0; i < area.iterations; i++) {
+			XImage *image = XGetImage(display, root, 0, 0, area.width, area.height, AllPlanes, ZPixmap);
+			BOOST_REQUIRE(image);
+			XDestroyImage(image);
+		}
+		std::chrono::duration<double, std::micro> getImageTime = std::chrono::steady_clock::now() - startTime;
+		shmImage->width = area.width;
+		shmImage->height = area.height;
+		shmImage->bytes_per_line = area.width * (shmImage->bits_per_pixel / 8);
+		startTime = std::chrono::steady_clock::now();
+		for (int i = 0; i < area.iterations; i++)
+			BOOST_REQUIRE(XShmGetImage(display, root, shmImage, 0, 0, AllPlanes));
+		std::chrono::duration<double, std::micro> shmTime = std::chrono::steady_clock::now() - startTime;
+		BOOST_TEST_MESSAGE(area.width << "x" << area.height << ": XGetImage " << getImageTime.count() / area.iterations << " us, XShmGetImage " << shmTime.count() / area.iterations << " us per capture");
+	}
+	XShmDetach(display, &shmInfo);
+	shmdt(shmInfo.shmaddr);
+	shmImage->data = nullptr;
+	XDestroyImage(shmImage);
+	XCloseDisplay(display);
+}
+#endif
+BOOST_AUTO_TEST_SUITE_END()
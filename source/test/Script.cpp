@@ -20,6 +20,10 @@
 #include "lua/Script.h"
 #include "lua/Lua.h"
 #include "common/Scoped.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
 using namespace lua;
 static int test(lua_State *L) {
 	lua_pushstring(L, "ok");
@@ -92,4 +96,73 @@ BOOST_AUTO_TEST_CASE(errorHandling) {
 	BOOST_CHECK(status == false);
 	BOOST_CHECK(cleanupOnError == true);
 }
+BOOST_AUTO_TEST_CASE(cachedModules) {
+	namespace fs = std::filesystem;
+	auto path = fs::temp_directory_path() / "gpick-test-script-cache";
+	fs::remove_all(path);
+	fs::create_directories(path / "scripts");
+	auto writeModule = [&path](const char *value) {
+		std::ofstream file(path / "scripts" / "cached.lua", std::ios::out | std::ios::trunc);
+		file << "return { value = \"" << value << "\" }\n";
+	};
+	auto loadValue = [&path]() {
+		Script script;
+		script.setPaths({ (path / "scripts").string() });
+		script.setCachePath((path / "cache").string());
+		if (!script.loadCode("return require(\"cached\").value") || !script.run(0, 1))
+			return std::string();
+		return script.getString(-1);
+	};
+	writeModule("first");
+	BOOST_CHECK(loadValue() == "first");
+	BOOST_CHECK(!fs::is_empty(path / "cache"));
+	BOOST_CHECK(loadValue() == "first");
+	writeModule("second, changed size");
+	BOOST_CHECK(loadValue() == "second, changed size");
+	fs::remove_all(path);
+}
+BOOST_AUTO_TEST_CASE(damagedCachedModules) {
+	namespace fs = std::filesystem;
+	auto path = fs::temp_directory_path() / "gpick-test-script-damaged-cache";
+	fs::remove_all(path);
+	fs::create_directories(path / "scripts");
+	{
+		std::ofstream file(path / "scripts" / "cached.lua", std::ios::out | std::ios::trunc);
+		file << "return { value = \"source\" }\n";
+	}
+	auto loadValue = [&path]() {
+		Script script;
+		script.setPaths({ (path / "scripts").string() });
+		script.setCachePath((path / "cache").string());
+		if (!script.loadCode("return require(\"cached\").value") || !script.run(0, 1))
+			return std::string();
+		return script.getString(-1);
+	};
+	auto cacheFilename = [&path]() {
+		for (auto &entry: fs::directory_iterator(path / "cache"))
+			return entry.path();
+		return fs::path();
+	};
+	BOOST_CHECK(loadValue() == "source");
+	auto filename = cacheFilename();
+	BOOST_REQUIRE(!filename.empty());
+	auto size = fs::file_size(filename);
+	fs::resize_file(filename, size / 2);
+	BOOST_CHECK(loadValue() == "source");
+	BOOST_CHECK_EQUAL(fs::file_size(filename), size);
+	std::string data;
+	{
+		std::ifstream file(filename, std::ios::in | std::ios::binary);
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+	auto position = data.find("source");
+	BOOST_REQUIRE(position != std::string::npos);
+	data.replace(position, 6, "broken");
+	{
+		std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		file.write(data.data(), data.size());
+	}
+	BOOST_CHECK(loadValue() == "source");
+	fs::remove_all(path);
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "common/StageTimings.h"
+using namespace common;
+using namespace std::chrono_literals;
+BOOST_AUTO_TEST_SUITE(stageTimings)
+BOOST_AUTO_TEST_CASE(accumulate) {
+	StageTimings timings { "first", "second" };
+	BOOST_REQUIRE_EQUAL(timings.size(), 2u);
+	timings.add(0, 10us);
+	timings.add(0, 30us);
+	timings.add(1, 5us);
+	BOOST_CHECK_EQUAL(timings[0].count, 2u);
+	BOOST_CHECK(timings[0].last == 30us);
+	BOOST_CHECK(timings[0].max == 30us);
+	BOOST_CHECK(timings[0].average() == 20us);
+	BOOST_CHECK(timings[1].average() == 5us);
+}
+BOOST_AUTO_TEST_CASE(counters) {
+	StageTimings timings { "stage" };
+	timings.update();
+	timings.skip();
+	timings.skip();
+	BOOST_CHECK_EQUAL(timings.updates(), 1u);
+	BOOST_CHECK_EQUAL(timings.skipped(), 2u);
+	BOOST_CHECK_EQUAL(timings.format(), "stage: 0.0 us (avg 0.0 us)\nskipped: 2/3");
+	timings.reset();
+	BOOST_CHECK_EQUAL(timings.skipped(), 0u);
+	BOOST_CHECK(timings[0].average() == StageTimings::Duration::zero());
+}
+BOOST_AUTO_TEST_CASE(scope) {
+	StageTimings timings { "stage" };
+	{
+		StageTimings::Scope scope(timings, 0);
+	}
+	BOOST_CHECK_EQUAL(timings[0].count, 1u);
+}
+BOOST_AUTO_TEST_SUITE_END()
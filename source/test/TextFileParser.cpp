@@ -18,11 +18,20 @@
 
 #include <boost/test/unit_test.hpp>
 #include "parser/TextFile.h"
+#include "parser/IncrementalParser.h"
+#include "parser/ParallelParser.h"
 #include "Color.h"
 #include "Common.h"
+#include <glib.h>
 #include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <random>
+#include <cstring>
 #include <vector>
 #include <string_view>
+#include <string>
 using namespace text_file_parser;
 
 namespace {
@@ -83,6 +92,45 @@ struct Parser: public TextFile {
 		TextFile::parse(configuration);
 	}
 };
+struct ViewParser: public TextView {
+	std::vector<Color> m_colors;
+	std::vector<size_t> m_errors;
+	bool m_failed;
+	ViewParser(std::string_view text, const ParallelParser *parallelParser = nullptr, const Configuration &configuration = Configuration()):
+		TextView(text),
+		m_failed(false) {
+		if (parallelParser)
+			parallelParser->parse(*this, configuration);
+		else
+			TextFile::parse(configuration);
+	}
+	virtual ~ViewParser() {
+	}
+	virtual void outOfMemory() {
+		m_failed = true;
+	}
+	virtual void syntaxError(size_t startLine, size_t startColumn, size_t endLine, size_t endColumn) {
+		m_failed = true;
+		m_errors.insert(m_errors.end(), { startLine, startColumn, endLine, endColumn });
+	}
+	virtual void addColor(const Color &color) {
+		m_colors.push_back(color);
+	}
+};
+std::string generateStylesheet(size_t size) {
+	std::string text;
+	for (size_t i = 0; text.length() < size; ++i) {
+		text += "/* block " + std::to_string(i) + " */\n";
+		text += "$accent-" + std::to_string(i) + ": #" + std::to_string(100000 + i % 900000) + ";\n";
+		text += ".item-" + std::to_string(i) + " {\n";
+		text += "\tcolor: rgb(" + std::to_string(i % 256) + ", " + std::to_string(i * 7 % 256) + ", " + std::to_string(i * 13 % 256) + ");\n";
+		text += "\tbackground: hsla(" + std::to_string(i % 360) + "deg 50% 40% / 0.5);\n";
+		text += "\tborder: 1px solid #abc; // short hex\n";
+		text += "\tmargin: 0 auto;\n";
+		text += "}\n";
+	}
+	return text;
+}
 }
 BOOST_AUTO_TEST_SUITE(textFileParser)
 BOOST_AUTO_TEST_CASE(fullHex) {
@@ -199,4 +247,167 @@ BOOST_AUTO_TEST_CASE(outOfRangeFloatValue) {
 	Color color = { 0xaa, 0xbb, 0 };
 	BOOST_CHECK_MESSAGE(parser[0] == color, parser[0] << " != " << color);
 }
+namespace {
+std::string generateLines(size_t count) {
+	std::string text;
+	const char hex[] = "0123456789abcdef";
+	for (size_t i = 0; i < count; ++i) {
+		text += "color: #";
+		for (int j = 0; j < 6; ++j)
+			text += hex[(i * 7 + j * 3) % 16];
+		text += ";\n";
+	}
+	return text;
+}
+void checkIncremental(IncrementalParser &incrementalParser, const std::string &text, std::vector<Color> &patchedColors) {
+	IncrementalParser::Change change;
+	incrementalParser.parse(text, Configuration(), change);
+	patchedColors.erase(patchedColors.begin() + change.first, patchedColors.begin() + change.first + change.removed);
+	patchedColors.insert(patchedColors.begin() + change.first, incrementalParser.colors().begin() + change.first, incrementalParser.colors().begin() + change.first + change.inserted);
+	Parser parser(text);
+	BOOST_REQUIRE_EQUAL(incrementalParser.colors().size(), parser.count());
+	for (size_t i = 0; i < parser.count(); ++i)
+		BOOST_CHECK_MESSAGE(incrementalParser.colors()[i] == parser[i], "color " << i << " incorrect, " << incrementalParser.colors()[i] << " != " << parser[i]);
+	BOOST_CHECK(patchedColors == incrementalParser.colors());
+}
+}
+BOOST_AUTO_TEST_CASE(incrementalEdit) {
+	IncrementalParser incrementalParser(256);
+	std::vector<Color> patchedColors;
+	auto text = generateLines(200);
+	checkIncremental(incrementalParser, text, patchedColors);
+	BOOST_CHECK_EQUAL(incrementalParser.scannedBytes(), text.length());
+	text.replace(text.find("color", text.length() / 2) + 8, 6, "123");
+	checkIncremental(incrementalParser, text, patchedColors);
+	BOOST_CHECK_LT(incrementalParser.scannedBytes(), 1024u);
+	text.insert(text.length() / 3, "rgb(1, 2, 3)\n#abcdef\n");
+	checkIncremental(incrementalParser, text, patchedColors);
+	BOOST_CHECK_LT(incrementalParser.scannedBytes(), 1024u);
+	text.erase(100, 300);
+	checkIncremental(incrementalParser, text, patchedColors);
+	BOOST_CHECK_LT(incrementalParser.scannedBytes(), 1024u);
+}
+BOOST_AUTO_TEST_CASE(incrementalMultiLineComment) {
+	IncrementalParser incrementalParser(256);
+	std::vector<Color> patchedColors;
+	auto text = generateLines(200);
+	checkIncremental(incrementalParser, text, patchedColors);
+	text.insert(1000, "/*");
+	checkIncremental(incrementalParser, text, patchedColors);
+	text.insert(3000, "*/");
+	checkIncremental(incrementalParser, text, patchedColors);
+	BOOST_CHECK_LT(incrementalParser.scannedBytes(), 1024u);
+	text.erase(1000, 2);
+	checkIncremental(incrementalParser, text, patchedColors);
+}
+BOOST_AUTO_TEST_CASE(incrementalConfigurationChange) {
+	IncrementalParser incrementalParser(256);
+	std::vector<Color> patchedColors;
+	auto text = generateLines(100);
+	checkIncremental(incrementalParser, text, patchedColors);
+	Configuration configuration;
+	configuration.fullHex = false;
+	IncrementalParser::Change change;
+	incrementalParser.parse(text, configuration, change);
+	BOOST_CHECK_EQUAL(change.first, 0u);
+	BOOST_CHECK_EQUAL(change.removed, 100u);
+	BOOST_CHECK_EQUAL(incrementalParser.scannedBytes(), text.length());
+}
+BOOST_AUTO_TEST_CASE(incrementalParallel) {
+	IncrementalParser incrementalParser(256, 4);
+	std::vector<Color> patchedColors;
+	auto text = generateLines(100000);
+	text.insert(400000, "/*");
+	text.insert(900000, "*/");
+	checkIncremental(incrementalParser, text, patchedColors);
+	BOOST_CHECK_EQUAL(incrementalParser.scannedBytes(), text.length());
+	text.insert(1000, "/*");
+	checkIncremental(incrementalParser, text, patchedColors);
+	text.erase(1000, 2);
+	checkIncremental(incrementalParser, text, patchedColors);
+	BOOST_CHECK_LT(incrementalParser.scannedBytes(), text.length());
+}
+BOOST_AUTO_TEST_CASE(textViewMatchesStream) {
+	auto text = generateStylesheet(64 * 1024);
+	Parser parser(text);
+	ViewParser viewParser(text);
+	BOOST_CHECK(!parser.m_failed);
+	BOOST_CHECK(!viewParser.m_failed);
+	BOOST_REQUIRE_EQUAL(viewParser.m_colors.size(), parser.count());
+	for (size_t i = 0; i < parser.count(); ++i)
+		BOOST_CHECK_MESSAGE(viewParser.m_colors[i] == parser[i], "color " << i << " incorrect, " << viewParser.m_colors[i] << " != " << parser[i]);
+}
+BOOST_AUTO_TEST_CASE(textViewLongToken) {
+	std::string text = "170" + std::string(10000, ' ') + "187 204";
+	Parser parser(text);
+	BOOST_CHECK(parser.m_failed);
+	ViewParser viewParser(text);
+	BOOST_CHECK(!viewParser.m_failed);
+	BOOST_REQUIRE_EQUAL(viewParser.m_colors.size(), 1u);
+	Color color = { 0xaa, 0xbb, 0xcc };
+	BOOST_CHECK_MESSAGE(viewParser.m_colors[0] == color, viewParser.m_colors[0] << " != " << color);
+}
+BOOST_AUTO_TEST_CASE(strayNumbersBeforeColor) {
+	Color color = { 0xaa, 0xbb, 0xcc };
+	for (auto text: { "12 #aabbcc 170 187 204", "12 #abc 170 187 204", "12 /* x */ 170 187 204", "12 // x\n170 187 204" }) {
+		ViewParser viewParser(text);
+		BOOST_CHECK(!viewParser.m_failed);
+		for (const auto &parsedColor: viewParser.m_colors)
+			BOOST_CHECK_MESSAGE(parsedColor == color, text << ": " << parsedColor << " != " << color);
+		BOOST_CHECK_EQUAL(viewParser.m_colors.size(), text[3] == '#' ? 2u : 1u);
+	}
+}
+BOOST_AUTO_TEST_CASE(parallel) {
+	std::mt19937 generator(23);
+	const char *fragments[] = { "#aabbcc", "#abc", "#aabbccdd", "abcdef", "rgb(1, 2, 3)", "hsla(180 75% 50% / 0.5)", "oklch(0.5 0.1 120)", "1, 2, 3", "1 2 3 4", "0.5 0.25 1", "/*", "*/", "//", "#", " ", "\t", ",", "\n", "\r\n", "\n\n", "x", "12" };
+	for (int iteration = 0; iteration < 200; ++iteration) {
+		std::string text;
+		size_t length = generator() % 20000;
+		while (text.length() < length)
+			text += fragments[generator() % (sizeof(fragments) / sizeof(fragments[0]))];
+		Configuration configuration;
+		configuration.singleLineHashComments = generator() % 2 == 0;
+		configuration.multiLineCComments = generator() % 4 != 0;
+		ViewParser sequential(text, nullptr, configuration);
+		ParallelParser parallelParser(1 + generator() % 2048, 1 + generator() % 8);
+		ViewParser parallel(text, &parallelParser, configuration);
+		BOOST_REQUIRE_EQUAL(parallel.m_failed, sequential.m_failed);
+		BOOST_REQUIRE(parallel.m_errors == sequential.m_errors);
+		BOOST_REQUIRE_EQUAL(parallel.m_colors.size(), sequential.m_colors.size());
+		BOOST_REQUIRE(std::memcmp(parallel.m_colors.data(), sequential.m_colors.data(), sizeof(Color) * sequential.m_colors.size()) == 0);
+	}
+}
+BOOST_AUTO_TEST_CASE(throughput, *boost::unit_test::disabled()) {
+	// "before" streams file through scanner buffer like imports did before in place scanning, "after" scans memory mapped file contents like ImportTextFile does now
+	namespace fs = std::filesystem;
+	auto filename = fs::temp_directory_path() / "gpick-test-throughput.css";
+	{
+		std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		file << generateStylesheet(64 * 1024 * 1024);
+		BOOST_REQUIRE(file.good());
+	}
+	auto megabytes = fs::file_size(filename) / (1024.0 * 1024.0);
+	auto start = std::chrono::steady_clock::now();
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	Parser parser(&file);
+	parser.parse();
+	std::chrono::duration<double> streamTime = std::chrono::steady_clock::now() - start;
+	start = std::chrono::steady_clock::now();
+	auto mappedFile = g_mapped_file_new(filename.string().c_str(), false, nullptr);
+	BOOST_REQUIRE(mappedFile);
+	std::string_view text(g_mapped_file_get_contents(mappedFile), g_mapped_file_get_length(mappedFile));
+	ViewParser viewParser(text);
+	std::chrono::duration<double> viewTime = std::chrono::steady_clock::now() - start;
+	ParallelParser parallelParser;
+	start = std::chrono::steady_clock::now();
+	ViewParser parallelViewParser(text, &parallelParser);
+	std::chrono::duration<double> parallelTime = std::chrono::steady_clock::now() - start;
+	g_mapped_file_unref(mappedFile);
+	std::error_code ec;
+	fs::remove(filename, ec);
+	BOOST_CHECK(!parser.m_failed);
+	BOOST_CHECK_EQUAL(viewParser.m_colors.size(), parser.count());
+	BOOST_CHECK_EQUAL(parallelViewParser.m_colors.size(), parser.count());
+	BOOST_TEST_MESSAGE("before (stream): " << megabytes / streamTime.count() << " MB/s, after (mapped view): " << megabytes / viewTime.count() << " MB/s, parallel (" << parallelParser.threads() << " threads): " << megabytes / parallelTime.count() << " MB/s, " << megabytes << " MB, " << parser.count() << " colors");
+}
 BOOST_AUTO_TEST_SUITE_END()
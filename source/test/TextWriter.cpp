@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "common/TextWriter.h"
+#include "common/Convert.h"
+using namespace common;
+BOOST_AUTO_TEST_SUITE(textWriter)
+BOOST_AUTO_TEST_CASE(empty) {
+	char buffer[4] = "abc";
+	TextWriter writer(buffer);
+	BOOST_CHECK_EQUAL(writer.view(), "");
+	BOOST_CHECK_EQUAL(buffer[0], 0);
+}
+BOOST_AUTO_TEST_CASE(mixed) {
+	char buffer[32];
+	TextWriter writer(buffer);
+	writer << "rgb(" << 32 << ", " << -5 << '%' << std::string_view(" / ");
+	writer.fixed(0.5f, 3) << ')';
+	BOOST_CHECK_EQUAL(writer.view(), "rgb(32, -5% / 0.500)");
+	BOOST_CHECK_EQUAL(std::string(buffer), "rgb(32, -5% / 0.500)");
+	BOOST_CHECK(!writer.truncated());
+}
+BOOST_AUTO_TEST_CASE(fixed) {
+	char buffer[64];
+	TextWriter writer(buffer);
+	writer.fixed(0.0005f, 3) << ' ';
+	writer.fixed(0.9995f, 3) << ' ';
+	writer.fixed(1.0f, 0) << ' ';
+	writer.fixed(-0.25f, 1);
+	BOOST_CHECK_EQUAL(writer.view(), "0.001 0.999 1 -0.2");
+}
+BOOST_AUTO_TEST_CASE(hex) {
+	char buffer[32];
+	TextWriter writer(buffer);
+	writer.hex(0x0a, 2, true).hex(0xff, 2, false).hex(0x5, 1, true).hex(0x1234, 2, true).hex(0, 0, true);
+	BOOST_CHECK_EQUAL(writer.view(), "0Aff512340");
+}
+BOOST_AUTO_TEST_CASE(truncated) {
+	char buffer[6];
+	TextWriter writer(buffer);
+	writer << "#" << 12345 << 'x';
+	BOOST_CHECK_EQUAL(writer.view(), "#1234");
+	BOOST_CHECK_EQUAL(std::string(buffer), "#1234");
+	BOOST_CHECK(writer.truncated());
+}
+BOOST_AUTO_TEST_CASE(convertNumbers) {
+	BOOST_CHECK_EQUAL(convert<float>("0.5", -1.0f), 0.5f);
+	BOOST_CHECK_EQUAL(convert<float>(".5", -1.0f), 0.5f);
+	BOOST_CHECK_EQUAL(convert<float>("+5", -1.0f), 5.0f);
+	BOOST_CHECK_EQUAL(convert<float>("-1e2", 0.0f), -100.0f);
+	BOOST_CHECK_EQUAL(convert<float>("0,5", -1.0f), -1.0f);
+	BOOST_CHECK_EQUAL(convert<float>("", -1.0f), -1.0f);
+	BOOST_CHECK_EQUAL(convert<float>("+-5", -1.0f), -1.0f);
+	BOOST_CHECK_EQUAL(convert<int32_t>("-42", 0), -42);
+	BOOST_CHECK_EQUAL(convert<uint32_t>("-42", 7u), 7u);
+	BOOST_CHECK_EQUAL(convert<uint16_t>("70000", 7), 7);
+	BOOST_CHECK(!convertOptional<double>("1.5x"));
+}
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "ExtractPalette.h"
+#include "ImagePalette.h"
+#include "ColorList.h"
+#include "ColorObject.h"
+#include "GlobalState.h"
+#include "ImportExport.h"
+#include "Names.h"
+#include "ToolColorNaming.h"
+#include "math/OctreeColorQuantization.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+namespace {
+struct NameAssigner: public ToolColorNameAssigner {
+	NameAssigner(GlobalState &gs):
+		ToolColorNameAssigner(gs) {
+		m_index = 0;
+	}
+	void assign(ColorObject &colorObject, std::string_view fileName, const int index) {
+		m_fileName = fileName;
+		m_index = index;
+		ToolColorNameAssigner::assign(colorObject);
+	}
+	virtual std::string getToolSpecificName(const ColorObject &colorObject) override {
+		m_stream.str("");
+		m_stream << m_fileName << " #" << m_index;
+		return m_stream.str();
+	}
+protected:
+	std::stringstream m_stream;
+	std::string_view m_fileName;
+	int m_index;
+};
+struct Job {
+	std::string name;
+	std::unique_ptr<math::OctreeColorQuantization> octree;
+};
+}
+int tools_extract_palette(const std::vector<std::string> &filenames, uint32_t numberOfColors, const std::string &outputFilename, size_t maxPixels) {
+	auto fileType = ImportExport::getFileType(outputFilename.c_str());
+	if (fileType != FileType::gpa && fileType != FileType::gpl && fileType != FileType::css) {
+		std::cerr << "unsupported output file type: " << outputFilename << '\n';
+		return 1;
+	}
+	if (numberOfColors < 1 || numberOfColors > 1000) {
+		std::cerr << "number of colors must be between 1 and 1000\n";
+		return 1;
+	}
+	Color::initialize();
+	GlobalState gs;
+	gs.loadSettings();
+	gs.names().load();
+	std::vector<Job> jobs(filenames.size());
+	// with multiple images each image is processed by a single thread, a single image uses all threads by itself
+	size_t threadCount = std::min<size_t>(filenames.size(), std::max(1u, std::thread::hardware_concurrency()));
+	size_t imageThreads = threadCount > 1 ? 1 : 0;
+	std::atomic<size_t> nextJob(0);
+	std::atomic<bool> failed(false);
+	std::mutex outputMutex;
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; ++i) {
+		threads.emplace_back([&, imageThreads]() {
+			for (size_t index = nextJob++; index < jobs.size(); index = nextJob++) {
+				auto &filename = filenames[index];
+				auto startTime = std::chrono::steady_clock::now();
+				ImagePalette imagePalette(maxPixels, imageThreads);
+				auto octree = std::make_unique<math::OctreeColorQuantization>();
+				if (!imagePalette.load(filename, *octree)) {
+					failed = true;
+					std::scoped_lock<std::mutex> lock(outputMutex);
+					std::cerr << filename << ": " << imagePalette.error() << '\n';
+					continue;
+				}
+				octree->reduce(1000);
+				octree->reduce(numberOfColors);
+				std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - startTime;
+				jobs[index].name = std::filesystem::path(filename).filename().string();
+				jobs[index].octree = std::move(octree);
+				std::scoped_lock<std::mutex> lock(outputMutex);
+				if (imagePalette.scaled())
+					std::cout << filename << ": scaled down from " << imagePalette.originalWidth() << "x" << imagePalette.originalHeight() << " to " << gdk_pixbuf_get_width(imagePalette.pixbuf()) << "x" << gdk_pixbuf_get_height(imagePalette.pixbuf()) << " pixels\n";
+				std::cout << filename << ": " << jobs[index].octree->size() << " colors, " << duration.count() << " ms\n";
+			}
+		});
+	}
+	for (auto &thread: threads)
+		thread.join();
+	auto colorList = ColorList::newList();
+	NameAssigner nameAssigner(gs);
+	for (auto &job: jobs) {
+		if (!job.octree)
+			continue;
+		int index = 0;
+		job.octree->visit([&](const float sum[3], size_t pixels) {
+			Color color(sum[0] / pixels, sum[1] / pixels, sum[2] / pixels, 1.0f);
+			color.nonLinearRgbInplace();
+			ColorObject colorObject(color);
+			nameAssigner.assign(colorObject, job.name, index);
+			colorList->add(colorObject);
+			index++;
+		});
+	}
+	ImportExport importExport(*colorList, outputFilename.c_str(), gs);
+	if (!importExport.exportType(fileType)) {
+		std::cerr << outputFilename << ": could not write palette file\n";
+		return 1;
+	}
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ImagePalette.h"
+#include "Color.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+namespace {
+const size_t readChunkSize = 64 * 1024;
+// Pixel count below which starting worker threads costs more than it saves.
+const size_t minParallelPixels = 1 << 16;
+// Strips of image rows are queued as soon as all their rows are available and taken by workers. With a single worker strips are processed on the calling
+// thread. When rows are provided while the image is still being decoded, strips are copied out of the image, so workers never read rows the decoder may
+// still be writing.
+struct StripPool {
+	StripPool(GdkPixbuf *pixbuf, size_t threadCount, math::QuantizationEngine engine, bool copyRows):
+		m_pixbuf(pixbuf),
+		m_engine(engine),
+		m_width(gdk_pixbuf_get_width(pixbuf)),
+		m_height(gdk_pixbuf_get_height(pixbuf)),
+		m_channels(gdk_pixbuf_get_n_channels(pixbuf)),
+		m_stride(gdk_pixbuf_get_rowstride(pixbuf)),
+		m_imageData(gdk_pixbuf_get_pixels(pixbuf)),
+		m_queuedRows(0),
+		m_maxQueuedStrips(threadCount * 2),
+		m_copyRows(copyRows),
+		m_finished(false),
+		m_abandoned(false) {
+		m_octrees.resize(std::max<size_t>(threadCount, 1));
+		for (auto &octree: m_octrees)
+			octree = std::make_unique<math::OctreeColorQuantization>();
+		if (threadCount <= 1)
+			return;
+		m_threads.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i) {
+			m_threads.emplace_back([this, i]() {
+				work(*m_octrees[i]);
+			});
+		}
+	}
+	~StripPool() {
+		abandon();
+	}
+	GdkPixbuf *pixbuf() const {
+		return m_pixbuf;
+	}
+	int width() const {
+		return m_width;
+	}
+	// Mark rows from the first image row up to the given row as final.
+	void provide(int rows) {
+		rows = std::min(rows, m_height);
+		for (;;) {
+			int from = m_queuedRows, to = std::min(from + ImagePalette::stripRows, m_height);
+			if (from >= m_height || to > rows)
+				return;
+			m_queuedRows = to;
+			if (m_threads.empty()) {
+				addRows(*m_octrees[0], m_imageData + static_cast<size_t>(m_stride) * from, m_stride, to - from);
+				continue;
+			}
+			Strip strip { from, to, {} };
+			if (m_copyRows) {
+				// copied strips are waiting for workers, so the number of queued strips is limited to keep memory use bounded
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_condition.wait(lock, [this]() {
+						return m_abandoned || m_strips.size() < m_maxQueuedStrips;
+					});
+					if (m_abandoned)
+						return;
+				}
+				strip.pixels.assign(m_imageData + static_cast<size_t>(m_stride) * from, m_imageData + static_cast<size_t>(m_stride) * (to - 1) + static_cast<size_t>(m_width) * m_channels);
+			}
+			{
+				std::scoped_lock<std::mutex> lock(m_mutex);
+				m_strips.push_back(std::move(strip));
+			}
+			m_condition.notify_all();
+		}
+	}
+	// Process remaining rows and add pixels collected by all workers to octree.
+	void finish(math::OctreeColorQuantization &octree) {
+		// decoding is finished, so remaining rows can be read from the image
+		m_copyRows = false;
+		provide(m_height);
+		{
+			std::scoped_lock<std::mutex> lock(m_mutex);
+			m_finished = true;
+		}
+		m_condition.notify_all();
+		for (auto &thread: m_threads)
+			thread.join();
+		m_threads.clear();
+		// pairwise reduction: each round halves the number of octrees, merges within a round run in parallel
+		size_t count = m_octrees.size();
+		std::vector<std::thread> threads;
+		for (size_t step = 1; step < count; step *= 2) {
+			threads.clear();
+			for (size_t i = 0; i + step < count; i += step * 2) {
+				threads.emplace_back([this, i, step]() {
+					m_octrees[i]->merge(*m_octrees[i + step]);
+					m_octrees[i + step].reset();
+				});
+			}
+			for (auto &thread: threads)
+				thread.join();
+		}
+		octree.merge(*m_octrees[0]);
+		m_octrees.clear();
+	}
+	// Stop workers and drop collected pixels.
+	void abandon() {
+		{
+			std::scoped_lock<std::mutex> lock(m_mutex);
+			m_abandoned = true;
+			m_strips.clear();
+		}
+		m_condition.notify_all();
+		for (auto &thread: m_threads)
+			thread.join();
+		m_threads.clear();
+		m_octrees.clear();
+	}
+private:
+	struct Strip {
+		int from, to;
+		// copied rows, empty when rows are read from the image
+		std::vector<guchar> pixels;
+	};
+	GdkPixbuf *m_pixbuf;
+	math::QuantizationEngine m_engine;
+	int m_width, m_height, m_channels, m_stride;
+	const guchar *m_imageData;
+	int m_queuedRows;
+	size_t m_maxQueuedStrips;
+	bool m_copyRows, m_finished, m_abandoned;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<Strip> m_strips;
+	std::vector<std::unique_ptr<math::OctreeColorQuantization>> m_octrees;
+	std::vector<std::thread> m_threads;
+	void work(math::OctreeColorQuantization &octree) {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (;;) {
+			m_condition.wait(lock, [this]() {
+				return m_abandoned || m_finished || !m_strips.empty();
+			});
+			if (m_abandoned || m_strips.empty())
+				return;
+			Strip strip = std::move(m_strips.front());
+			m_strips.pop_front();
+			lock.unlock();
+			m_condition.notify_all();
+			if (strip.pixels.empty())
+				addRows(octree, m_imageData + static_cast<size_t>(m_stride) * strip.from, m_stride, strip.to - strip.from);
+			else
+				addRows(octree, strip.pixels.data(), m_stride, strip.to - strip.from);
+			lock.lock();
+		}
+	}
+	void addRows(math::OctreeColorQuantization &octree, const guchar *data, int stride, int rows) const {
+		Color color;
+		color.alpha = 1.0f;
+		for (int y = 0; y < rows; y++) {
+			const guchar *dataPointer = data + static_cast<size_t>(stride) * y;
+			for (int x = 0; x < m_width; x++) {
+				math::OctreeColorQuantization::Position position;
+				if (m_channels == 1) {
+					color.rgb.red = color.rgb.green = color.rgb.blue = Color::linearRgbChannel(dataPointer[0]);
+					position = { dataPointer[0], dataPointer[0], dataPointer[0] };
+				} else {
+					color.rgb.red = Color::linearRgbChannel(dataPointer[0]);
+					color.rgb.green = Color::linearRgbChannel(dataPointer[1]);
+					color.rgb.blue = Color::linearRgbChannel(dataPointer[2]);
+					position = { dataPointer[0], dataPointer[1], dataPointer[2] };
+				}
+				if (m_engine == math::QuantizationEngine::oklab)
+					position = math::oklabPosition(color);
+				octree.add(color, position);
+				dataPointer += m_channels;
+			}
+		}
+	}
+};
+size_t workerCount(size_t threads, int width, int height) {
+	size_t strips = static_cast<size_t>((height + ImagePalette::stripRows - 1) / ImagePalette::stripRows);
+	size_t threadCount = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+	if (static_cast<size_t>(width) * static_cast<size_t>(height) < minParallelPixels)
+		threadCount = 1;
+	return std::max<size_t>(1, std::min(threadCount, strips));
+}
+struct LoadState {
+	size_t threads;
+	math::QuantizationEngine engine;
+	std::unique_ptr<StripPool> pool;
+	int updatedRows;
+	bool multiplePasses;
+};
+void onAreaPrepared(GdkPixbufLoader *loader, LoadState *state) {
+	if (state->pool)
+		return;
+	GdkPixbuf *pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+	if (!pixbuf)
+		return;
+	state->pool = std::make_unique<StripPool>(pixbuf, workerCount(state->threads, gdk_pixbuf_get_width(pixbuf), gdk_pixbuf_get_height(pixbuf)), state->engine, true);
+}
+void onAreaUpdated(GdkPixbufLoader *, int x, int y, int width, int height, LoadState *state) {
+	if (!state->pool || state->multiplePasses)
+		return;
+	if (y < state->updatedRows) {
+		// rows which were already reported are changed by a later decoding pass, so none of the reported rows can be trusted until decoding finishes
+		state->multiplePasses = true;
+		state->pool->abandon();
+		return;
+	}
+	// rows updated only partially are complete only when a following update starts below them
+	state->updatedRows = x == 0 && width == state->pool->width() ? y + height : y;
+	state->pool->provide(state->updatedRows);
+}
+}
+ImagePalette::ImagePalette(size_t maxPixels, size_t threads):
+	m_maxPixels(maxPixels),
+	m_threads(threads),
+	m_pixbuf(nullptr),
+	m_originalWidth(0),
+	m_originalHeight(0) {
+}
+ImagePalette::~ImagePalette() {
+	if (m_pixbuf)
+		g_object_unref(m_pixbuf);
+}
+void ImagePalette::onSizePrepared(GdkPixbufLoader *loader, int width, int height, ImagePalette *imagePalette) {
+	imagePalette->m_originalWidth = width;
+	imagePalette->m_originalHeight = height;
+	size_t pixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+	if (imagePalette->m_maxPixels == 0 || pixels <= imagePalette->m_maxPixels)
+		return;
+	double scale = std::sqrt(static_cast<double>(imagePalette->m_maxPixels) / static_cast<double>(pixels));
+	gdk_pixbuf_loader_set_size(loader, std::max(1, static_cast<int>(width * scale)), std::max(1, static_cast<int>(height * scale)));
+}
+bool ImagePalette::load(const std::string &filename, math::OctreeColorQuantization &octree, math::QuantizationEngine engine) {
+	if (m_pixbuf) {
+		g_object_unref(m_pixbuf);
+		m_pixbuf = nullptr;
+	}
+	m_originalWidth = m_originalHeight = 0;
+	m_error.clear();
+	std::ifstream file(filename, std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		m_error = "could not open file \"" + filename + "\"";
+		return false;
+	}
+	LoadState state { m_threads, engine, nullptr, 0, false };
+	GdkPixbufLoader *loader = gdk_pixbuf_loader_new();
+	g_signal_connect(G_OBJECT(loader), "size-prepared", G_CALLBACK(onSizePrepared), this);
+	g_signal_connect(G_OBJECT(loader), "area-prepared", G_CALLBACK(onAreaPrepared), &state);
+	g_signal_connect(G_OBJECT(loader), "area-updated", G_CALLBACK(onAreaUpdated), &state);
+	std::vector<char> buffer(readChunkSize);
+	GError *error = nullptr;
+	bool success = true;
+	while (success && file) {
+		file.read(buffer.data(), buffer.size());
+		auto count = file.gcount();
+		if (count <= 0)
+			break;
+		success = gdk_pixbuf_loader_write(loader, reinterpret_cast<const guchar *>(buffer.data()), static_cast<gsize>(count), &error);
+	}
+	if (success && file.bad()) {
+		success = false;
+		m_error = "could not read file \"" + filename + "\"";
+	}
+	if (!gdk_pixbuf_loader_close(loader, success ? &error : nullptr))
+		success = false;
+	if (success) {
+		m_pixbuf = gdk_pixbuf_loader_get_pixbuf(loader);
+		if (m_pixbuf)
+			g_object_ref(m_pixbuf);
+		else
+			success = false;
+	}
+	if (success) {
+		if (state.pool && !state.multiplePasses && state.pool->pixbuf() == m_pixbuf) {
+			state.pool->finish(octree);
+		} else {
+			state.pool.reset();
+			process(octree, engine);
+		}
+	}
+	state.pool.reset();
+	if (error) {
+		m_error = error->message;
+		g_error_free(error);
+	}
+	if (!success && m_error.empty())
+		m_error = "could not decode image \"" + filename + "\"";
+	g_object_unref(loader);
+	return success;
+}
+void ImagePalette::set(GdkPixbuf *pixbuf) {
+	if (pixbuf)
+		g_object_ref(pixbuf);
+	if (m_pixbuf)
+		g_object_unref(m_pixbuf);
+	m_pixbuf = pixbuf;
+	m_originalWidth = pixbuf ? gdk_pixbuf_get_width(pixbuf) : 0;
+	m_originalHeight = pixbuf ? gdk_pixbuf_get_height(pixbuf) : 0;
+	m_error.clear();
+}
+GdkPixbuf *ImagePalette::pixbuf() const {
+	return m_pixbuf;
+}
+bool ImagePalette::scaled() const {
+	return m_pixbuf && m_originalWidth > 0 && (gdk_pixbuf_get_width(m_pixbuf) != m_originalWidth || gdk_pixbuf_get_height(m_pixbuf) != m_originalHeight);
+}
+int ImagePalette::originalWidth() const {
+	return m_originalWidth;
+}
+int ImagePalette::originalHeight() const {
+	return m_originalHeight;
+}
+const std::string &ImagePalette::error() const {
+	return m_error;
+}
+void ImagePalette::process(math::OctreeColorQuantization &octree, math::QuantizationEngine engine) const {
+	if (!m_pixbuf)
+		return;
+	StripPool pool(m_pixbuf, workerCount(m_threads, gdk_pixbuf_get_width(m_pixbuf), gdk_pixbuf_get_height(m_pixbuf)), engine, false);
+	pool.finish(octree);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2009-2025, Albertas Vyšniauskas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the software author nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+#include "math/OctreeColorQuantization.h"
+#include "math/PaletteQuantization.h"
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <cstddef>
+#include <string>
+/** \struct ImagePalette
+ * \brief Incremental image decoding and parallel accumulation of image pixels into color quantization octree.
+ */
+struct ImagePalette {
+	/**
+	 * Maximum number of decoded pixels used when image size is limited. Larger images are scaled down to this size, see load().
+	 */
+	static constexpr size_t limitedMaxPixels = 16 * 1024 * 1024;
+	/**
+	 * Number of image rows processed by a worker at once.
+	 */
+	static constexpr int stripRows = 32;
+	/**
+	 * Construct image palette.
+	 * @param[in] maxPixels Maximum number of decoded pixels. Zero decodes images at full size.
+	 * @param[in] threads Number of worker threads. Zero selects one worker per processor core.
+	 */
+	ImagePalette(size_t maxPixels = 0, size_t threads = 0);
+	ImagePalette(const ImagePalette &) = delete;
+	~ImagePalette();
+	ImagePalette &operator=(const ImagePalette &) = delete;
+	/**
+	 * Decode image file and add its pixels to octree while it is being decoded.
+	 * File is fed to incremental image loader in fixed size chunks. Rows reported by the loader are copied in strips and taken by a pool of workers, so workers never read
+	 * rows the loader is still writing. Images decoded in multiple passes (progressive or interlaced images) are detected when the loader updates already reported
+	 * rows, and are added to octree after decoding finishes.
+	 *
+	 * When maximum number of pixels is set, larger images are scaled down by the loader, so palette is extracted from the scaled image and scaled() returns true.
+	 * Loaders supporting scaled decoding (JPEG) never hold full resolution image, other loaders (PNG, TIFF) decode full resolution image before scaling it.
+	 * @param[in] filename Image file name.
+	 * @param[out] octree Octree receiving linear RGB image pixels. Octree is not changed on failure.
+	 * @param[in] engine Color space used for octree positions.
+	 * @return True on success. Error message is available from error() on failure.
+	 */
+	bool load(const std::string &filename, math::OctreeColorQuantization &octree, math::QuantizationEngine engine = math::QuantizationEngine::rgb);
+	/**
+	 * Use already decoded image.
+	 * @param[in] pixbuf Image. Reference is added, caller keeps its own reference.
+	 */
+	void set(GdkPixbuf *pixbuf);
+	/**
+	 * Get decoded image.
+	 * @return Decoded image or nullptr if no image is loaded.
+	 */
+	GdkPixbuf *pixbuf() const;
+	/**
+	 * Check if loaded image was scaled down because it had more than maximum number of pixels.
+	 * @return True if decoded image is smaller than the image file.
+	 */
+	bool scaled() const;
+	/**
+	 * Get image size before scaling.
+	 * @return Image width.
+	 */
+	int originalWidth() const;
+	/**
+	 * Get image size before scaling.
+	 * @return Image height.
+	 */
+	int originalHeight() const;
+	/**
+	 * Get last load error message.
+	 * @return Error message.
+	 */
+	const std::string &error() const;
+	/**
+	 * Add all pixels of decoded image to octree.
+	 * Image rows are split into strips which are taken by a pool of workers. Each worker fills its own octree without locking and worker octrees are merged pairwise in parallel before final result is added to the output octree.
+	 * @param[out] octree Octree receiving linear RGB image pixels.
+	 * @param[in] engine Color space used for octree positions.
+	 */
+	void process(math::OctreeColorQuantization &octree, math::QuantizationEngine engine = math::QuantizationEngine::rgb) const;
+private:
+	size_t m_maxPixels, m_threads;
+	GdkPixbuf *m_pixbuf;
+	int m_originalWidth, m_originalHeight;
+	std::string m_error;
+	static void onSizePrepared(GdkPixbufLoader *loader, int width, int height, ImagePalette *imagePalette);
+};
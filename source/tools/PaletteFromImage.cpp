@@ -26,13 +26,15 @@
 #include "I18N.h"
 #include "dynv/Map.h"
 #include "math/OctreeColorQuantization.h"
+#include "math/PaletteQuantization.h"
 #include "common/Guard.h"
+#include "common/Format.h"
 #include "gtk/ImageView.h"
+#include "ImagePalette.h"
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
-#include <thread>
-#include <mutex>
 namespace {
 struct NameAssigner: public ToolColorNameAssigner {
 	NameAssigner(GlobalState &gs):
@@ -58,11 +60,15 @@ enum struct Type {
 	image,
 	screenshot,
 };
+const size_t kMeansIterations = 20;
 struct PaletteFromImageArgs {
 	GtkWindow *parent;
-	GtkWidget *dialog, *fileBrowser, *rangeColors, *previewExpander, *imageView, *screenshotButton;
+	GtkWidget *dialog, *fileBrowser, *rangeColors, *engineCombo, *kMeansToggle, *limitSizeToggle, *previewExpander, *imageView, *scaleLabel, *screenshotButton;
 	std::string filename, name;
 	uint32_t numberOfColors;
+	math::QuantizationEngine engine;
+	bool kMeans, limitSize;
+	std::unique_ptr<ImagePalette> imagePalette;
 	math::OctreeColorQuantization octree;
 	common::Ref<ColorList> previewColorList;
 	dynv::Ref options;
@@ -75,7 +81,7 @@ struct PaletteFromImageArgs {
 		gtk_window_set_default_size(GTK_WINDOW(dialog), options->getInt32("window.width", -1), options->getInt32("window.height", -1));
 		gtk_dialog_set_alternative_button_order(GTK_DIALOG(dialog), GTK_RESPONSE_APPLY, GTK_RESPONSE_CLOSE, -1);
 
-		Grid grid(2, 5);
+		Grid grid(2, 9);
 		grid.addLabel(_("Image:"));
 		fileBrowser = grid.add(gtk_file_chooser_button_new(_("Image file"), GTK_FILE_CHOOSER_ACTION_OPEN), true);
 		gtk_file_chooser_set_current_folder(GTK_FILE_CHOOSER(fileBrowser), options->getString("current_folder", "").c_str());
@@ -123,10 +129,22 @@ struct PaletteFromImageArgs {
 		g_signal_connect(G_OBJECT(screenshotButton), "clicked", G_CALLBACK(onScreenshot), this);
 		grid.add(imageView = gtk_image_view_new(), true, 2);
 		gtk_widget_set_size_request(GTK_WIDGET(imageView), 320, 240);
+		scaleLabel = grid.add(gtk_label_aligned_new("", 0, 0.5f, 0, 0), true, 2);
 		grid.addLabel(_("Colors:"));
 		rangeColors = grid.add(gtk_spin_button_new_with_range(1, 1000, 1), true);
 		gtk_spin_button_set_value(GTK_SPIN_BUTTON(rangeColors), options->getInt32("colors", 3));
 		g_signal_connect(G_OBJECT(rangeColors), "value-changed", G_CALLBACK(onUpdate), this);
+		grid.addLabel(_("Engine:"));
+		engineCombo = grid.add(gtk_combo_box_text_new(), true);
+		gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(engineCombo), _("RGB octree"));
+		gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(engineCombo), _("Oklab octree"));
+		gtk_combo_box_set_active(GTK_COMBO_BOX(engineCombo), options->getInt32("engine", 0) == 1 ? 1 : 0);
+		g_signal_connect(G_OBJECT(engineCombo), "changed", G_CALLBACK(onEngineChange), this);
+		grid.nextColumn().add(kMeansToggle = gtk_check_button_new_with_mnemonic(_("_Refine colors using k-means clustering")), true);
+		gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(kMeansToggle), options->getBool("k_means", false));
+		g_signal_connect(G_OBJECT(kMeansToggle), "toggled", G_CALLBACK(onUpdate), this);
+		grid.nextColumn().add(limitSizeToggle = gtk_check_button_new_with_mnemonic(_("_Scale down images larger than 16 megapixels when loading")), true);
+		gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(limitSizeToggle), options->getBool("limit_size", false));
 		previewExpander = grid.add(palette_list_preview_new(gs, true, options->getBool("show_preview", true), previewColorList), true, 2, true);
 		gtk_widget_show_all(grid);
 		setDialogContent(dialog, grid);
@@ -134,11 +152,9 @@ struct PaletteFromImageArgs {
 		g_signal_connect(G_OBJECT(dialog), "response", G_CALLBACK(onResponse), this);
 		gtk_widget_show(dialog);
 	}
-	inline uint8_t toUint8(float value) {
-		return static_cast<uint8_t>(std::max(std::min(static_cast<int>(value * 256), 255), 0));
-	}
 	void processImage(Type type) {
-		GdkPixbuf *pixbuf = nullptr;
+		auto imagePalette = std::make_unique<ImagePalette>(limitSize ? ImagePalette::limitedMaxPixels : 0);
+		octree.clear();
 		if (type == Type::screenshot) {
 			name = _("screenshot");
 			GdkScreen *screen;
@@ -147,7 +163,12 @@ struct PaletteFromImageArgs {
 			gdk_display_get_pointer(gdk_display_get_default(), &screen, &x, &y, &state);
 			GdkRectangle monitorGeometry;
 			gdk_screen_get_monitor_geometry(screen, gdk_screen_get_monitor_at_point(screen, x, y), &monitorGeometry);
-			pixbuf = gdk_pixbuf_get_from_window(gdk_screen_get_root_window(screen), monitorGeometry.x, monitorGeometry.y, monitorGeometry.width, monitorGeometry.height);
+			GdkPixbuf *pixbuf = gdk_pixbuf_get_from_window(gdk_screen_get_root_window(screen), monitorGeometry.x, monitorGeometry.y, monitorGeometry.width, monitorGeometry.height);
+			if (!pixbuf)
+				return;
+			imagePalette->set(pixbuf);
+			g_object_unref(pixbuf);
+			imagePalette->process(octree, engine);
 		} else {
 			if (gchar *newFilename = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(fileBrowser)); newFilename) {
 				filename = newFilename;
@@ -157,15 +178,13 @@ struct PaletteFromImageArgs {
 				filename.clear();
 				name.clear();
 			}
-			GError *error = nullptr;
-			pixbuf = gdk_pixbuf_new_from_file(filename.c_str(), &error);
-			if (error) {
-				std::cout << error->message << '\n';
-				g_error_free(error);
+			if (!imagePalette->load(filename, octree, engine)) {
+				std::cout << imagePalette->error() << '\n';
 				return;
 			}
 		}
-		octree.clear();
+		octree.reduce(1000);
+		GdkPixbuf *pixbuf = imagePalette->pixbuf();
 		int width = gdk_pixbuf_get_width(pixbuf);
 		int height = gdk_pixbuf_get_height(pixbuf);
 		if (width > 320 || height > 240) {
@@ -178,94 +197,42 @@ struct PaletteFromImageArgs {
 		} else {
 			gtk_image_view_set_image(GTK_IMAGE_VIEW(imageView), pixbuf);
 		}
-		int channels = gdk_pixbuf_get_n_channels(pixbuf);
-		int stride = gdk_pixbuf_get_rowstride(pixbuf);
-		guchar *imageData = gdk_pixbuf_get_pixels(pixbuf);
-		if (width * height < (1 << 16) || std::max(1u, std::thread::hardware_concurrency()) == 1) {
-			guchar *dataPointer = imageData;
-			Color color;
-			for (int y = 0; y < height; y++) {
-				dataPointer = imageData + stride * y;
-				for (int x = 0; x < width; x++) {
-					if (channels == 1) {
-						color.xyz.x = color.xyz.y = color.xyz.z = dataPointer[0] / 255.0f;
-					} else {
-						color.xyz.x = dataPointer[0] / 255.0f;
-						color.xyz.y = dataPointer[1] / 255.0f;
-						color.xyz.z = dataPointer[2] / 255.0f;
-					}
-					color.alpha = 1.0f;
-					color.linearRgbInplace();
-					std::array<uint8_t, 3> position = { dataPointer[0], dataPointer[1], dataPointer[2] };
-					octree.add(color, position);
-					dataPointer += channels;
-				}
-			}
-		} else {
-			size_t threadCount = std::min(8u, std::thread::hardware_concurrency());
-			std::mutex octreeMutex;
-			std::vector<std::thread> threads(threadCount);
-			size_t index = 0;
-			for (auto &thread: threads) {
-				thread = std::thread([this, &octreeMutex, index, threadCount, imageData, channels, width, height, stride]() {
-					math::OctreeColorQuantization threadOctree;
-					guchar *dataPointer = imageData + stride * index;
-					Color color;
-					for (int y = 0; y < height; y += threadCount) {
-						dataPointer = imageData + stride * y;
-						for (int x = 0; x < width; x++) {
-							if (channels == 1) {
-								color.xyz.x = color.xyz.y = color.xyz.z = dataPointer[0] / 255.0f;
-							} else {
-								color.xyz.x = dataPointer[0] / 255.0f;
-								color.xyz.y = dataPointer[1] / 255.0f;
-								color.xyz.z = dataPointer[2] / 255.0f;
-							}
-							color.alpha = 1.0f;
-							color.linearRgbInplace();
-							std::array<uint8_t, 3> position = { dataPointer[0], dataPointer[1], dataPointer[2] };
-							threadOctree.add(color, position);
-							dataPointer += channels;
-						}
-					}
-					threadOctree.reduce(1000);
-					std::scoped_lock<std::mutex> lock(octreeMutex);
-					threadOctree.visit([this](const float sum[3], size_t pixels) {
-						Color color(sum[0] / pixels, sum[1] / pixels, sum[2] / pixels, 1.0f);
-						Color nonLinearColor = color.nonLinearRgb();
-						std::array<uint8_t, 3> position = { toUint8(nonLinearColor.red), toUint8(nonLinearColor.green), toUint8(nonLinearColor.blue) };
-						octree.add(color, pixels, position);
-					});
-				});
-				++index;
-			}
-			for (auto &thread: threads) {
-				thread.join();
-			}
-		}
-		g_object_unref(pixbuf);
+		if (imagePalette->scaled())
+			gtk_label_set_text(GTK_LABEL(scaleLabel), common::format(_("Image was scaled down from {}×{} to {}×{} pixels"), imagePalette->originalWidth(), imagePalette->originalHeight(), width, height).c_str());
+		else
+			gtk_label_set_text(GTK_LABEL(scaleLabel), "");
+		this->imagePalette = std::move(imagePalette);
+	}
+	void quantize() {
+		octree.clear();
+		if (!imagePalette)
+			return;
+		imagePalette->process(octree, engine);
 		octree.reduce(1000);
 	}
 	void update(bool preview) {
 		int index = 0;
 		NameAssigner nameAssigner(gs);
 		ColorList &colorList = preview ? *previewColorList : gs.colorList();
-		math::OctreeColorQuantization reducedOctree(octree);
-		reducedOctree.reduce(numberOfColors);
+		auto palette = math::reducePalette(octree, numberOfColors, kMeans ? kMeansIterations : 0);
 		common::Guard colorListGuard = colorList.changeGuard();
-		reducedOctree.visit([&](const float sum[3], size_t pixels) {
-			Color color(sum[0] / pixels, sum[1] / pixels, sum[2] / pixels, 1.0f);
-			color.nonLinearRgbInplace();
-			ColorObject colorObject(color);
+		for (const auto &paletteColor: palette) {
+			ColorObject colorObject(paletteColor.color);
 			nameAssigner.assign(colorObject, name, index);
 			colorList.add(colorObject);
 			index++;
-		});
+		}
 	}
 	void getSettings(bool save) {
 		numberOfColors = static_cast<int>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(rangeColors)));
+		engine = gtk_combo_box_get_active(GTK_COMBO_BOX(engineCombo)) == 1 ? math::QuantizationEngine::oklab : math::QuantizationEngine::rgb;
+		kMeans = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(kMeansToggle));
+		limitSize = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(limitSizeToggle));
 		if (save) {
 			options->set("colors", static_cast<int32_t>(numberOfColors));
+			options->set("engine", static_cast<int32_t>(engine));
+			options->set<bool>("k_means", kMeans);
+			options->set<bool>("limit_size", limitSize);
 			gchar *currentFolder = gtk_file_chooser_get_current_folder(GTK_FILE_CHOOSER(fileBrowser));
 			if (currentFolder) {
 				options->set("current_folder", currentFolder);
@@ -288,6 +255,12 @@ struct PaletteFromImageArgs {
 		args->getSettings(false);
 		args->update(true);
 	}
+	static void onEngineChange(GtkWidget *, PaletteFromImageArgs *args) {
+		args->previewColorList->removeAll();
+		args->getSettings(false);
+		args->quantize();
+		args->update(true);
+	}
 	static void onImageSelect(GtkWidget *, PaletteFromImageArgs *args) {
 		args->previewColorList->removeAll();
 		args->getSettings(false);
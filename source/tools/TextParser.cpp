@@ -25,9 +25,8 @@
 #include "dynv/Map.h"
 #include "uiListPalette.h"
 #include "uiUtilities.h"
-#include "parser/TextFile.h"
+#include "parser/IncrementalParser.h"
 #include "common/Guard.h"
-#include <sstream>
 #include <vector>
 using namespace std::string_literals;
 
@@ -36,45 +35,6 @@ struct TextParserDialog: public ToolColorNameAssigner {
 	~TextParserDialog();
 	bool show();
 	virtual std::string getToolSpecificName(const ColorObject &colorObject) override;
-	struct TextParser: public text_file_parser::TextFile {
-		TextParser(const std::string &text):
-			m_text(text),
-			m_failed(false) {
-		}
-		virtual ~TextParser() {
-		}
-		virtual void outOfMemory() {
-			m_failed = true;
-		}
-		virtual void syntaxError(size_t, size_t, size_t, size_t) {
-			m_failed = true;
-		}
-		virtual size_t read(char *buffer, size_t length) {
-			m_text.read(buffer, length);
-			size_t bytes = m_text.gcount();
-			if (bytes > 0)
-				return bytes;
-			if (m_text.eof())
-				return 0;
-			if (!m_text.good()) {
-				m_failed = true;
-			}
-			return 0;
-		}
-		virtual void addColor(const Color &color) {
-			m_colors.push_back(color);
-		}
-		bool failed() const {
-			return m_failed;
-		}
-		const std::vector<Color> &colors() const {
-			return m_colors;
-		}
-	private:
-		std::stringstream m_text;
-		std::vector<Color> m_colors;
-		bool m_failed;
-	};
 private:
 	GtkWindow *m_parent;
 	GtkWidget *m_dialog, *m_textView;
@@ -83,6 +43,8 @@ private:
 	common::Ref<ColorList> m_previewColorList;
 	GlobalState *m_gs;
 	size_t m_index;
+	text_file_parser::IncrementalParser m_parser;
+	bool m_previewComplete;
 	dynv::Ref m_options;
 	bool isSingleLineCCommentsEnabled();
 	bool isMultiLineCCommentsEnabled();
@@ -102,7 +64,8 @@ private:
 	void saveSettings();
 	void preview();
 	void apply();
-	bool parse(ColorList &colorList);
+	bool parse(text_file_parser::IncrementalParser::Change &change);
+	void addPreviewColors(size_t first, size_t count);
 	static void onDestroy(GtkWidget *widget, TextParserDialog *dialog);
 	static void onResponse(GtkWidget *widget, gint response_id, TextParserDialog *dialog);
 	static void onChange(GtkWidget *widget, TextParserDialog *dialog);
@@ -110,7 +73,9 @@ private:
 TextParserDialog::TextParserDialog(GtkWindow *parent, GlobalState *gs):
 	ToolColorNameAssigner(*gs),
 	m_parent(parent),
-	m_gs(gs) {
+	m_gs(gs),
+	m_parser(4096, 0),
+	m_previewComplete(false) {
 	m_options = m_gs->settings().getOrCreateMap("gpick.tools.text_parser");
 	GtkWidget *dialog = m_dialog = gtk_dialog_new_with_buttons(_("Text parser"), m_parent, GtkDialogFlags(GTK_DIALOG_DESTROY_WITH_PARENT), GTK_STOCK_CLOSE, GTK_RESPONSE_CLOSE, GTK_STOCK_ADD, GTK_RESPONSE_APPLY, nullptr);
 	gtk_window_set_default_size(GTK_WINDOW(dialog), m_options->getInt32("window.width", -1), m_options->getInt32("window.height", -1));
@@ -177,7 +142,7 @@ bool TextParserDialog::show() {
 void TextParserDialog::onDestroy(GtkWidget *widget, TextParserDialog *dialog) {
 	delete dialog;
 }
-bool TextParserDialog::parse(ColorList &colorList) {
+bool TextParserDialog::parse(text_file_parser::IncrementalParser::Change &change) {
 	text_file_parser::Configuration configuration;
 	configuration.singleLineCComments = isSingleLineCCommentsEnabled();
 	configuration.multiLineCComments = isMultiLineCCommentsEnabled();
@@ -195,35 +160,66 @@ bool TextParserDialog::parse(ColorList &colorList) {
 	configuration.intValues = isIntValuesEnabled();
 	configuration.floatValues = isFloatValuesEnabled();
 	auto text = getTextViewText(m_textView);
-	TextParser textParser(text);
-	if (!textParser.parse(configuration)) {
+	if (!m_parser.parse(text, configuration, change)) {
 		return false;
 	}
-	if (textParser.failed()) {
+	if (m_parser.colors().size() == 0) {
 		return false;
 	}
-	if (textParser.colors().size() == 0) {
-		return false;
-	}
-	m_index = 0;
-	common::Guard colorListGuard = colorList.changeGuard();
-	for (auto color: textParser.colors()) {
-		ColorObject colorObject(color);
-		ToolColorNameAssigner::assign(colorObject);
-		colorList.add(colorObject);
-		m_index++;
-	}
 	return true;
 }
+void TextParserDialog::addPreviewColors(size_t first, size_t count) {
+	const auto &colors = m_parser.colors();
+	std::vector<ColorObject *> colorObjects;
+	colorObjects.reserve(count);
+	for (size_t i = first; i < first + count; i++) {
+		auto *colorObject = new ColorObject(colors[i]);
+		m_index = i;
+		ToolColorNameAssigner::assign(*colorObject);
+		colorObjects.push_back(colorObject);
+	}
+	m_previewColorList->insertRange(common::Span<ColorObject *const>(colorObjects.data(), colorObjects.size()), first, true);
+	for (auto *colorObject: colorObjects)
+		colorObject->release();
+}
 void TextParserDialog::onChange(GtkWidget *widget, TextParserDialog *dialog) {
 	dialog->preview();
 }
 void TextParserDialog::preview() {
-	m_previewColorList->removeAll();
-	parse(*m_previewColorList);
+	text_file_parser::IncrementalParser::Change change;
+	if (!parse(change)) {
+		m_previewColorList->removeAll();
+		m_previewComplete = false;
+		return;
+	}
+	common::Guard colorListGuard = m_previewColorList->changeGuard();
+	size_t colorCount = m_parser.colors().size();
+	if (!m_previewComplete) {
+		m_previewColorList->removeAll();
+		addPreviewColors(0, colorCount);
+		m_previewComplete = true;
+		return;
+	}
+	// only colors in the changed range are named. Tool specific names of colors after a size changing edit keep their old index in
+	// the preview, apply() names every added color again
+	m_previewColorList->removeRange(change.first, change.removed, true);
+	addPreviewColors(change.first, change.inserted);
 }
 void TextParserDialog::apply() {
-	parse(m_gs->colorList());
+	text_file_parser::IncrementalParser::Change change;
+	if (!parse(change))
+		return;
+	auto &colorList = m_gs->colorList();
+	common::Guard colorListGuard = colorList.changeGuard();
+	const auto &colors = m_parser.colors();
+	std::vector<ColorObject> colorObjects;
+	colorObjects.reserve(colors.size());
+	for (size_t i = 0; i < colors.size(); i++) {
+		colorObjects.emplace_back(colors[i]);
+		m_index = i;
+		ToolColorNameAssigner::assign(colorObjects.back());
+	}
+	colorList.addRange(common::Span<const ColorObject>(colorObjects.data(), colorObjects.size()));
 }
 std::string TextParserDialog::getToolSpecificName(const ColorObject &colorObject) {
 	return _("Parsed text color") + " #"s + std::to_string(m_index);
@@ -43,6 +43,7 @@ struct DialogOptionsArgs {
 	GtkWidget *save_restore_palette;
 	GtkWidget *always_use_floating_picker;
 	GtkWidget *hide_cursor;
+	GtkWidget *show_timings;
 	GtkWidget *add_on_release;
 	GtkWidget *add_to_palette;
 	GtkWidget *copy_to_clipboard;
@@ -108,6 +109,7 @@ static void calc( DialogOptionsArgs *args, bool preview, int limit)
 	options->set<int32_t>("picker.zoom_size", static_cast<int32_t>(gtk_spin_button_get_value(GTK_SPIN_BUTTON(args->zoom_size))));
 	options->set<bool>("picker.always_use_floating_picker", gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->always_use_floating_picker)));
 	options->set<bool>("picker.hide_cursor", gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->hide_cursor)));
+	options->set<bool>("picker.show_timings", gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->show_timings)));
 	options->set<bool>("picker.sampler.add_on_release", gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->add_on_release)));
 	options->set<bool>("picker.sampler.copy_on_release", gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->copy_on_release)));
 	options->set<bool>("picker.sampler.add_to_swatch_on_release", gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(args->add_to_swatch_on_release)));
@@ -345,6 +347,10 @@ void dialog_options_show(GtkWindow* parent, GlobalState* gs)
 	gtk_spin_button_set_value(GTK_SPIN_BUTTON(args->zoom_size), args->options->getInt32("picker.zoom_size", 150));
 	gtk_table_attach(GTK_TABLE(table), widget,1,3,table_y,table_y+1,GtkAttachOptions(GTK_FILL | GTK_EXPAND),GTK_FILL,5,5);
 	table_y++;
+	args->show_timings = widget = gtk_check_button_new_with_mnemonic(_("_Show update timings"));
+	gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(widget), args->options->getBool("picker.show_timings", false));
+	gtk_table_attach(GTK_TABLE(table), widget,0,3,table_y,table_y+1,GtkAttachOptions(GTK_FILL | GTK_EXPAND),GTK_FILL,3,3);
+	table_y++;
 
 	frame = gtk_frame_new(_("Picker"));
 	gtk_frame_set_shadow_type(GTK_FRAME(frame), GTK_SHADOW_NONE);
@@ -613,9 +613,18 @@ struct ListPaletteArgs : public IEditableColorsUI, public IContainerUI, public I
 	virtual void add(ColorList &colorList, ColorObject *colorObject) override {
 		palette_list_add_entry(treeview, colorObject, !colorList.blocked());
 	}
+	virtual void insert(ColorList &colorList, ColorObject *colorObject, size_t position) override {
+		palette_list_insert_entry(treeview, colorObject, position, !colorList.blocked());
+	}
+	virtual void insertRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects, size_t position) override {
+		palette_list_insert_entries(treeview, colorObjects.data(), colorObjects.size(), position, !colorList.blocked());
+	}
 	virtual void remove(ColorList &colorList, ColorObject *colorObject) override {
 		palette_list_remove_entry(treeview, colorObject, !colorList.blocked());
 	}
+	virtual void removeRange(ColorList &colorList, size_t first, size_t count) override {
+		palette_list_remove_entries(treeview, first, count, !colorList.blocked());
+	}
 	virtual void removeSelected(ColorList &colorList) override {
 		palette_list_remove_selected_entries(treeview, !colorList.blocked());
 	}
@@ -879,6 +888,86 @@ void palette_list_add_entry(GtkWidget* widget, ColorObject* colorObject, bool al
 		args->onChange();
 	}
 }
+void palette_list_insert_entry(GtkWidget *widget, ColorObject *colorObject, size_t position, bool allowUpdate) {
+	auto *args = reinterpret_cast<ListPaletteArgs *>(g_object_get_data(G_OBJECT(widget), "arguments"));
+	auto *store = GTK_LIST_STORE(gtk_tree_view_get_model(GTK_TREE_VIEW(widget)));
+	GtkTreeIter iter;
+	gtk_list_store_insert(store, &iter, static_cast<gint>(position));
+	set(store, &iter, colorObject, args);
+	if (allowUpdate) {
+		args->updateCounts();
+		args->onChange();
+	}
+}
+void palette_list_insert_entries(GtkWidget *widget, ColorObject *const *colorObjects, size_t count, size_t position, bool allowUpdate) {
+	auto *args = reinterpret_cast<ListPaletteArgs *>(g_object_get_data(G_OBJECT(widget), "arguments"));
+	auto *treeView = GTK_TREE_VIEW(widget);
+	auto *model = gtk_tree_view_get_model(treeView);
+	auto *store = GTK_LIST_STORE(model);
+	size_t rowCount = gtk_tree_model_iter_n_children(model, nullptr);
+	if (position > rowCount)
+		position = rowCount;
+	// View handles a signal for every inserted row, so with many rows the model is detached while rows are inserted
+	bool detach = count >= 256;
+	GList *selectedRows = nullptr;
+	GtkTreePath *visibleStart = nullptr, *visibleEnd = nullptr;
+	if (detach) {
+		selectedRows = gtk_tree_selection_get_selected_rows(gtk_tree_view_get_selection(treeView), nullptr);
+		if (!gtk_tree_view_get_visible_range(treeView, &visibleStart, &visibleEnd))
+			visibleStart = visibleEnd = nullptr;
+		g_object_ref(model);
+		gtk_tree_view_set_model(treeView, nullptr);
+	}
+	for (size_t i = 0; i < count; i++) {
+		GtkTreeIter iter;
+		gtk_list_store_insert(store, &iter, static_cast<gint>(position + i));
+		set(store, &iter, colorObjects[i], args);
+	}
+	if (detach) {
+		gtk_tree_view_set_model(treeView, model);
+		g_object_unref(model);
+		auto shift = [position, count](GtkTreePath *path) {
+			auto index = static_cast<size_t>(gtk_tree_path_get_indices(path)[0]);
+			if (index < position)
+				return path;
+			gtk_tree_path_free(path);
+			return gtk_tree_path_new_from_indices(static_cast<gint>(index + count), -1);
+		};
+		auto *selection = gtk_tree_view_get_selection(treeView);
+		for (GList *i = selectedRows; i; i = g_list_next(i)) {
+			i->data = shift(reinterpret_cast<GtkTreePath *>(i->data));
+			gtk_tree_selection_select_path(selection, reinterpret_cast<GtkTreePath *>(i->data));
+		}
+		g_list_foreach(selectedRows, (GFunc)gtk_tree_path_free, nullptr);
+		g_list_free(selectedRows);
+		if (visibleStart) {
+			visibleStart = shift(visibleStart);
+			gtk_tree_view_scroll_to_cell(treeView, visibleStart, nullptr, true, 0, 0);
+			gtk_tree_path_free(visibleStart);
+			gtk_tree_path_free(visibleEnd);
+		}
+	}
+	if (allowUpdate) {
+		args->updateCounts();
+		args->onChange();
+	}
+}
+void palette_list_remove_entries(GtkWidget *widget, size_t first, size_t count, bool allowUpdate) {
+	auto *args = reinterpret_cast<ListPaletteArgs *>(g_object_get_data(G_OBJECT(widget), "arguments"));
+	auto *model = gtk_tree_view_get_model(GTK_TREE_VIEW(widget));
+	GtkTreeIter iter;
+	gboolean valid = gtk_tree_model_iter_nth_child(model, &iter, nullptr, static_cast<gint>(first));
+	for (size_t i = 0; valid && i < count; i++) {
+		ColorObject *colorObject;
+		gtk_tree_model_get(model, &iter, 0, &colorObject, -1);
+		colorObject->release();
+		valid = gtk_list_store_remove(GTK_LIST_STORE(model), &iter);
+	}
+	if (allowUpdate) {
+		args->updateCounts();
+		args->onChange();
+	}
+}
 int palette_list_remove_entry(GtkWidget* widget, ColorObject* r_color_object, bool allowUpdate)
 {
 	ListPaletteArgs* args = (ListPaletteArgs*)g_object_get_data(G_OBJECT(widget), "arguments");
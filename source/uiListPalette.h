@@ -27,10 +27,22 @@ struct ColorList;
 GtkWidget* palette_list_new(GlobalState &gs, GtkWidget *countLabel);
 GtkWidget* palette_list_temporary_new(GlobalState &gs, GtkWidget* countLabel, ColorList &colorList);
 void palette_list_add_entry(GtkWidget* widget, ColorObject *color_object, bool allowUpdate);
+void palette_list_insert_entry(GtkWidget *widget, ColorObject *colorObject, size_t position, bool allowUpdate);
+/**
+ * Insert multiple colors into palette list.
+ * When many colors are inserted, rows are added while the model is detached from the view, selection and scroll position are kept.
+ * @param[in] widget Palette list widget.
+ * @param[in] colorObjects Inserted color objects.
+ * @param[in] count Number of inserted color objects.
+ * @param[in] position Position of the first inserted color, colors are appended if position is past the last row.
+ * @param[in] allowUpdate Update color counts and notify about palette change.
+ */
+void palette_list_insert_entries(GtkWidget *widget, ColorObject *const *colorObjects, size_t count, size_t position, bool allowUpdate);
 GtkWidget* palette_list_preview_new(GlobalState &gs, bool expander, bool expanded, common::Ref<ColorList> &outColorList);
 void palette_list_remove_all_entries(GtkWidget* widget, bool allowUpdate);
 void palette_list_remove_selected_entries(GtkWidget* widget, bool allowUpdate);
 int palette_list_remove_entry(GtkWidget* widget, ColorObject *color_object, bool allowUpdate);
+void palette_list_remove_entries(GtkWidget *widget, size_t first, size_t count, bool allowUpdate);
 int palette_list_get_selected_count(GtkWidget* widget);
 int palette_list_get_count(GtkWidget* widget);
 ColorObject *palette_list_get_first_selected(GtkWidget* widget);
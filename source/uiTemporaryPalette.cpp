@@ -100,9 +100,18 @@ struct TemporaryPalette: public IPalette {
 	virtual void add(ColorList &colorList, ColorObject *colorObject) override {
 		palette_list_add_entry(palette, colorObject, !colorList.blocked());
 	}
+	virtual void insert(ColorList &colorList, ColorObject *colorObject, size_t position) override {
+		palette_list_insert_entry(palette, colorObject, position, !colorList.blocked());
+	}
+	virtual void insertRange(ColorList &colorList, common::Span<ColorObject *const> colorObjects, size_t position) override {
+		palette_list_insert_entries(palette, colorObjects.data(), colorObjects.size(), position, !colorList.blocked());
+	}
 	virtual void remove(ColorList &colorList, ColorObject *colorObject) override {
 		palette_list_remove_entry(palette, colorObject, !colorList.blocked());
 	}
+	virtual void removeRange(ColorList &colorList, size_t first, size_t count) override {
+		palette_list_remove_entries(palette, first, count, !colorList.blocked());
+	}
 	virtual void removeSelected(ColorList &colorList) override {
 		palette_list_remove_selected_entries(palette, !colorList.blocked());
 	}